@@ -0,0 +1,22 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+namespace MeshCore::Bench {
+
+/**
+ * @brief Process-wide count of heap allocations and of the bytes requested
+ *
+ * With glibc, malloc, calloc and realloc are interposed, which covers Qt
+ * containers (allocated with malloc) as well as operator new. Elsewhere
+ * only operator new is counted, and allocationCountingComplete() says so.
+ */
+[[nodiscard]] quint64 allocationCount();
+// Bytes requested by those allocations, never decremented by frees
+[[nodiscard]] quint64 allocatedBytes();
+[[nodiscard]] bool allocationCountingComplete();
+
+} // namespace MeshCore::Bench
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,158 @@
+#include "BenchmarkSupport.h"
+#include "meshcore/utils/BufferWriter.h"
+#include <QStringList>
+
+namespace MeshCore::Bench {
+
+QByteArray randomBytes(QRandomGenerator &random, qsizetype size)
+{
+    QByteArray bytes(size, Qt::Uninitialized);
+    for (qsizetype i = 0; i < size; ++i) {
+        bytes[i] = static_cast<char>(random.bounded(256));
+    }
+    return bytes;
+}
+
+QByteArray rawPacket(PayloadType type, RouteType route, QByteArrayView path, QByteArrayView payload)
+{
+    BufferWriter writer(2 + path.size() + payload.size());
+    writer.writeByte(quint8(route) | quint8(quint8(type) << PacketHeader::TypeShift));
+    writer.writeByte(quint8(path.size()));
+    writer.writeBytes(path.data(), path.size());
+    writer.writeBytes(payload.data(), payload.size());
+    return writer.take();
+}
+
+QByteArray advertPacket(quint32 seed, QByteArrayView path)
+{
+    QRandomGenerator random(seed);
+    BufferWriter payload;
+    payload.writeBytes(randomBytes(random, 32));   // public key
+    payload.writeUInt32LE(1700000000 + seed);      // timestamp
+    payload.writeBytes(randomBytes(random, 64));   // signature
+    payload.writeByte(quint8(AdvertType::Chat) | AdvertFlags::LatLonMask | AdvertFlags::NameMask);
+    payload.writeInt32LE(qint32(random.bounded(-90000000, 90000000)));
+    payload.writeInt32LE(qint32(random.bounded(-180000000, 180000000)));
+    payload.writeString(QStringLiteral("Node %1").arg(seed));
+    return rawPacket(PayloadType::Advert, RouteType::Flood, path, payload.view());
+}
+
+QByteArray groupTextPacket(quint32 seed, QByteArrayView path)
+{
+    QRandomGenerator random(seed);
+    BufferWriter payload;
+    payload.writeByte(quint8(seed & 0x0F));                          // channel hash
+    payload.writeBytes(randomBytes(random, 2 + 16 * (1 + seed % 4))); // MAC and ciphertext
+    return rawPacket(PayloadType::GrpTxt, RouteType::Flood, path, payload.view());
+}
+
+QByteArray logRxDataFrame(qint8 snrQuarters, qint8 rssi, QByteArrayView packet)
+{
+    BufferWriter writer(3 + packet.size());
+    writer.writeByte(quint8(PushCode::LogRxData));
+    writer.writeInt8(snrQuarters);
+    writer.writeInt8(rssi);
+    writer.writeBytes(packet.data(), packet.size());
+    return writer.take();
+}
+
+QByteArray contactFrame(quint8 code, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    BufferWriter writer;
+    writer.writeByte(code);
+    writer.writeBytes(randomBytes(random, 32));           // public key
+    writer.writeByte(quint8(AdvertType::Chat));
+    writer.writeByte(0);                                   // flags
+    writer.writeInt8(3);                                   // out path length
+    QByteArray outPath = randomBytes(random, 3);
+    writer.writeBytes(outPath);
+    writer.writeZeros(64 - outPath.size());
+    writer.writeCString(QStringLiteral("Contact %1").arg(seed), 32);
+    writer.writeUInt32LE(1700000000 + seed);               // last advert
+    writer.writeInt32LE(qint32(random.bounded(-90000000, 90000000)));
+    writer.writeInt32LE(qint32(random.bounded(-180000000, 180000000)));
+    writer.writeUInt32LE(1700000000 + seed);               // last modified
+    return writer.take();
+}
+
+QByteArray sentFrame()
+{
+    BufferWriter writer;
+    writer.writeByte(quint8(ResponseCode::Sent));
+    writer.writeInt8(1);            // flood
+    writer.writeUInt32LE(0x12345678);
+    writer.writeUInt32LE(5000);
+    return writer.take();
+}
+
+QByteArray msgWaitingFrame()
+{
+    return QByteArray(1, char(PushCode::MsgWaiting));
+}
+
+QList<QByteArray> rxLogHeavyFrames(qsizetype count)
+{
+    QRandomGenerator random(42);
+    QList<QByteArray> frames;
+    frames.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        quint32 pick = random.bounded(100);
+        QByteArray path = randomBytes(random, random.bounded(8));
+        if (pick < 80) {
+            QByteArray packet = pick < 20 ? advertPacket(quint32(i), path) : groupTextPacket(quint32(i), path);
+            frames.append(logRxDataFrame(qint8(random.bounded(-40, 40)), qint8(-random.bounded(40, 120)), packet));
+        } else if (pick < 90) {
+            frames.append(contactFrame(quint8(PushCode::NewAdvert), quint32(i)));
+        } else if (pick < 95) {
+            frames.append(sentFrame());
+        } else {
+            frames.append(msgWaitingFrame());
+        }
+    }
+    return frames;
+}
+
+QString messageText(quint32 seed)
+{
+    static const QStringList words = QStringLiteral(
+        "the a on at in to of and is are be will meet see you me we they it "
+        "repeater relay node mesh channel signal battery solar antenna tower "
+        "hill ridge valley trail road camp station base north south east west "
+        "morning evening tonight tomorrow today now later soon weather rain "
+        "wind snow clear storm check ok yes no thanks copy roger heading back "
+        "arrived leaving waiting need help water food fuel radio range test "
+        "packet hops path direct flood strong weak noisy good bad reboot update "
+        "firmware power low full charging offline online lost found map gps").split(u' ');
+
+    QRandomGenerator random(seed);
+    const int count = random.bounded(3, 21);
+    QString text;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) {
+            text += u' ';
+        }
+        text += words.at(random.bounded(int(words.size())));
+    }
+    return text;
+}
+
+QList<Message> messageHistory(qsizetype first, qsizetype count)
+{
+    QList<Message> messages;
+    messages.reserve(count);
+    for (qsizetype i = first; i < first + count; ++i) {
+        const quint32 seed = quint32(i);
+        const quint32 timestamp = 1700000000 + seed * 7;
+        const quint8 pathLen = quint8(i % 5);
+        if (i % 4 == 3) {
+            messages.append(ChannelMessage(qint8(i % 8), pathLen, TxtType::Plain, timestamp, messageText(seed)));
+        } else {
+            const QByteArray prefix(6, char(0x40 + i % 64));
+            messages.append(ContactMessage(prefix, pathLen, TxtType::Plain, timestamp, messageText(seed)));
+        }
+    }
+    return messages;
+}
+
+} // namespace MeshCore::Bench
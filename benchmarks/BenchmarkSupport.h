@@ -0,0 +1,70 @@
+#ifndef BENCHMARKSUPPORT_H
+#define BENCHMARKSUPPORT_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QRandomGenerator>
+#include <QString>
+#include <variant>
+
+#include "meshcore/MeshCoreConstants.h"
+#include "meshcore/connection/MeshCoreConnection.h"
+#include "meshcore/types/ChannelMessage.h"
+#include "meshcore/types/ContactMessage.h"
+
+namespace MeshCore::Bench {
+
+// Deterministic pseudo-random bytes
+[[nodiscard]] QByteArray randomBytes(QRandomGenerator &random, qsizetype size);
+
+// On-air packet: header, path length, path, payload
+[[nodiscard]] QByteArray rawPacket(PayloadType type, RouteType route, QByteArrayView path, QByteArrayView payload);
+// Flooded advert with a location and a name, signed by a key derived from seed
+[[nodiscard]] QByteArray advertPacket(quint32 seed, QByteArrayView path);
+// Flooded group text with a payload derived from seed
+[[nodiscard]] QByteArray groupTextPacket(quint32 seed, QByteArrayView path);
+
+// Companion protocol frames as the radio sends them, code byte first
+[[nodiscard]] QByteArray logRxDataFrame(qint8 snrQuarters, qint8 rssi, QByteArrayView packet);
+// Contact response or NewAdvert push for a contact derived from seed
+[[nodiscard]] QByteArray contactFrame(quint8 code, quint32 seed);
+[[nodiscard]] QByteArray sentFrame();
+[[nodiscard]] QByteArray msgWaitingFrame();
+
+// RX-log-heavy mix seen while a busy mesh is monitored: mostly RX log
+// pushes, some new adverts, a few command replies and message notices
+[[nodiscard]] QList<QByteArray> rxLogHeavyFrames(qsizetype count);
+
+using Message = std::variant<ContactMessage, ChannelMessage>;
+
+// Chat-like text of 3 to 20 words from a small vocabulary, derived from seed
+[[nodiscard]] QString messageText(quint32 seed);
+// Messages first .. first + count - 1 of a history spread over 64 contacts
+// and 8 channels, every fourth one on a channel
+[[nodiscard]] QList<Message> messageHistory(qsizetype first, qsizetype count);
+
+/**
+ * @brief MeshCoreConnection without a transport
+ *
+ * Frames are fed in directly and sent frames are only counted.
+ */
+class BenchConnection : public MeshCoreConnection
+{
+public:
+    using MeshCoreConnection::MeshCoreConnection;
+    using MeshCoreConnection::onFrameReceived;
+
+    void close() override {}
+    [[nodiscard]] quint64 sentFrames() const { return m_sentFrames; }
+
+protected:
+    void sendToRadioFrame(const QByteArray &) override { ++m_sentFrames; }
+
+private:
+    quint64 m_sentFrames = 0;
+};
+
+} // namespace MeshCore::Bench
+
+#endif // BENCHMARKSUPPORT_H
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include "AllocationCounter.h"
+#include "BenchmarkSupport.h"
+#include "meshcore/connection/ProtocolSchema.h"
+#include "meshcore/utils/BufferWriter.h"
+
+using namespace MeshCore;
+using namespace MeshCore::Bench;
+
+namespace {
+
+void setAllocationCounter(benchmark::State &state, quint64 since)
+{
+    state.counters["allocs_per_op"] = benchmark::Counter(double(allocationCount() - since),
+                                                         benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// The longest text a MeshCore radio sends in one message, in UTF-8 bytes
+constexpr qsizetype MaxTextSize = 160;
+
+// Frame::encode of a SendTxtMsg: one allocation, for the returned frame,
+// up to the longest text
+void BM_EncodeSendTxtMsg(benchmark::State &state, const QString &text)
+{
+    const QByteArray prefix(Protocol::PublicKeyPrefixSize, char(0x5A));
+
+    quint64 allocations = allocationCount();
+    for (auto _ : state) {
+        QByteArray frame = Protocol::SendTxtMsg::encode(TxtType::Plain, quint8(0), quint32(1700000000), prefix, text);
+        benchmark::DoNotOptimize(frame);
+    }
+    setAllocationCounter(state, allocations);
+}
+BENCHMARK_CAPTURE(BM_EncodeSendTxtMsg, typical, QStringLiteral("On my way, see you at the trailhead in ten minutes"));
+BENCHMARK_CAPTURE(BM_EncodeSendTxtMsg, max_length, QString(MaxTextSize, QLatin1Char('a')));
+// Two UTF-8 bytes per character
+BENCHMARK_CAPTURE(BM_EncodeSendTxtMsg, max_length_cyrillic, QString(MaxTextSize / 2, QChar(0x0416)));
+
+// A message send through the connection and its pipeline, completed by
+// the radio's Sent reply
+void BM_SendCommandSendTxtMsg(benchmark::State &state)
+{
+    const QByteArray prefix(Protocol::PublicKeyPrefixSize, char(0x5A));
+    const QString text = QStringLiteral("On my way, see you at the trailhead in ten minutes");
+    BenchConnection connection;
+
+    quint64 allocations = allocationCount();
+    for (auto _ : state) {
+        connection.sendCommandSendTxtMsg(TxtType::Plain, 0, 1700000000, prefix, text);
+        connection.commandPipeline()->onResponse(quint8(ResponseCode::Sent));
+    }
+    setAllocationCounter(state, allocations);
+}
+BENCHMARK(BM_SendCommandSendTxtMsg);
+
+// A record of range(0) bytes built and passed on as a view, as MessageStore
+// and RxCaptureWriter do: inline up to InlineCapacity, one heap buffer past it
+void BM_BufferWriterRecord(benchmark::State &state)
+{
+    const QByteArray body(state.range(0), char(0x42));
+
+    quint64 allocations = allocationCount();
+    for (auto _ : state) {
+        BufferWriter writer;
+        writer.writeUInt32LE(quint32(body.size()));
+        writer.writeUInt32LE(1700000000);
+        writer.writeBytes(body);
+        benchmark::DoNotOptimize(writer.view().data());
+    }
+    setAllocationCounter(state, allocations);
+    state.SetBytesProcessed(state.iterations() * (body.size() + 8));
+}
+BENCHMARK(BM_BufferWriterRecord)->Arg(64)->Arg(240)->Arg(1024);
+
+} // namespace
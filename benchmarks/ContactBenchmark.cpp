@@ -0,0 +1,177 @@
+#include <benchmark/benchmark.h>
+
+#include "AllocationCounter.h"
+#include "BenchmarkSupport.h"
+#include "meshcore/models/ContactModel.h"
+
+using namespace MeshCore;
+using namespace MeshCore::Bench;
+
+namespace {
+
+// Contacts with random keys and distinct names, as after a full sync
+QList<Contact> makeContacts(qsizetype count)
+{
+    QRandomGenerator random(12);
+    QList<Contact> contacts;
+    contacts.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        const QByteArray key = randomBytes(random, Contact::PublicKeySize);
+        const QByteArray path = randomBytes(random, 3);
+        contacts.append(Contact(key, AdvertType::Chat, 0, qint8(path.size()), path,
+                                QStringLiteral("Node %1").arg(i), 1700000000, 0, 0, 1700000000));
+    }
+    return contacts;
+}
+
+// A model holding range(0) contacts, plus the contacts it was filled from
+struct ContactFixture {
+    explicit ContactFixture(qsizetype count) : contacts(makeContacts(count)) { model.addContacts(contacts); }
+
+    QList<Contact> contacts;
+    ContactModel model;
+};
+
+void BM_ContactIndexOf(benchmark::State &state)
+{
+    ContactFixture fixture(state.range(0));
+    QList<QByteArray> keys;
+    for (const Contact &contact : std::as_const(fixture.contacts)) {
+        keys.append(contact.publicKey());
+    }
+
+    qsizetype next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.model.indexOf(keys.at(next)));
+        next = (next + 1) % keys.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ContactIndexOf)->Arg(1000)->Arg(10000);
+
+void BM_ContactFindByName(benchmark::State &state)
+{
+    ContactFixture fixture(state.range(0));
+    QStringList names;
+    for (const Contact &contact : std::as_const(fixture.contacts)) {
+        names.append(contact.name());
+    }
+
+    qsizetype next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.model.findByName(names.at(next)));
+        next = (next + 1) % names.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ContactFindByName)->Arg(1000)->Arg(10000);
+
+// Lookup by the 6-byte prefix messages are addressed with
+void BM_ContactFindByPublicKeyPrefix(benchmark::State &state)
+{
+    ContactFixture fixture(state.range(0));
+    QList<QByteArray> prefixes;
+    for (const Contact &contact : std::as_const(fixture.contacts)) {
+        prefixes.append(contact.publicKeyPrefix(6));
+    }
+
+    qsizetype next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.model.findByPublicKeyPrefix(prefixes.at(next)));
+        next = (next + 1) % prefixes.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ContactFindByPublicKeyPrefix)->Arg(1000)->Arg(10000);
+
+// Every candidate for a 1-byte path hash: about count / 256 matches
+void BM_ContactFindAllByPathHash(benchmark::State &state)
+{
+    ContactFixture fixture(state.range(0));
+
+    int hash = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.model.findAllByPublicKeyPrefix(QByteArray(1, char(hash))));
+        hash = (hash + 1) % 256;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ContactFindAllByPathHash)->Arg(1000)->Arg(10000);
+
+// Filling an empty model from a full contact sync, indices included
+void BM_ContactAddContacts(benchmark::State &state)
+{
+    const QList<Contact> contacts = makeContacts(state.range(0));
+
+    for (auto _ : state) {
+        ContactModel model;
+        model.addContacts(contacts);
+        benchmark::DoNotOptimize(model.rowCount());
+    }
+    state.SetItemsProcessed(state.iterations() * contacts.size());
+}
+BENCHMARK(BM_ContactAddContacts)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+void setMemoryCounters(benchmark::State &state, qsizetype contacts, quint64 allocations, quint64 bytes)
+{
+    double perContact = double(state.iterations()) * double(contacts);
+    state.counters["sizeof"] = double(sizeof(Contact));
+    state.counters["allocs_per_contact"] = double(allocationCount() - allocations) / perContact;
+    state.counters["heap_bytes_per_contact"] = double(allocatedBytes() - bytes) / perContact;
+    state.SetItemsProcessed(state.iterations() * contacts);
+}
+
+// Building contacts from decoded views, as readContactRecord() does
+void BM_ContactConstruct(benchmark::State &state)
+{
+    QRandomGenerator random(13);
+    const QByteArray key = randomBytes(random, Contact::PublicKeySize);
+    const QByteArray path = randomBytes(random, 3);
+    const QString name = QStringLiteral("Hilltop Repeater");
+
+    quint64 allocations = allocationCount();
+    quint64 bytes = allocatedBytes();
+    for (auto _ : state) {
+        Contact contact(key, AdvertType::Repeater, 0, qint8(path.size()), path, name,
+                        1700000000, 0, 0, 1700000000);
+        benchmark::DoNotOptimize(contact);
+    }
+    setMemoryCounters(state, 1, allocations, bytes);
+}
+BENCHMARK(BM_ContactConstruct);
+
+// Memory and time to copy a contact list into a new one, as a queued
+// contactsReceived signal does; the list buffer itself is included
+void BM_ContactListCopy(benchmark::State &state)
+{
+    const QList<Contact> contacts = makeContacts(state.range(0));
+
+    quint64 allocations = allocationCount();
+    quint64 bytes = allocatedBytes();
+    for (auto _ : state) {
+        QList<Contact> copy(contacts.cbegin(), contacts.cend());
+        benchmark::DoNotOptimize(copy.data());
+    }
+    setMemoryCounters(state, contacts.size(), allocations, bytes);
+}
+BENCHMARK(BM_ContactListCopy)->Arg(10000);
+
+// The getters now build their values on demand: the cost a delegate pays
+void BM_ContactNameAndKey(benchmark::State &state)
+{
+    const QList<Contact> contacts = makeContacts(1024);
+
+    qsizetype next = 0;
+    quint64 allocations = allocationCount();
+    quint64 bytes = allocatedBytes();
+    for (auto _ : state) {
+        const Contact &contact = contacts.at(next);
+        benchmark::DoNotOptimize(contact.name());
+        benchmark::DoNotOptimize(contact.publicKey());
+        next = (next + 1) % contacts.size();
+    }
+    setMemoryCounters(state, 1, allocations, bytes);
+}
+BENCHMARK(BM_ContactNameAndKey);
+
+} // namespace
@@ -0,0 +1,167 @@
+#include <benchmark/benchmark.h>
+#include <QtEndian>
+#include <stdexcept>
+
+#include "AllocationCounter.h"
+#include "BenchmarkSupport.h"
+#include "meshcore/connection/ProtocolSchema.h"
+#include "meshcore/utils/BufferReader.h"
+
+using namespace MeshCore;
+using namespace MeshCore::Bench;
+
+namespace {
+
+// The reader as it was before the status-based one: every short read throws
+class ThrowingReader
+{
+public:
+    explicit ThrowingReader(QByteArrayView data) : m_data(data) {}
+
+    QByteArrayView readBytesView(qsizetype count)
+    {
+        if (m_position + count > m_data.size()) {
+            throw std::out_of_range("BufferReader: read past end of buffer");
+        }
+        QByteArrayView bytes = m_data.sliced(m_position, count);
+        m_position += count;
+        return bytes;
+    }
+    quint8 readByte() { return quint8(readBytesView(1).front()); }
+    quint32 readUInt32LE() { return qFromLittleEndian<quint32>(readBytesView(4).data()); }
+
+private:
+    QByteArrayView m_data;
+    qsizetype m_position = 0;
+};
+
+struct ContactFields {
+    QByteArrayView publicKey;
+    quint8 type = 0;
+    quint8 flags = 0;
+    quint8 outPathLen = 0;
+    QByteArrayView outPath;
+    QByteArrayView name;
+    quint32 lastAdvert = 0;
+    quint32 latitude = 0;
+    quint32 longitude = 0;
+    quint32 lastModified = 0;
+};
+
+// Contact frames with every eighth one cut short, as on a noisy serial line
+QList<QByteArray> contactFrames(bool withTruncated)
+{
+    QList<QByteArray> frames;
+    for (quint32 seed = 0; seed < 1024; ++seed) {
+        QByteArray frame = contactFrame(quint8(ResponseCode::Contact), seed);
+        if (withTruncated && seed % 8 == 0) {
+            frame.truncate(frame.size() / 2);
+        }
+        frames.append(frame);
+    }
+    return frames;
+}
+
+void setDecodeCounters(benchmark::State &state, qint64 bytes, qint64 malformed)
+{
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+    state.counters["malformed"] = benchmark::Counter(double(malformed), benchmark::Counter::kAvgIterations);
+}
+
+// Decode throughput of a Contact record, status checked once per frame
+void BM_DecodeContactWithStatus(benchmark::State &state)
+{
+    const QList<QByteArray> frames = contactFrames(state.range(0) != 0);
+    qsizetype next = 0;
+    qint64 bytes = 0;
+    qint64 malformed = 0;
+    for (auto _ : state) {
+        const QByteArray &frame = frames.at(next);
+        BufferReader reader(QByteArrayView(frame).sliced(1));
+        auto fields = Protocol::ContactRecord::decode(reader);
+        benchmark::DoNotOptimize(fields);
+        malformed += reader.hasError();
+        bytes += frame.size();
+        next = (next + 1) % frames.size();
+    }
+    setDecodeCounters(state, bytes, malformed);
+}
+BENCHMARK(BM_DecodeContactWithStatus)->Arg(0)->Arg(1)->ArgName("truncated");
+
+// The same decode through the throwing reader, caught per frame
+void BM_DecodeContactThrowing(benchmark::State &state)
+{
+    const QList<QByteArray> frames = contactFrames(state.range(0) != 0);
+    qsizetype next = 0;
+    qint64 bytes = 0;
+    qint64 malformed = 0;
+    for (auto _ : state) {
+        const QByteArray &frame = frames.at(next);
+        try {
+            ThrowingReader reader(QByteArrayView(frame).sliced(1));
+            ContactFields fields;
+            fields.publicKey = reader.readBytesView(32);
+            fields.type = reader.readByte();
+            fields.flags = reader.readByte();
+            fields.outPathLen = reader.readByte();
+            fields.outPath = reader.readBytesView(64);
+            fields.name = reader.readBytesView(32);
+            fields.lastAdvert = reader.readUInt32LE();
+            fields.latitude = reader.readUInt32LE();
+            fields.longitude = reader.readUInt32LE();
+            fields.lastModified = reader.readUInt32LE();
+            benchmark::DoNotOptimize(fields);
+        } catch (const std::out_of_range &) {
+            ++malformed;
+        }
+        bytes += frame.size();
+        next = (next + 1) % frames.size();
+    }
+    setDecodeCounters(state, bytes, malformed);
+}
+BENCHMARK(BM_DecodeContactThrowing)->Arg(0)->Arg(1)->ArgName("truncated");
+
+// Whole frames through the connection: malformed ones are counted and dropped
+void BM_DispatchContactFrames(benchmark::State &state)
+{
+    const QList<QByteArray> frames = contactFrames(state.range(0) != 0);
+    BenchConnection connection;
+    connection.sendCommandGetContacts();
+
+    qsizetype next = 0;
+    qint64 bytes = 0;
+    for (auto _ : state) {
+        const QByteArray &frame = frames.at(next);
+        connection.onFrameReceived(frame);
+        bytes += frame.size();
+        next = (next + 1) % frames.size();
+    }
+    setDecodeCounters(state, bytes, qint64(connection.malformedFrameCount()));
+}
+BENCHMARK(BM_DispatchContactFrames)->Arg(0)->Arg(1)->ArgName("truncated");
+
+// Allocations and time per Contact frame during a contact sync, with a
+// GetContacts command in flight as on a real connection
+void BM_ContactSyncFrame(benchmark::State &state)
+{
+    QList<QByteArray> frames;
+    for (quint32 seed = 0; seed < 1024; ++seed) {
+        frames.append(contactFrame(quint8(ResponseCode::Contact), seed));
+    }
+    BenchConnection connection;
+    connection.sendCommandGetContacts();
+
+    qsizetype next = 0;
+    quint64 allocations = allocationCount();
+    for (auto _ : state) {
+        connection.onFrameReceived(frames.at(next));
+        next = (next + 1) % frames.size();
+    }
+    state.counters["allocs_per_frame"] = benchmark::Counter(double(allocationCount() - allocations),
+                                                            benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ContactSyncFrame);
+
+} // namespace
@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+
+#include "AllocationCounter.h"
+#include "BenchmarkSupport.h"
+
+using namespace MeshCore;
+using namespace MeshCore::Bench;
+
+namespace {
+
+// Dispatch cost per frame under an RX-log-heavy mix, handlers and signal
+// emission included; nothing is connected to the signals
+void BM_DispatchRxLogHeavyMix(benchmark::State &state)
+{
+    const QList<QByteArray> frames = rxLogHeavyFrames(4096);
+    BenchConnection connection;
+
+    qsizetype next = 0;
+    qint64 bytes = 0;
+    for (auto _ : state) {
+        const QByteArray &frame = frames.at(next);
+        connection.onFrameReceived(frame);
+        bytes += frame.size();
+        next = (next + 1) % frames.size();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_DispatchRxLogHeavyMix);
+
+// The table lookup alone: a code with no handler is counted and dropped
+void BM_DispatchUnhandledCode(benchmark::State &state)
+{
+    const QByteArray frame(1, char(0x7F));
+    BenchConnection connection;
+
+    for (auto _ : state) {
+        connection.onFrameReceived(frame);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DispatchUnhandledCode);
+
+// One code at a time, to see where the mix spends its time
+void BM_DispatchSingleCode(benchmark::State &state)
+{
+    QRandomGenerator random(7);
+    QByteArray frame;
+    switch (state.range(0)) {
+    case 0:
+        frame = logRxDataFrame(20, -90, groupTextPacket(1, randomBytes(random, 4)));
+        state.SetLabel("LogRxData");
+        break;
+    case 1:
+        frame = contactFrame(quint8(PushCode::NewAdvert), 1);
+        state.SetLabel("NewAdvert");
+        break;
+    default:
+        frame = msgWaitingFrame();
+        state.SetLabel("MsgWaiting");
+        break;
+    }
+    BenchConnection connection;
+
+    quint64 allocations = allocationCount();
+    for (auto _ : state) {
+        connection.onFrameReceived(frame);
+    }
+    state.counters["allocs_per_frame"] = benchmark::Counter(double(allocationCount() - allocations),
+                                                            benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DispatchSingleCode)->DenseRange(0, 2);
+
+} // namespace
@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+#include <QDir>
+#include <memory>
+
+#include "BenchmarkSupport.h"
+#include "meshcore/models/ConversationModel.h"
+#include "meshcore/models/MessageModel.h"
+#include "meshcore/storage/MessageStore.h"
+
+using namespace MeshCore;
+using namespace MeshCore::Bench;
+
+namespace {
+
+constexpr qsizetype HistorySize = 100000;
+constexpr int ViewportRows = 20;
+
+const QList<int> ScrollRoles = {MessageModel::SenderRole, MessageModel::TextRole,
+                                MessageModel::DateTimeRole, MessageModel::IsDirectRole};
+
+QByteArray deviceKey(char fill)
+{
+    return QByteArray(32, fill);
+}
+
+// A MessageModel paging a 100k-message store, built once and shared by the
+// scrolling benchmarks; the store is deleted from disk on exit
+struct StoredHistory {
+    StoredHistory()
+    {
+        const QByteArray key = deviceKey(0x16);
+        directory = MessageStore::directory(key);
+        QDir(directory).removeRecursively();
+        store.open(key);
+        model.setStore(&store);
+        for (qsizetype first = 0; first < HistorySize; first += 1000) {
+            model.addMessages(messageHistory(first, 1000));
+        }
+    }
+    ~StoredHistory()
+    {
+        model.setStore(nullptr);
+        store.close();
+        QDir(directory).removeRecursively();
+    }
+
+    QString directory;
+    MessageStore store;
+    MessageModel model;
+};
+
+StoredHistory &storedHistory()
+{
+    static StoredHistory history;
+    return history;
+}
+
+void readViewport(const QAbstractItemModel &model, int top)
+{
+    for (int row = top; row < top + ViewportRows; ++row) {
+        const QModelIndex index = model.index(row, 0);
+        for (int role : ScrollRoles) {
+            benchmark::DoNotOptimize(model.data(index, role));
+        }
+    }
+}
+
+// Appending 100k messages in batches of range(0), to a model alone or to
+// one backed by a store (range(1)), conversation lists included
+void BM_MessageModelInsert(benchmark::State &state)
+{
+    const qsizetype batchSize = state.range(0);
+    const bool stored = state.range(1) != 0;
+    QList<QList<Message>> batches;
+    for (qsizetype first = 0; first < HistorySize; first += batchSize) {
+        batches.append(messageHistory(first, batchSize));
+    }
+    const QByteArray key = deviceKey(0x17);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        QDir(MessageStore::directory(key)).removeRecursively();
+        auto store = std::make_unique<MessageStore>();
+        auto model = std::make_unique<MessageModel>();
+        if (stored) {
+            store->open(key);
+            model->setStore(store.get());
+        }
+        state.ResumeTiming();
+
+        for (const QList<Message> &batch : std::as_const(batches)) {
+            model->addMessages(batch);
+        }
+
+        state.PauseTiming();
+        model.reset();
+        store.reset();
+        state.ResumeTiming();
+    }
+    QDir(MessageStore::directory(key)).removeRecursively();
+    state.SetItemsProcessed(state.iterations() * HistorySize);
+}
+BENCHMARK(BM_MessageModelInsert)
+    ->ArgsProduct({{1, 64}, {0, 1}})
+    ->ArgNames({"batch", "stored"})
+    ->Unit(benchmark::kMillisecond);
+
+// A viewport of rows read for the roles a delegate binds, scrolled back
+// from the newest message a few rows at a time (range(0) == 0) or jumping
+// to random positions, which misses the page cache (range(0) == 1)
+void BM_MessageModelScroll(benchmark::State &state)
+{
+    const MessageModel &model = storedHistory().model;
+    const bool jump = state.range(0) != 0;
+    const int lastTop = model.rowCount() - ViewportRows;
+    QRandomGenerator random(16);
+
+    int top = lastTop;
+    for (auto _ : state) {
+        readViewport(model, top);
+        if (jump) {
+            top = random.bounded(lastTop + 1);
+        } else {
+            top = top >= 3 ? top - 3 : lastTop;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * ViewportRows);
+}
+BENCHMARK(BM_MessageModelScroll)->Arg(0)->Arg(1)->ArgName("jump");
+
+// The same scroll through one contact's conversation view
+void BM_ConversationScroll(benchmark::State &state)
+{
+    MessageModel &model = storedHistory().model;
+    const quint64 key = MessageRecord::contactConversationKey(QByteArray(6, char(0x40)));
+    const ConversationModel *conversation = model.conversation(key);
+    const int lastTop = conversation->rowCount() - ViewportRows;
+
+    int top = lastTop;
+    for (auto _ : state) {
+        for (int row = top; row < top + ViewportRows; ++row) {
+            const int messageRow = conversation->data(conversation->index(row), ConversationModel::MessageRowRole).toInt();
+            const QModelIndex index = model.index(messageRow);
+            for (int role : ScrollRoles) {
+                benchmark::DoNotOptimize(model.data(index, role));
+            }
+        }
+        top = top >= 3 ? top - 3 : lastTop;
+    }
+    state.SetItemsProcessed(state.iterations() * ViewportRows);
+}
+BENCHMARK(BM_ConversationScroll);
+
+} // namespace
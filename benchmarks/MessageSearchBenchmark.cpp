@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include <QDir>
+
+#include "BenchmarkSupport.h"
+#include "meshcore/storage/MessageSearchIndex.h"
+#include "meshcore/storage/MessageStore.h"
+
+using namespace MeshCore;
+using namespace MeshCore::Bench;
+
+namespace {
+
+constexpr qsizetype IndexedMessages = 1000000;
+constexpr qsizetype AddBatchSize = 64;
+
+// An index over 1M chat-like messages, built once through addMessages()
+// as the model feeds it, saved, and deleted from disk on exit
+struct IndexedHistory {
+    IndexedHistory()
+    {
+        directory = MessageStore::directory(key);
+        QDir(directory).removeRecursively();
+        index.open(key);
+        for (qsizetype first = 0; first < IndexedMessages; first += AddBatchSize) {
+            QStringList texts;
+            for (qsizetype row = first; row < first + AddBatchSize; ++row) {
+                texts.append(messageText(quint32(row)));
+            }
+            index.addMessages(int(first), texts);
+        }
+        // Reopened from the files, as after a restart
+        index.close();
+        index.open(key);
+    }
+    ~IndexedHistory()
+    {
+        index.close();
+        QDir(directory).removeRecursively();
+    }
+
+    const QByteArray key = QByteArray(32, char(0x18));
+    QString directory;
+    MessageSearchIndex index;
+};
+
+IndexedHistory &indexedHistory()
+{
+    static IndexedHistory history;
+    return history;
+}
+
+// One query against the 1M-message index, ranking included
+void BM_SearchQuery(benchmark::State &state, const QString &query)
+{
+    const MessageSearchIndex &index = indexedHistory().index;
+
+    qsizetype hits = 0;
+    for (auto _ : state) {
+        const QList<MessageSearchHit> results = index.find(query);
+        hits = results.size();
+        benchmark::DoNotOptimize(results.constData());
+    }
+    state.counters["hits"] = double(hits);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_SearchQuery, one_word, QStringLiteral("firmware"))->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SearchQuery, two_words, QStringLiteral("solar battery"))->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SearchQuery, three_words, QStringLiteral("solar battery low"))->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SearchQuery, typed_prefix, QStringLiteral("meet rep"))->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SearchQuery, no_match, QStringLiteral("zebra"))->Unit(benchmark::kMicrosecond);
+
+// Loading the saved 1M-message index, as when a device connects
+void BM_SearchIndexOpen(benchmark::State &state)
+{
+    const QByteArray key = indexedHistory().key;
+
+    for (auto _ : state) {
+        MessageSearchIndex index;
+        index.open(key);
+        benchmark::DoNotOptimize(index.indexedCount());
+    }
+    state.SetItemsProcessed(state.iterations() * IndexedMessages);
+}
+BENCHMARK(BM_SearchIndexOpen)->Unit(benchmark::kMillisecond);
+
+// Indexing new messages in model-sized batches, periodic saves included
+void BM_SearchIndexAdd(benchmark::State &state)
+{
+    const QByteArray key(32, char(0x19));
+    const QString directory = MessageStore::directory(key);
+    QDir(directory).removeRecursively();
+    QList<QString> texts;
+    for (quint32 seed = 0; seed < 4096; ++seed) {
+        texts.append(messageText(seed));
+    }
+
+    MessageSearchIndex index;
+    index.open(key);
+    qsizetype row = 0;
+    for (auto _ : state) {
+        QStringList batch;
+        for (qsizetype i = 0; i < AddBatchSize; ++i) {
+            batch.append(texts.at((row + i) % texts.size()));
+        }
+        index.addMessages(int(row), batch);
+        row += AddBatchSize;
+    }
+    index.close();
+    QDir(directory).removeRecursively();
+    state.SetItemsProcessed(state.iterations() * AddBatchSize);
+}
+BENCHMARK(BM_SearchIndexAdd);
+
+} // namespace
@@ -0,0 +1,163 @@
+#include <benchmark/benchmark.h>
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "BenchmarkSupport.h"
+#include "meshcore/storage/RxCapture.h"
+#include "meshcore/utils/PacketView.h"
+
+using namespace MeshCore;
+using namespace MeshCore::Bench;
+
+namespace {
+
+constexpr qsizetype CapturedPackets = 1000000;
+constexpr qint64 PacketSpacingMs = 10;  // 100 packets/s
+
+QList<QByteArray> capturePackets()
+{
+    QRandomGenerator random(24);
+    QList<QByteArray> packets;
+    for (quint32 seed = 0; seed < 4096; ++seed) {
+        const QByteArray path = randomBytes(random, random.bounded(8));
+        packets.append(seed % 4 == 0 ? advertPacket(seed, path) : groupTextPacket(seed, path));
+    }
+    return packets;
+}
+
+// A closed capture of 1M packets and a copy taken before it was closed,
+// which has to be recovered by walking its records; written once to a
+// temporary directory removed on exit
+struct LargeCapture {
+    LargeCapture()
+    {
+        closedPath = directory.filePath(QStringLiteral("closed.qmrx"));
+        unclosedPath = directory.filePath(QStringLiteral("unclosed.qmrx"));
+        startMs = QDateTime::currentMSecsSinceEpoch();
+
+        const QList<QByteArray> packets = capturePackets();
+        RxCaptureWriter writer;
+        writer.open(closedPath);
+        for (qsizetype row = 0; row < CapturedPackets; ++row) {
+            writer.append(startMs + row * PacketSpacingMs, 7.25, -92, packets.at(row % packets.size()));
+        }
+        writer.flush();
+        QFile::copy(closedPath, unclosedPath);
+        writer.close();
+        size = QFile(closedPath).size();
+    }
+
+    QTemporaryDir directory;
+    QString closedPath;
+    QString unclosedPath;
+    qint64 startMs = 0;
+    qint64 size = 0;
+};
+
+LargeCapture &largeCapture()
+{
+    static LargeCapture capture;
+    return capture;
+}
+
+// Recording throughput: encoding into the buffer and the periodic writes
+void BM_RxCaptureWrite(benchmark::State &state)
+{
+    const QList<QByteArray> packets = capturePackets();
+    QTemporaryDir directory;
+    RxCaptureWriter writer;
+    writer.open(directory.filePath(QStringLiteral("write.qmrx")));
+
+    qsizetype next = 0;
+    qint64 ms = QDateTime::currentMSecsSinceEpoch();
+    qint64 bytes = 0;
+    for (auto _ : state) {
+        const QByteArray &packet = packets.at(next);
+        writer.append(ms, 7.25, -92, packet);
+        bytes += packet.size();
+        ms += PacketSpacingMs;
+        next = (next + 1) % packets.size();
+    }
+    writer.close();
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_RxCaptureWrite);
+
+// Opening the 1M-packet capture: through the trailer and index chain when
+// closed (range(0) == 0), by walking every record when not (range(0) == 1)
+void BM_RxCaptureOpen(benchmark::State &state)
+{
+    const LargeCapture &capture = largeCapture();
+    const QString &path = state.range(0) == 0 ? capture.closedPath : capture.unclosedPath;
+
+    for (auto _ : state) {
+        RxCaptureReader reader;
+        reader.open(path);
+        benchmark::DoNotOptimize(reader.count());
+    }
+    state.SetBytesProcessed(state.iterations() * capture.size);
+}
+BENCHMARK(BM_RxCaptureOpen)->Arg(0)->Arg(1)->ArgName("unclosed")->Unit(benchmark::kMillisecond);
+
+// Rows decoded as a view scrolls (range(0) == 0) or jumps around
+// (range(0) == 1), each entry's packet parsed for its hash
+void BM_RxCaptureEntry(benchmark::State &state)
+{
+    RxCaptureReader reader;
+    reader.open(largeCapture().closedPath);
+    const bool jump = state.range(0) != 0;
+    QRandomGenerator random(24);
+
+    qsizetype row = 0;
+    for (auto _ : state) {
+        const RxLogEntry entry = reader.entry(row);
+        benchmark::DoNotOptimize(entry.packetHash());
+        row = jump ? random.bounded(int(reader.count())) : (row + 1) % reader.count();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RxCaptureEntry)->Arg(0)->Arg(1)->ArgName("jump");
+
+// Jump-to-time: a binary search over the 1M rows
+void BM_RxCaptureRowAtTime(benchmark::State &state)
+{
+    const LargeCapture &capture = largeCapture();
+    RxCaptureReader reader;
+    reader.open(capture.closedPath);
+    QRandomGenerator random(24);
+
+    for (auto _ : state) {
+        const qint64 ms = capture.startMs + random.bounded(int(CapturedPackets)) * PacketSpacingMs;
+        benchmark::DoNotOptimize(reader.rowAtTime(ms));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RxCaptureRowAtTime);
+
+// Header and payload decode of captured packets through PacketView
+void BM_PacketViewDecode(benchmark::State &state)
+{
+    const QList<QByteArray> packets = capturePackets();
+
+    qsizetype next = 0;
+    qint64 bytes = 0;
+    for (auto _ : state) {
+        const QByteArray &packet = packets.at(next);
+        const PacketView view(packet);
+        benchmark::DoNotOptimize(view.payloadHash());
+        if (view.payloadType() == PayloadType::Advert) {
+            benchmark::DoNotOptimize(view.advert());
+        } else {
+            benchmark::DoNotOptimize(view.group());
+        }
+        bytes += packet.size();
+        next = (next + 1) % packets.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_PacketViewDecode);
+
+} // namespace
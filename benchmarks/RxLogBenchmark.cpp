@@ -0,0 +1,354 @@
+#include <benchmark/benchmark.h>
+#include <QDateTime>
+
+#include "AllocationCounter.h"
+#include "BenchmarkSupport.h"
+#include "meshcore/models/RxLogModel.h"
+#include "meshcore/types/RxLogEntry.h"
+#include "meshcore/utils/PacketIdentityTable.h"
+
+using namespace MeshCore;
+using namespace MeshCore::Bench;
+
+namespace {
+
+// On-air packets as heard on a busy mesh: adverts and group texts over
+// paths of 0 to 7 hops
+QList<QByteArray> rxPackets(qsizetype count)
+{
+    QRandomGenerator random(22);
+    QList<QByteArray> packets;
+    packets.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        const QByteArray path = randomBytes(random, random.bounded(8));
+        packets.append(i % 4 == 0 ? advertPacket(quint32(i), path) : groupTextPacket(quint32(i), path));
+    }
+    return packets;
+}
+
+void setIngestCounters(benchmark::State &state, quint64 allocations)
+{
+    state.counters["allocs_per_entry"] = benchmark::Counter(double(allocationCount() - allocations),
+                                                            benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Ingest as it is now: two clock reads and the raw bytes shared
+void BM_RxLogEntryIngest(benchmark::State &state)
+{
+    const QList<QByteArray> packets = rxPackets(1024);
+
+    qsizetype next = 0;
+    quint64 allocations = allocationCount();
+    for (auto _ : state) {
+        RxLogEntry entry(7.25, -92, packets.at(next));
+        benchmark::DoNotOptimize(entry);
+        next = (next + 1) % packets.size();
+    }
+    setIngestCounters(state, allocations);
+}
+BENCHMARK(BM_RxLogEntryIngest);
+
+// The entry as it was before lazy parsing: a local-time QDateTime read
+// and the packet parsed up front, through copies of the payload and the
+// advert name; the hex dump and time string rebuilt on every read
+struct BaselineRxLogEntry
+{
+    BaselineRxLogEntry(double snr, qint8 rssi, const QByteArray &rawData)
+        : m_timestamp(QDateTime::currentDateTime())
+        , m_snr(snr)
+        , m_rssi(rssi)
+        , m_rawData(rawData)
+    {
+        parsePacket();
+    }
+
+    QString timestampString() const { return m_timestamp.toString("hh:mm:ss.zzz"); }
+    QString rawDataHex() const { return QString::fromLatin1(m_rawData.toHex(' ').toUpper()); }
+    int payloadType() const { return m_payloadType; }
+
+    static constexpr quint8 ADV_LATLON_MASK = 0x10;
+    static constexpr quint8 ADV_NAME_MASK = 0x80;
+
+    void parsePacket()
+    {
+        if (m_rawData.isEmpty()) {
+            return;
+        }
+
+        quint8 header = static_cast<quint8>(m_rawData.at(0));
+        m_routeType = header & 0x03;
+        m_payloadType = (header >> 2) & 0x0F;
+        m_payloadVersion = (header >> 6) & 0x03;
+
+        int offset = 1;
+        if (m_routeType == RxLogEntry::RouteTransportFlood || m_routeType == RxLogEntry::RouteTransportDirect) {
+            offset += 4;
+        }
+        if (m_rawData.size() > offset) {
+            m_pathLength = static_cast<quint8>(m_rawData.at(offset));
+            m_hopCount = m_pathLength / 6;
+            offset += 1;
+        }
+        offset += m_pathLength;
+
+        if (m_rawData.size() > offset) {
+            QByteArray payload = m_rawData.mid(offset);
+            parsePayload(payload);
+        }
+    }
+
+    void parsePayload(const QByteArray &payload)
+    {
+        if (payload.isEmpty()) {
+            return;
+        }
+
+        switch (m_payloadType) {
+        case RxLogEntry::PayloadRequest:
+        case RxLogEntry::PayloadResponse:
+        case RxLogEntry::PayloadTextMsg:
+        case RxLogEntry::PayloadAck:
+        case RxLogEntry::PayloadGroupText:
+        case RxLogEntry::PayloadGroupData:
+        case RxLogEntry::PayloadPath:
+            if (payload.size() >= 2) {
+                m_destHash = static_cast<quint8>(payload.at(0));
+                m_srcHash = static_cast<quint8>(payload.at(1));
+            }
+            break;
+        case RxLogEntry::PayloadAdvert:
+            parseAdvert(payload);
+            break;
+        case RxLogEntry::PayloadAnonRequest:
+            if (payload.size() >= 1) {
+                m_destHash = static_cast<quint8>(payload.at(0));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void parseAdvert(const QByteArray &payload)
+    {
+        int offset = 32 + 4 + 64;
+        if (payload.size() <= offset) {
+            return;
+        }
+
+        quint8 flags = static_cast<quint8>(payload.at(offset));
+        m_advertType = flags & 0x0F;
+        offset++;
+
+        if ((flags & ADV_LATLON_MASK) && payload.size() >= offset + 8) {
+            qint32 latRaw = static_cast<quint8>(payload.at(offset)) |
+                           (static_cast<quint8>(payload.at(offset + 1)) << 8) |
+                           (static_cast<quint8>(payload.at(offset + 2)) << 16) |
+                           (static_cast<quint8>(payload.at(offset + 3)) << 24);
+            qint32 lonRaw = static_cast<quint8>(payload.at(offset + 4)) |
+                           (static_cast<quint8>(payload.at(offset + 5)) << 8) |
+                           (static_cast<quint8>(payload.at(offset + 6)) << 16) |
+                           (static_cast<quint8>(payload.at(offset + 7)) << 24);
+            m_latitude = latRaw / 1e6;
+            m_longitude = lonRaw / 1e6;
+            m_hasLocation = true;
+            offset += 8;
+        }
+
+        if ((flags & ADV_NAME_MASK) && payload.size() > offset) {
+            QByteArray nameBytes = payload.mid(offset);
+            int nullPos = nameBytes.indexOf('\0');
+            if (nullPos >= 0) {
+                m_advertName = QString::fromUtf8(nameBytes.left(nullPos));
+            } else {
+                m_advertName = QString::fromUtf8(nameBytes);
+            }
+        }
+    }
+
+    QDateTime m_timestamp;
+    double m_snr = 0.0;
+    qint8 m_rssi = 0;
+    QByteArray m_rawData;
+    int m_routeType = -1;
+    int m_payloadType = -1;
+    int m_payloadVersion = 0;
+    int m_hopCount = 0;
+    int m_pathLength = 0;
+    int m_destHash = -1;
+    int m_srcHash = -1;
+    QString m_advertName;
+    int m_advertType = 0;
+    bool m_hasLocation = false;
+    double m_latitude = 0.0;
+    double m_longitude = 0.0;
+};
+
+// Ingest as it was, with the baseline entry above
+void BM_RxLogEntryIngestEager(benchmark::State &state)
+{
+    const QList<QByteArray> packets = rxPackets(1024);
+
+    qsizetype next = 0;
+    quint64 allocations = allocationCount();
+    for (auto _ : state) {
+        BaselineRxLogEntry entry(7.25, -92, packets.at(next));
+        benchmark::DoNotOptimize(entry.payloadType());
+        next = (next + 1) % packets.size();
+    }
+    setIngestCounters(state, allocations);
+}
+BENCHMARK(BM_RxLogEntryIngestEager);
+
+// Delegate reads per entry: a ListView asks again for the time and hex
+// roles whenever a row is scrolled back into view
+constexpr int ReadsPerEntry = 4;
+
+// Entries read from, RxLogModel's default maxEntries
+constexpr qsizetype DisplayedEntries = 500;
+
+// The time and hex roles read through RxLogModel::data(), formatted on the
+// first read and cached with the entry
+void BM_RxLogModelReadStrings(benchmark::State &state)
+{
+    const QList<QByteArray> packets = rxPackets(1024);
+    RxLogModel model;
+    model.setEnabled(true);
+    QList<RxLogEntry> entries;
+    for (qsizetype i = 0; i < DisplayedEntries; ++i) {
+        entries.append(RxLogEntry(7.25, -92, packets.at(i)));
+    }
+    model.addEntries(entries);
+    model.flush();
+
+    int row = 0;
+    quint64 allocations = allocationCount();
+    for (auto _ : state) {
+        const QModelIndex index = model.index(row);
+        for (int read = 0; read < ReadsPerEntry; ++read) {
+            benchmark::DoNotOptimize(model.data(index, RxLogModel::TimestampStringRole));
+            benchmark::DoNotOptimize(model.data(index, RxLogModel::RawDataHexRole));
+        }
+        row = (row + 1) % model.rowCount();
+    }
+    setIngestCounters(state, allocations);
+}
+BENCHMARK(BM_RxLogModelReadStrings);
+
+// The same reads as the old RxLogModel::data() served them: both strings
+// rebuilt on every read
+void BM_RxLogModelReadStringsEager(benchmark::State &state)
+{
+    const QList<QByteArray> packets = rxPackets(1024);
+    QList<BaselineRxLogEntry> entries;
+    for (qsizetype i = 0; i < DisplayedEntries; ++i) {
+        entries.append(BaselineRxLogEntry(7.25, -92, packets.at(i)));
+    }
+
+    qsizetype row = 0;
+    quint64 allocations = allocationCount();
+    for (auto _ : state) {
+        const BaselineRxLogEntry &entry = entries.at(row);
+        for (int read = 0; read < ReadsPerEntry; ++read) {
+            benchmark::DoNotOptimize(QVariant(entry.timestampString()));
+            benchmark::DoNotOptimize(QVariant(entry.rawDataHex()));
+        }
+        row = (row + 1) % entries.size();
+    }
+    setIngestCounters(state, allocations);
+}
+BENCHMARK(BM_RxLogModelReadStringsEager);
+
+// Entries through RxLogModel in flush-sized batches of range(0): ring
+// insertion, grouping of repeats and row notifications
+void BM_RxLogModelIngest(benchmark::State &state)
+{
+    const QList<QByteArray> packets = rxPackets(1024);
+    const qsizetype batchSize = state.range(0);
+    RxLogModel model;
+    model.setEnabled(true);
+
+    qsizetype next = 0;
+    quint64 allocations = allocationCount();
+    for (auto _ : state) {
+        QList<RxLogEntry> batch;
+        batch.reserve(batchSize);
+        for (qsizetype i = 0; i < batchSize; ++i) {
+            batch.append(RxLogEntry(7.25, -92, packets.at(next)));
+            next = (next + 1) % packets.size();
+        }
+        model.addEntries(batch);
+        model.flush();
+    }
+    state.counters["allocs_per_entry"] = benchmark::Counter(double(allocationCount() - allocations) / double(batchSize),
+                                                            benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_RxLogModelIngest)->Arg(1)->Arg(32);
+
+constexpr double TargetPacketsPerSecond = 10000.0;
+
+// Position in a stream where every packet is heard three times, the
+// repeats arriving 15 and 30 packets after the first sighting
+qsizetype streamPacket(qsizetype position)
+{
+    const qsizetype sighting = position % 3;
+    return qMax(qsizetype(0), position / 3 - sighting * 5);
+}
+
+// Multiples of the 10k packets/s a busy mesh can peak at, as a rate
+void setRealtimeCounter(benchmark::State &state, qint64 packets)
+{
+    state.counters["x_10k_per_s"] = benchmark::Counter(double(packets) / TargetPacketsPerSecond,
+                                                       benchmark::Counter::kIsRate);
+    state.SetItemsProcessed(packets);
+}
+
+// The identity table alone: a find per packet and an insert per first
+// sighting, with the clock advancing as at 10k packets/s
+void BM_PacketIdentityDedup(benchmark::State &state)
+{
+    QRandomGenerator64 random(25);
+    QList<quint64> hashes(65536);
+    for (quint64 &hash : hashes) {
+        hash = random.generate() | 1;
+    }
+    PacketIdentityTable table;
+
+    qsizetype position = 0;
+    qint64 nextId = 0;
+    for (auto _ : state) {
+        const quint64 hash = hashes.at(streamPacket(position) % hashes.size());
+        const qint64 nowMs = qint64(double(position) * 1000.0 / TargetPacketsPerSecond);
+        if (table.find(hash, nowMs) < 0) {
+            table.insert(hash, nextId++, nowMs);
+        }
+        ++position;
+    }
+    setRealtimeCounter(state, state.iterations());
+}
+BENCHMARK(BM_PacketIdentityDedup);
+
+// Grouping through RxPacketGroupModel in batches of range(0), entry
+// construction and packet parsing included
+void BM_RxPacketGrouping(benchmark::State &state)
+{
+    const QList<QByteArray> packets = rxPackets(16384);
+    const qsizetype batchSize = state.range(0);
+    RxPacketGroupModel model;
+
+    qsizetype position = 0;
+    for (auto _ : state) {
+        QList<RxLogEntry> batch;
+        batch.reserve(batchSize);
+        for (qsizetype i = 0; i < batchSize; ++i) {
+            batch.append(RxLogEntry(7.25, -92, packets.at(streamPacket(position++) % packets.size())));
+        }
+        model.addEntries(batch);
+    }
+    setRealtimeCounter(state, state.iterations() * batchSize);
+}
+BENCHMARK(BM_RxPacketGrouping)->Arg(1)->Arg(32);
+
+} // namespace
@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.h"
+#include "meshcore/connection/SerialConnection.h"
+
+using namespace MeshCore;
+using namespace MeshCore::Bench;
+
+namespace {
+
+class BenchSerialConnection : public SerialConnection
+{
+public:
+    using SerialConnection::processIncomingData;
+};
+
+// 10 MB as a device sends it: RX-log-heavy frames with a debug line
+// between every few of them
+const QByteArray &mixedSerialStream()
+{
+    static const QByteArray stream = [] {
+        constexpr qsizetype StreamSize = 10 * 1024 * 1024;
+        const QList<QByteArray> frames = rxLogHeavyFrames(4096);
+        const QByteArray debugLine("DEBUG: radio rx packet, len=42 snr=7.25 rssi=-92\n");
+
+        QByteArray stream;
+        stream.reserve(StreamSize + 2048);
+        for (qsizetype i = 0; stream.size() < StreamSize; ++i) {
+            const QByteArray &frame = frames.at(i % frames.size());
+            stream.append(char(SerialFrameTypes::Incoming));
+            stream.append(char(frame.size() & 0xFF));
+            stream.append(char(frame.size() >> 8));
+            stream.append(frame);
+            if (i % 4 == 0) {
+                stream.append(debugLine);
+            }
+        }
+        return stream;
+    }();
+    return stream;
+}
+
+// Framing and dispatch throughput, fed in reads of range(0) bytes
+void BM_SerialMixedStream(benchmark::State &state)
+{
+    const QByteArray &stream = mixedSerialStream();
+    const qsizetype chunkSize = state.range(0);
+
+    for (auto _ : state) {
+        BenchSerialConnection connection;
+        for (qsizetype offset = 0; offset < stream.size(); offset += chunkSize) {
+            connection.processIncomingData(QByteArrayView(stream).sliced(offset, qMin(chunkSize, stream.size() - offset)));
+        }
+        benchmark::DoNotOptimize(connection.frameCount(quint8(PushCode::LogRxData)));
+    }
+    state.SetBytesProcessed(state.iterations() * stream.size());
+}
+BENCHMARK(BM_SerialMixedStream)->Arg(64)->Arg(4096)->Arg(64 * 1024)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,24 @@
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <benchmark/benchmark.h>
+
+int main(int argc, char **argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    // Gives the main thread an event dispatcher (QTimer) and keeps storage
+    // benchmarks out of the real application data
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("QMeshCoreBenchmarks"));
+    QStandardPaths::setTestModeEnabled(true);
+
+    // Malformed-frame benchmarks would otherwise time the warning output
+    qInstallMessageHandler([](QtMsgType, const QMessageLogContext &, const QString &) {});
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
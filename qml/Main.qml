@@ -39,15 +39,12 @@ ApplicationWindow {
         }
         function onConnectedChanged() {
             if (device.connected) {
-                // Auto-sync messages and channels when connected
+                // Auto-sync contacts, messages and channels when connected
+                device.requestContacts()
                 device.syncAllMessages()
                 device.requestAllChannels()
             }
         }
-        function onMsgWaiting() {
-            // Auto-sync when new messages are waiting
-            device.syncAllMessages()
-        }
         function onContactMessageReceived(message) {
             messageNotification.text = "Message from " + message.senderPublicKeyPrefixHex + ": " + message.text
             messageNotification.open()
@@ -33,10 +33,17 @@ Pane {
                 onClicked: device.syncAllMessages()
             }
 
-            Item { Layout.fillWidth: true }
+            TextField {
+                id: searchField
+                Layout.fillWidth: true
+                placeholderText: "Search messages"
+                onTextChanged: device.messageSearch.query = text
+            }
 
             Label {
-                text: device.messages.count + " messages"
+                text: searchField.text.length > 0
+                      ? (device.messageSearch.searching ? "Searching..." : device.messageSearch.count + " matches")
+                      : device.messages.count + " messages"
                 opacity: 0.7
             }
         }
@@ -48,7 +55,7 @@ Pane {
             Layout.fillWidth: true
             Layout.fillHeight: true
             clip: true
-            model: device.messages
+            model: searchField.text.length > 0 ? device.messageSearch : device.messages
             verticalLayoutDirection: ListView.BottomToTop
 
             delegate: Rectangle {
@@ -129,7 +136,8 @@ Pane {
             // Empty state
             Label {
                 anchors.centerIn: parent
-                text: "No messages yet.\nMessages will appear here when received."
+                text: searchField.text.length > 0 ? "No matching messages."
+                      : "No messages yet.\nMessages will appear here when received."
                 horizontalAlignment: Text.AlignHCenter
                 opacity: 0.5
                 visible: messageListView.count === 0
@@ -8,13 +8,20 @@ Pane {
     id: root
     required property var device
 
+    // A recorded capture replaces the live log while it is open
+    readonly property bool viewingCapture: captureModel.path !== ""
+
+    RxCaptureModel {
+        id: captureModel
+    }
+
     ColumnLayout {
         anchors.fill: parent
         spacing: 12
 
         // Not connected message
         Label {
-            visible: !device.connected
+            visible: !device.connected && !root.viewingCapture
             Layout.fillWidth: true
             text: "Connect to a MeshCore device to view RX log."
             wrapMode: Text.WordWrap
@@ -25,7 +32,7 @@ Pane {
 
         // Toolbar
         RowLayout {
-            visible: device.connected
+            visible: device.connected && !root.viewingCapture
             Layout.fillWidth: true
             spacing: 8
 
@@ -36,8 +43,24 @@ Pane {
                 onToggled: device.rxLog.enabled = checked
             }
 
+            Switch {
+                id: groupSwitch
+                text: "Group Repeats"
+                enabled: device.rxLog.enabled
+                ToolTip.visible: hovered
+                ToolTip.text: "Show each flooded packet once, with the paths it was heard on"
+            }
+
             Item { Layout.fillWidth: true }
 
+            Button {
+                text: device.rxCapturing ? "Stop Recording" : "Record"
+                icon.name: device.rxCapturing ? "media-playback-stop" : "media-record"
+                ToolTip.visible: hovered && device.rxCapturing
+                ToolTip.text: device.rxCapturePath
+                onClicked: device.rxCapturing ? device.stopRxCapture() : device.startRxCapture()
+            }
+
             Button {
                 text: "Clear"
                 icon.name: "edit-clear"
@@ -51,9 +74,54 @@ Pane {
             }
         }
 
+        // Recorded captures
+        RowLayout {
+            Layout.fillWidth: true
+            spacing: 8
+
+            ComboBox {
+                id: captureCombo
+                Layout.fillWidth: true
+                enabled: !root.viewingCapture
+                displayText: root.viewingCapture ? captureModel.path
+                                                 : (count > 0 ? currentText : "No recorded captures")
+                onActivated: captureModel.path = currentText
+                Component.onCompleted: model = captureModel.availableCaptures()
+                onPressedChanged: {
+                    if (pressed) {
+                        model = captureModel.availableCaptures()
+                    }
+                }
+            }
+
+            Button {
+                text: root.viewingCapture ? "Close" : "Open"
+                enabled: root.viewingCapture || captureCombo.count > 0
+                onClicked: captureModel.path = root.viewingCapture ? "" : captureCombo.currentText
+            }
+
+            TextField {
+                id: seekField
+                visible: root.viewingCapture
+                placeholderText: "yyyy-MM-dd HH:mm:ss"
+                onAccepted: {
+                    const time = Date.fromLocaleString(Qt.locale(), text, "yyyy-MM-dd HH:mm:ss")
+                    if (!isNaN(time.getTime())) {
+                        rxLogListView.positionViewAtIndex(captureModel.rowAtTime(time), ListView.Beginning)
+                    }
+                }
+            }
+
+            Label {
+                visible: root.viewingCapture
+                text: captureModel.errorString !== "" ? captureModel.errorString : captureModel.count + " entries"
+                opacity: 0.7
+            }
+        }
+
         // Hint when logging is disabled
         Label {
-            visible: device.connected && !device.rxLog.enabled
+            visible: device.connected && !device.rxLog.enabled && !root.viewingCapture
             Layout.fillWidth: true
             text: "Enable RX logging to see raw received packets.\nNote: This may generate a lot of data on busy networks."
             wrapMode: Text.WordWrap
@@ -65,15 +133,16 @@ Pane {
         // RX Log list
         ListView {
             id: rxLogListView
-            visible: device.connected && device.rxLog.enabled
+            visible: root.viewingCapture || (device.connected && device.rxLog.enabled)
             Layout.fillWidth: true
             Layout.fillHeight: true
             clip: true
-            model: device.rxLog
+            model: root.viewingCapture ? captureModel
+                                       : (groupSwitch.checked ? device.rxLog.groups : device.rxLog)
 
             // Auto-scroll to bottom when new entries arrive
             onCountChanged: {
-                if (autoScrollCheck.checked && count > 0) {
+                if (!root.viewingCapture && autoScrollCheck.checked && count > 0) {
                     positionViewAtEnd()
                 }
             }
@@ -81,10 +150,15 @@ Pane {
             ScrollBar.vertical: ScrollBar { }
 
             delegate: ItemDelegate {
+                id: entryDelegate
                 width: ListView.view.width
                 height: contentColumn.implicitHeight + 16
                 padding: 8
 
+                // Only provided by the grouped view
+                readonly property int groupSize: model.sightingCount ?? 1
+                readonly property var groupSightings: model.sightings ?? []
+
                 background: Rectangle {
                     color: index % 2 === 0 ? "transparent" : 
                            (Material.theme === Material.Dark ? Qt.rgba(1, 1, 1, 0.03) : Qt.rgba(0, 0, 0, 0.03))
@@ -161,6 +235,26 @@ Pane {
                                    (model.hopCount <= 4 ? Material.color(Material.Orange) : Material.color(Material.Red))
                         }
 
+                        // Repeats of a flooded packet
+                        Label {
+                            visible: entryDelegate.groupSize > 1
+                            text: "×" + model.sightingCount
+                            font.pixelSize: 11
+                            font.bold: true
+                            ToolTip.visible: hovered
+                            ToolTip.text: "Heard " + model.sightingCount + " times, best SNR "
+                                          + (model.bestSnr ?? 0).toFixed(1) + ", best RSSI " + model.bestRssi
+                        }
+
+                        Label {
+                            visible: model.sighting > 0
+                            text: "repeat #" + model.sighting
+                            font.pixelSize: 11
+                            opacity: 0.6
+                            ToolTip.visible: hovered
+                            ToolTip.text: "Packet " + model.packetHash + " was already received"
+                        }
+
                         Label {
                             text: model.timestampString
                             font.family: "monospace"
@@ -263,6 +357,23 @@ Pane {
                         Item { Layout.fillWidth: true }
                     }
 
+                    // One line per path a grouped packet was heard on
+                    Repeater {
+                        model: entryDelegate.groupSize > 1 ? entryDelegate.groupSightings : []
+
+                        Label {
+                            required property var modelData
+                            Layout.fillWidth: true
+                            text: "+" + modelData.delayMs + " ms  SNR " + modelData.snr.toFixed(1)
+                                  + "  RSSI " + modelData.rssi
+                                  + (modelData.pathHex !== "" ? "  via " + modelData.pathHex : "  direct")
+                            font.family: "monospace"
+                            font.pixelSize: 10
+                            opacity: 0.7
+                            elide: Text.ElideRight
+                        }
+                    }
+
                     // Raw data hex display
                     Label {
                         Layout.fillWidth: true
@@ -279,7 +390,7 @@ Pane {
 
             // Empty state
             Label {
-                visible: device.rxLog.enabled && device.rxLog.count === 0
+                visible: !root.viewingCapture && device.rxLog.enabled && device.rxLog.count === 0
                 anchors.centerIn: parent
                 text: "Waiting for packets..."
                 opacity: 0.6
@@ -288,7 +399,7 @@ Pane {
 
         // Footer with auto-scroll option
         RowLayout {
-            visible: device.connected && device.rxLog.enabled
+            visible: device.connected && device.rxLog.enabled && !root.viewingCapture
             Layout.fillWidth: true
 
             CheckBox {
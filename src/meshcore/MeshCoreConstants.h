@@ -163,12 +163,12 @@ namespace PacketHeader {
     inline constexpr quint8 VerMask = 0x03;
 }
 
-// Route types
+// Route types; the transport variants carry two 16-bit transport codes before the path
 enum class RouteType : quint8 {
-    Reserved1 = 0x00,
+    TransportFlood = 0x00,
     Flood = 0x01,
     Direct = 0x02,
-    Reserved2 = 0x03
+    TransportDirect = 0x03
 };
 Q_ENUM_NS(RouteType)
 
@@ -184,6 +184,8 @@ enum class PayloadType : quint8 {
     AnonReq = 0x07,
     Path = 0x08,
     Trace = 0x09,
+    Multipart = 0x0A,
+    Control = 0x0B,
     RawCustom = 0x0F
 };
 Q_ENUM_NS(PayloadType)
@@ -194,6 +196,7 @@ namespace AdvertFlags {
     inline constexpr quint8 BatteryMask = 0x20;
     inline constexpr quint8 TemperatureMask = 0x40;
     inline constexpr quint8 NameMask = 0x80;
+    inline constexpr quint8 TypeMask = 0x0F;
 }
 
 // Connection type for MeshCoreDevice
@@ -5,9 +5,11 @@
 #include "connection/DBusBleConnection.h"
 #endif
 #include "connection/SerialConnection.h"
+#include "storage/ContactCache.h"
 #include <QDateTime>
 #include <QDebug>
 #include <QRandomGenerator>
+#include <algorithm>
 
 namespace MeshCore {
 
@@ -24,6 +26,17 @@ MeshCoreDevice::MeshCoreDevice(QObject *parent)
             this, &MeshCoreDevice::onBleScanFinished);
     connect(m_bleDiscoveryAgent.get(), &QBluetoothDeviceDiscoveryAgent::errorOccurred,
             this, &MeshCoreDevice::onBleScanError);
+
+    connect(&m_modelDeltas, &ModelDeltaQueue::deltaReady,
+            this, &MeshCoreDevice::modelDeltaReady);
+
+    // Captures reach the disk within a second even when no packets arrive
+    m_rxCaptureFlushTimer.setInterval(RxCaptureWriter::FlushIntervalMs);
+    connect(&m_rxCaptureFlushTimer, &QTimer::timeout, this, [this]() {
+        if (m_rxCapture) {
+            m_rxCapture->flush();
+        }
+    });
 }
 
 MeshCoreDevice::~MeshCoreDevice()
@@ -87,6 +100,8 @@ void MeshCoreDevice::setupConnectionSignals()
             this, &MeshCoreDevice::onNoMoreMessages);
     connect(m_connection.get(), &MeshCoreConnection::exportContactReceived,
             this, &MeshCoreDevice::onExportContactReceived);
+    connect(m_connection->commandPipeline(), &CommandPipeline::commandFinished,
+            this, &MeshCoreDevice::onCommandFinished);
 
     // Push notifications
     connect(m_connection.get(), &MeshCoreConnection::newAdvertPush,
@@ -110,10 +125,21 @@ void MeshCoreDevice::setupConnectionSignals()
 void MeshCoreDevice::cleanupConnection()
 {
     if (m_connection) {
+        m_connection->commandPipeline()->disconnect(this);
         m_connection->disconnect();
         m_connection.reset();
     }
 
+    m_queryingChannels = false;
+    m_channelQueries.clear();
+    m_syncingMessages = false;
+    m_messageSyncQueries.clear();
+    m_contactsSyncing = false;
+    m_contactSyncPending = false;
+    m_stagedContacts.clear();
+    m_contactCacheKey.clear();
+    m_contactWatermark = 0;
+
     m_connectionType = ConnectionType::None;
     Q_EMIT connectionTypeChanged();
 
@@ -121,8 +147,8 @@ void MeshCoreDevice::cleanupConnection()
     m_selfInfo = SelfInfo();
     m_deviceInfo = DeviceInfo();
     m_batteryMilliVolts = 0;
-    m_contactModel.clear();
-    m_channelModel.clear();
+    m_contacts.clear();
+    m_contactRows.clear();
 
     Q_EMIT selfInfoChanged();
     Q_EMIT deviceInfoChanged();
@@ -323,6 +349,14 @@ void MeshCoreDevice::onSelfInfoReceived(const SelfInfo &selfInfo)
 {
     m_selfInfo = selfInfo;
     Q_EMIT selfInfoChanged();
+
+    if (selfInfo.publicKey() != m_contactCacheKey) {
+        loadContactCache(selfInfo.publicKey());
+    }
+    if (m_contactSyncPending) {
+        m_contactSyncPending = false;
+        startContactSync();
+    }
 }
 
 void MeshCoreDevice::onDeviceInfoReceived(const DeviceInfo &deviceInfo)
@@ -333,44 +367,135 @@ void MeshCoreDevice::onDeviceInfoReceived(const DeviceInfo &deviceInfo)
 
 void MeshCoreDevice::onContactsStarted(quint32 count)
 {
-    Q_UNUSED(count)
     if (!m_contactsSyncing) {
-        m_contactModel.clear();
-        Q_EMIT contactsCleared();
+        m_contactSyncIsDelta = false;
+    }
+    // A delta sync merges into the cached table instead of replacing it
+    if (!m_contactSyncIsDelta) {
+        clearContacts();
     }
     m_contactsSyncing = true;
+
+    // Contacts are staged until EndOfContacts, with a partial commit every
+    // ContactCommitIntervalMs so large tables still show progress
+    m_stagedContacts.clear();
+    m_stagedContacts.reserve(qMin<quint32>(count, MaxStagedContactsReserve));
+    m_contactCommitTimer.start();
 }
 
 void MeshCoreDevice::onContactReceived(const Contact &contact)
 {
-    m_contactModel.addContact(contact);
-    Q_EMIT contactReceived(contact);
+    if (!m_contactsSyncing) {
+        storeContacts({contact});
+        Q_EMIT contactReceived(contact);
+        return;
+    }
+
+    m_stagedContacts.append(contact);
+    if (m_contactCommitTimer.hasExpired(ContactCommitIntervalMs)) {
+        commitStagedContacts();
+    }
+}
+
+void MeshCoreDevice::commitStagedContacts()
+{
+    m_contactCommitTimer.restart();
+    if (m_stagedContacts.isEmpty()) {
+        return;
+    }
+
+    storeContacts(std::exchange(m_stagedContacts, {}));
 }
 
 void MeshCoreDevice::onContactsEnded(quint32 mostRecentLastMod)
 {
-    Q_UNUSED(mostRecentLastMod)
+    commitStagedContacts();
     m_contactsSyncing = false;
+    m_contactSyncIsDelta = false;
+
+    // mostRecentLastMod is 0 when a delta sync found nothing new
+    m_contactWatermark = qMax(m_contactWatermark, mostRecentLastMod);
+    if (!m_contactCacheKey.isEmpty()) {
+        ContactCache::save(m_contactCacheKey, m_contacts, m_contactWatermark);
+    }
+}
+
+void MeshCoreDevice::storeContacts(const QList<Contact> &contacts)
+{
+    for (const Contact &contact : contacts) {
+        auto it = m_contactRows.constFind(contact.publicKey());
+        if (it != m_contactRows.constEnd()) {
+            m_contacts[*it] = contact;
+        } else {
+            m_contactRows.insert(contact.publicKey(), m_contacts.size());
+            m_contacts.append(contact);
+        }
+    }
+    m_modelDeltas.upsertContacts(contacts);
+}
+
+void MeshCoreDevice::eraseContact(const QByteArray &publicKey)
+{
+    qsizetype row = m_contactRows.value(publicKey, -1);
+    if (row < 0) {
+        return;
+    }
+
+    m_contacts.removeAt(row);
+    m_contactRows.remove(publicKey);
+    for (qsizetype i = row; i < m_contacts.size(); ++i) {
+        m_contactRows[m_contacts.at(i).publicKey()] = i;
+    }
+    m_modelDeltas.removeContact(publicKey);
+}
+
+void MeshCoreDevice::clearContacts()
+{
+    m_contacts.clear();
+    m_contactRows.clear();
+    m_modelDeltas.clearContacts();
+}
+
+void MeshCoreDevice::loadContactCache(const QByteArray &devicePublicKey)
+{
+    m_contactCacheKey = devicePublicKey;
+    ContactCache::Snapshot snapshot = ContactCache::load(devicePublicKey);
+    m_contactWatermark = snapshot.watermark;
+    if (snapshot.contacts.isEmpty()) {
+        m_contactWatermark = 0;
+        return;
+    }
+
+    qDebug() << "Loaded" << snapshot.contacts.size() << "cached contacts, watermark" << m_contactWatermark;
+    clearContacts();
+    storeContacts(snapshot.contacts);
+}
+
+void MeshCoreDevice::startContactSync()
+{
+    if (!m_connection) {
+        return;
+    }
+
+    m_contactsSyncing = true;
+    m_contactSyncIsDelta = m_contactWatermark != 0;
+    if (m_contactSyncIsDelta) {
+        m_connection->sendCommandGetContacts(m_contactWatermark);
+    } else {
+        clearContacts();
+        m_connection->sendCommandGetContacts();
+    }
 }
 
 void MeshCoreDevice::onChannelInfoReceived(const ChannelInfo &channelInfo)
 {
     // Only add non-empty channels to the model
     if (!channelInfo.isEmpty()) {
-        m_channelModel.updateChannel(channelInfo);
-        Q_EMIT channelInfoReceived(channelInfo);
-    }
-
-    // If we're querying all channels, continue up to max 8 channels
-    if (m_queryingChannels) {
-        m_channelQueryIndex++;
-        // MeshCore typically supports up to 8 channels (0-7)
-        if (m_channelQueryIndex < 8 && m_connection) {
-            m_connection->sendCommandGetChannel(m_channelQueryIndex);
-        } else {
-            m_queryingChannels = false;
-            qDebug() << "Channel query complete, found" << m_channelModel.count() << "channels";
+        if (m_queryingChannels) {
+            ++m_enumeratedChannelCount;
         }
+        m_modelDeltas.upsertChannel(channelInfo);
+        Q_EMIT channelInfoReceived(channelInfo);
     }
 }
 
@@ -388,30 +513,34 @@ void MeshCoreDevice::onSentResponse(qint8 result, quint32 expectedAckCrc, quint3
 
 void MeshCoreDevice::onContactMsgReceived(const ContactMessage &message)
 {
-    m_messageModel.addContactMessage(message);
+    m_modelDeltas.addMessage(message);
     Q_EMIT contactMessageReceived(message);
 
-    // If syncing messages, continue
-    if (m_syncingMessages && m_connection) {
-        m_connection->sendCommandSyncNextMessage();
+    if (!m_messageSyncQueries.isEmpty()) {
+        ++m_syncedMessageCount;
     }
 }
 
 void MeshCoreDevice::onChannelMsgReceived(const ChannelMessage &message)
 {
-    m_messageModel.addChannelMessage(message);
+    m_modelDeltas.addMessage(message);
     Q_EMIT channelMessageReceived(message);
 
-    // If syncing messages, continue
-    if (m_syncingMessages && m_connection) {
-        m_connection->sendCommandSyncNextMessage();
+    if (!m_messageSyncQueries.isEmpty()) {
+        ++m_syncedMessageCount;
     }
 }
 
 void MeshCoreDevice::onNoMoreMessages()
 {
-    m_syncingMessages = false;
-    Q_EMIT noMoreMessages();
+    // Requests still in the read-ahead window answer NoMoreMessages as well;
+    // only the first one of a sync is reported
+    if (m_syncingMessages) {
+        m_syncingMessages = false;
+        Q_EMIT noMoreMessages();
+    } else if (m_messageSyncQueries.isEmpty()) {
+        Q_EMIT noMoreMessages();
+    }
 }
 
 void MeshCoreDevice::onExportContactReceived(const QByteArray &advertPacketBytes)
@@ -419,10 +548,76 @@ void MeshCoreDevice::onExportContactReceived(const QByteArray &advertPacketBytes
     Q_EMIT exportedContact(advertPacketBytes);
 }
 
+void MeshCoreDevice::onCommandFinished(quint32 id, CommandCode command,
+                                       CommandPipeline::Result result, qint64 latencyMs)
+{
+    Q_UNUSED(command)
+    Q_UNUSED(latencyMs)
+
+    if (m_messageSyncQueries.remove(id)) {
+        messageSyncQueryFinished(result);
+        return;
+    }
+
+    auto it = m_channelQueries.find(id);
+    if (it != m_channelQueries.end()) {
+        m_channelQueries.erase(it);
+        channelQueryFinished(result);
+    }
+}
+
+void MeshCoreDevice::messageSyncQueryFinished(CommandPipeline::Result result)
+{
+    // An error or timeout ends the sync like NoMoreMessages does
+    if (result != CommandPipeline::Result::Completed) {
+        m_syncingMessages = false;
+    }
+
+    // Keep the read-ahead window full until the device runs dry
+    if (m_syncingMessages && m_connection) {
+        requestNextMessage();
+        return;
+    }
+
+    if (!m_messageSyncQueries.isEmpty()) {
+        return;
+    }
+
+    qint64 elapsedMs = m_messageSyncTimer.elapsed();
+    double messagesPerSecond = elapsedMs > 0 ? m_syncedMessageCount * 1000.0 / elapsedMs : 0.0;
+    qDebug() << "Message sync complete," << m_syncedMessageCount << "messages in" << elapsedMs
+             << "ms (" << messagesPerSecond << "msg/s)";
+    Q_EMIT messageSyncFinished(m_syncedMessageCount, messagesPerSecond);
+}
+
+void MeshCoreDevice::channelQueryFinished(CommandPipeline::Result result)
+{
+    // Channel data itself arrives through onChannelInfoReceived, keyed by its
+    // idx field; here we only track which probes are still outstanding.
+    // Firmware answers indices past its last channel with an error.
+    if (result != CommandPipeline::Result::Completed) {
+        m_channelProbeExhausted = true;
+    }
+
+    if (!m_channelQueries.isEmpty()) {
+        return;
+    }
+
+    if (!m_channelProbeExhausted && m_nextChannelProbe < MaxChannels && m_connection) {
+        queryChannelBatch();
+        return;
+    }
+
+    m_queryingChannels = false;
+    qint64 elapsedMs = m_channelQueryTimer.elapsed();
+    qDebug() << "Channel query complete, found" << m_enumeratedChannelCount << "channels in" << elapsedMs << "ms";
+    Q_EMIT channelsEnumerated(m_enumeratedChannelCount, elapsedMs);
+}
+
 // Push notification handlers
 void MeshCoreDevice::onNewAdvertPush(const Contact &contact)
 {
-    m_contactModel.updateContact(contact);
+    storeContacts({contact});
     Q_EMIT newAdvertReceived(contact);
 }
 
@@ -439,6 +634,10 @@ void MeshCoreDevice::onSendConfirmedPush(quint32 ackCode, quint32 roundTrip)
 void MeshCoreDevice::onMsgWaitingPush()
 {
     Q_EMIT msgWaiting();
+
+    if (m_autoSyncMessages) {
+        syncAllMessages();
+    }
 }
 
 void MeshCoreDevice::onStatusResponsePush(const QByteArray &pubKeyPrefix, const RepeaterStats &stats)
@@ -468,11 +667,17 @@ void MeshCoreDevice::requestContacts()
 {
     qDebug() << "requestContacts called, connection:" << (m_connection ? "valid" : "null") 
              << "connected:" << (m_connection ? m_connection->isConnected() : false);
-    if (m_connection) {
-        m_contactsSyncing = true;
-        m_contactModel.clear();
-        m_connection->sendCommandGetContacts();
+    if (!m_connection) {
+        return;
+    }
+
+    // The cache is keyed by the device public key, which arrives with SelfInfo
+    if (m_selfInfo.publicKey().isEmpty()) {
+        m_contactSyncPending = true;
+        m_connection->sendCommandAppStart();
+        return;
     }
+    startContactSync();
 }
 
 void MeshCoreDevice::requestDeviceTime()
@@ -508,10 +713,24 @@ void MeshCoreDevice::requestAllChannels()
 {
     if (m_connection) {
         m_queryingChannels = true;
-        m_channelQueryIndex = 0;
-        m_channelModel.clear();
-        Q_EMIT channelsCleared();
-        m_connection->sendCommandGetChannel(0);
+        m_nextChannelProbe = 0;
+        m_channelProbeExhausted = false;
+        m_channelQueries.clear();
+        m_enumeratedChannelCount = 0;
+        m_modelDeltas.clearChannels();
+        m_channelQueryTimer.start();
+        queryChannelBatch();
+    }
+}
+
+void MeshCoreDevice::queryChannelBatch()
+{
+    // Queue the whole batch at once; the command pipeline keeps as many in
+    // flight as the link allows instead of one round trip per channel
+    int end = qMin(m_nextChannelProbe + ChannelProbeBatch, MaxChannels);
+    for (; m_nextChannelProbe < end; ++m_nextChannelProbe) {
+        quint8 index = static_cast<quint8>(m_nextChannelProbe);
+        m_channelQueries.insert(m_connection->sendCommandGetChannel(index), index);
     }
 }
 
@@ -531,12 +750,14 @@ void MeshCoreDevice::sendContactMessage(const QByteArray &contactPublicKey, cons
 
 void MeshCoreDevice::sendTextMessageToName(const QString &contactName, const QString &text)
 {
-    Contact contact = m_contactModel.findByName(contactName);
-    if (contact.publicKey().isEmpty()) {
+    auto it = std::find_if(m_contacts.cbegin(), m_contacts.cend(), [&contactName](const Contact &contact) {
+        return contact.name() == contactName;
+    });
+    if (it == m_contacts.cend()) {
         setErrorString(QStringLiteral("Contact not found: %1").arg(contactName));
         return;
     }
-    sendTextMessage(contact.publicKey(), text);
+    sendTextMessage(it->publicKey(), text);
 }
 
 void MeshCoreDevice::sendChannelMessage(int channelIndex, const QString &text)
@@ -556,10 +777,26 @@ void MeshCoreDevice::syncNextMessage()
 
 void MeshCoreDevice::syncAllMessages()
 {
-    if (m_connection) {
-        m_syncingMessages = true;
-        m_connection->sendCommandSyncNextMessage();
+    if (!m_connection || m_syncingMessages) {
+        return;
     }
+
+    m_syncingMessages = true;
+    m_syncedMessageCount = 0;
+    m_messageSyncTimer.start();
+    while (m_messageSyncQueries.size() < MessageSyncWindow) {
+        requestNextMessage();
+    }
+}
+
+void MeshCoreDevice::setAutoSyncMessages(bool enabled)
+{
+    m_autoSyncMessages = enabled;
+}
+
+void MeshCoreDevice::requestNextMessage()
+{
+    m_messageSyncQueries.insert(m_connection->sendCommandSyncNextMessage());
 }
 
 // Advert
@@ -587,8 +824,8 @@ void MeshCoreDevice::setAdvertName(const QString &name)
 void MeshCoreDevice::setAdvertLocation(double latitude, double longitude)
 {
     if (m_connection) {
-        qint32 lat = static_cast<qint32>(latitude * 1e7);
-        qint32 lon = static_cast<qint32>(longitude * 1e7);
+        qint32 lat = static_cast<qint32>(latitude * 1e6);
+        qint32 lon = static_cast<qint32>(longitude * 1e6);
         m_connection->sendCommandSetAdvertLatLon(lat, lon);
     }
 }
@@ -613,7 +850,10 @@ void MeshCoreDevice::removeContact(const QByteArray &publicKey)
 {
     if (m_connection) {
         m_connection->sendCommandRemoveContact(publicKey);
-        m_contactModel.removeContact(publicKey);
+        eraseContact(publicKey);
+        if (!m_contactCacheKey.isEmpty() && m_contactWatermark != 0) {
+            ContactCache::save(m_contactCacheKey, m_contacts, m_contactWatermark);
+        }
     }
 }
 
@@ -690,6 +930,34 @@ void MeshCoreDevice::reboot()
     }
 }
 
+void MeshCoreDevice::setRxLogEnabled(bool enabled)
+{
+    m_rxLogEnabled = enabled;
+}
+
+void MeshCoreDevice::startRxCapture(const QString &path)
+{
+    stopRxCapture();
+
+    auto capture = std::make_unique<RxCaptureWriter>();
+    if (!capture->open(path.isEmpty() ? RxCaptureWriter::defaultPath() : path)) {
+        return;
+    }
+    m_rxCapture = std::move(capture);
+    m_rxCaptureFlushTimer.start();
+    Q_EMIT rxCaptureChanged(m_rxCapture->path());
+}
+
+void MeshCoreDevice::stopRxCapture()
+{
+    if (!m_rxCapture) {
+        return;
+    }
+    m_rxCaptureFlushTimer.stop();
+    m_rxCapture.reset();  // Closing writes the trailer
+    Q_EMIT rxCaptureChanged(QString());
+}
+
 void MeshCoreDevice::setManualAddContacts(bool manual)
 {
     if (m_connection) {
@@ -700,9 +968,14 @@ void MeshCoreDevice::setManualAddContacts(bool manual)
 // RX Log push handler
 void MeshCoreDevice::onLogRxDataPush(double snr, qint8 rssi, const QByteArray &rawData)
 {
-    // Add to the RX log model (which will check if logging is enabled)
-    m_rxLogModel.addEntry(snr, rssi, rawData);
-    Q_EMIT rxLogEntry(snr, rssi, rawData);
+    if (m_rxCapture) {
+        m_rxCapture->append(QDateTime::currentMSecsSinceEpoch(), snr, rssi, rawData);
+    }
+
+    // Stored raw; the GUI model parses entries when they are displayed
+    if (m_rxLogEnabled) {
+        m_modelDeltas.addRxLogEntry(RxLogEntry(snr, rssi, rawData));
+    }
 }
 
 } // namespace MeshCore
@@ -5,6 +5,10 @@
 #include <QBluetoothDeviceDiscoveryAgent>
 #include <QBluetoothDeviceInfo>
 #include <QSerialPortInfo>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
 #include <QtQml/qqmlregistration.h>
 #include <memory>
 
@@ -18,10 +22,10 @@
 #include "types/RepeaterStats.h"
 #include "types/TraceData.h"
 #include "types/TelemetryData.h"
-#include "models/ContactModel.h"
-#include "models/ChannelModel.h"
-#include "models/MessageModel.h"
-#include "models/RxLogModel.h"
+#include "types/RxLogEntry.h"
+#include "connection/CommandPipeline.h"
+#include "ModelDelta.h"
+#include "storage/RxCapture.h"
 
 namespace MeshCore {
 
@@ -35,6 +39,11 @@ class SerialConnection;
  * This class provides a high-level, QML-friendly API for connecting to
  * and communicating with MeshCore devices over BLE or Serial (USB).
  *
+ * It owns no list models. Changes to contacts, channels, messages and the
+ * RX log are published in ModelDelta batches (modelDeltaReady), and the
+ * models built from them live with MeshCoreDeviceController on the GUI
+ * thread.
+ *
  * Example QML usage:
  * @code
  * MeshCoreDevice {
@@ -92,12 +101,6 @@ private:
     Q_PROPERTY(quint16 batteryMilliVolts READ batteryMilliVolts NOTIFY batteryMilliVoltsChanged)
     Q_PROPERTY(double batteryVolts READ batteryVolts NOTIFY batteryMilliVoltsChanged)
 
-    // Models (for QML ListView binding)
-    Q_PROPERTY(ContactModel* contacts READ contacts CONSTANT)
-    Q_PROPERTY(ChannelModel* channels READ channels CONSTANT)
-    Q_PROPERTY(MessageModel* messages READ messages CONSTANT)
-    Q_PROPERTY(RxLogModel* rxLog READ rxLog CONSTANT)
-
     // BLE scanning
     Q_PROPERTY(bool scanning READ isScanning NOTIFY scanningChanged)
     Q_PROPERTY(QVariantList discoveredBleDevices READ discoveredBleDevices NOTIFY discoveredBleDevicesChanged)
@@ -119,12 +122,6 @@ public:
     [[nodiscard]] quint16 batteryMilliVolts() const { return m_batteryMilliVolts; }
     [[nodiscard]] double batteryVolts() const { return m_batteryMilliVolts / 1000.0; }
 
-    // Model getters
-    [[nodiscard]] ContactModel *contacts() { return &m_contactModel; }
-    [[nodiscard]] ChannelModel *channels() { return &m_channelModel; }
-    [[nodiscard]] MessageModel *messages() { return &m_messageModel; }
-    [[nodiscard]] RxLogModel *rxLog() { return &m_rxLogModel; }
-
     // BLE scanning
     [[nodiscard]] bool isScanning() const { return m_scanning; }
     [[nodiscard]] QVariantList discoveredBleDevices() const { return m_discoveredBleDevices; }
@@ -163,6 +160,7 @@ public Q_SLOTS:
     void sendChannelMessage(int channelIndex, const QString &text);
     void syncNextMessage();
     void syncAllMessages();
+    void setAutoSyncMessages(bool enabled);  // Sync automatically on MsgWaiting (default on)
 
     // Advert
     void sendFloodAdvert();
@@ -194,6 +192,13 @@ public Q_SLOTS:
     // Low-level access
     void setManualAddContacts(bool manual);
 
+    // RX log entries are only parsed and published while a log is shown
+    void setRxLogEnabled(bool enabled);
+
+    // Records every received packet to a capture file, independently of the RX log
+    void startRxCapture(const QString &path = QString());
+    void stopRxCapture();
+
 Q_SIGNALS:
     // Property signals
     void connectionStateChanged();
@@ -223,11 +228,12 @@ Q_SIGNALS:
     void exportedContact(const QByteArray &advertPacketBytes);
     void msgWaiting();
     void noMoreMessages();
+    void channelsEnumerated(int channelCount, qint64 elapsedMs);
+    void messageSyncFinished(int messageCount, double messagesPerSecond);
+    void rxCaptureChanged(const QString &path);  // Empty once stopped
 
-    // Model sync signals (for controller)
-    void contactsCleared();
-    void channelsCleared();
-    void rxLogEntry(double snr, qint8 rssi, const QByteArray &rawData);
+    // Model changes, batched per display frame (for controller)
+    void modelDeltaReady(const MeshCore::ModelDelta &delta);
 
 private Q_SLOTS:
     // BLE discovery
@@ -253,6 +259,8 @@ private Q_SLOTS:
     void onChannelMsgReceived(const ChannelMessage &message);
     void onNoMoreMessages();
     void onExportContactReceived(const QByteArray &advertPacketBytes);
+    void onCommandFinished(quint32 id, MeshCore::CommandCode command,
+                           MeshCore::CommandPipeline::Result result, qint64 latencyMs);
 
     // Push notifications
     void onNewAdvertPush(const Contact &contact);
@@ -269,6 +277,16 @@ private:
     void setErrorString(const QString &error);
     void setupConnectionSignals();
     void cleanupConnection();
+    void queryChannelBatch();
+    void channelQueryFinished(CommandPipeline::Result result);
+    void requestNextMessage();
+    void messageSyncQueryFinished(CommandPipeline::Result result);
+    void loadContactCache(const QByteArray &devicePublicKey);
+    void startContactSync();
+    void commitStagedContacts();
+    void storeContacts(const QList<Contact> &contacts);
+    void eraseContact(const QByteArray &publicKey);
+    void clearContacts();
 
     // Connection
     std::unique_ptr<MeshCoreConnection> m_connection;
@@ -281,11 +299,13 @@ private:
     DeviceInfo m_deviceInfo;
     quint16 m_batteryMilliVolts = 0;
 
-    // Models
-    ContactModel m_contactModel;
-    ChannelModel m_channelModel;
-    MessageModel m_messageModel;
-    RxLogModel m_rxLogModel;
+    // Contact table, needed for the contact cache and name lookups
+    QList<Contact> m_contacts;
+    QHash<QByteArray, qsizetype> m_contactRows;  // Public key -> index into m_contacts
+    bool m_rxLogEnabled = false;
+    std::unique_ptr<RxCaptureWriter> m_rxCapture;
+    QTimer m_rxCaptureFlushTimer{this};
+    ModelDeltaQueue m_modelDeltas{this};
 
     // BLE scanning
     std::unique_ptr<QBluetoothDeviceDiscoveryAgent> m_bleDiscoveryAgent;
@@ -295,9 +315,37 @@ private:
 
     // Internal state
     bool m_contactsSyncing = false;
-    int m_channelQueryIndex = 0;
     bool m_queryingChannels = false;
+
+    // Contact sync: once a table is cached for the device only contacts
+    // modified after the watermark are fetched and merged
+    QByteArray m_contactCacheKey;     // Device public key the model was loaded for
+    quint32 m_contactWatermark = 0;   // Most recent lastMod seen, 0 for a full sync
+    bool m_contactSyncIsDelta = false;
+    bool m_contactSyncPending = false;  // Waiting for SelfInfo to know the device key
+    static constexpr qint64 ContactCommitIntervalMs = 100;
+    static constexpr quint32 MaxStagedContactsReserve = 1024;
+    QList<Contact> m_stagedContacts;  // Received since the last commit to the model
+    QElapsedTimer m_contactCommitTimer;
+
+    // Channel enumeration: indices are probed in batches until the device
+    // answers an index with an error
+    static constexpr int ChannelProbeBatch = 8;
+    static constexpr int MaxChannels = 256;
+    int m_nextChannelProbe = 0;
+    bool m_channelProbeExhausted = false;
+    QHash<quint32, quint8> m_channelQueries;  // Command id -> channel index
+    int m_enumeratedChannelCount = 0;
+    QElapsedTimer m_channelQueryTimer;
+
+    // Message sync: a window of SyncNextMessage requests stays outstanding
+    // until the device answers NoMoreMessages
+    static constexpr int MessageSyncWindow = 3;
     bool m_syncingMessages = false;
+    bool m_autoSyncMessages = true;
+    QSet<quint32> m_messageSyncQueries;
+    int m_syncedMessageCount = 0;
+    QElapsedTimer m_messageSyncTimer;
 };
 
 } // namespace MeshCore
@@ -5,6 +5,8 @@ namespace MeshCore {
 
 MeshCoreDeviceController::MeshCoreDeviceController(QObject *parent)
     : QObject(parent)
+    , m_messageSearchModel(&m_messageModel)
+    , m_conversationListModel(&m_messageModel, &m_contactModel, &m_channelModel)
 {
     // Create device on worker thread
     m_device = new MeshCoreDevice(nullptr);  // No parent - will be moved to thread
@@ -21,6 +23,21 @@ MeshCoreDeviceController::MeshCoreDeviceController(QObject *parent)
     m_workerThread.start();
 
     qDebug() << "MeshCoreDeviceController: Worker thread started";
+
+    // Message search runs on its own thread, so indexing never blocks the UI
+    m_searchIndex = new MessageSearchIndex(nullptr);
+    m_searchIndex->moveToThread(&m_searchThread);
+    connect(&m_searchThread, &QThread::finished, m_searchIndex, &QObject::deleteLater);
+    connect(this, &MeshCoreDeviceController::doOpenSearchIndex,
+            m_searchIndex, &MessageSearchIndex::open);
+    connect(&m_messageModel, &MessageModel::messagesAppended,
+            m_searchIndex, &MessageSearchIndex::addMessages);
+    connect(&m_messageSearchModel, &MessageSearchModel::searchRequested,
+            m_searchIndex, &MessageSearchIndex::search);
+    connect(m_searchIndex, &MessageSearchIndex::searchFinished,
+            &m_messageSearchModel, &MessageSearchModel::setResults);
+    m_searchThread.setObjectName(QStringLiteral("MessageSearchIndex"));
+    m_searchThread.start();
 }
 
 MeshCoreDeviceController::~MeshCoreDeviceController()
@@ -29,6 +46,9 @@ MeshCoreDeviceController::~MeshCoreDeviceController()
     m_workerThread.quit();
     m_workerThread.wait();
     qDebug() << "MeshCoreDeviceController: Worker thread stopped";
+
+    m_searchThread.quit();
+    m_searchThread.wait();
 }
 
 void MeshCoreDeviceController::setupConnections()
@@ -112,6 +132,12 @@ void MeshCoreDeviceController::setupConnections()
             m_device, &MeshCoreDevice::reboot);
     connect(this, &MeshCoreDeviceController::doSetManualAddContacts,
             m_device, &MeshCoreDevice::setManualAddContacts);
+    connect(this, &MeshCoreDeviceController::doSetRxLogEnabled,
+            m_device, &MeshCoreDevice::setRxLogEnabled);
+    connect(this, &MeshCoreDeviceController::doStartRxCapture,
+            m_device, &MeshCoreDevice::startRxCapture);
+    connect(this, &MeshCoreDeviceController::doStopRxCapture,
+            m_device, &MeshCoreDevice::stopRxCapture);
 
     // === State change signals from device to controller ===
     connect(m_device, &MeshCoreDevice::connectionStateChanged,
@@ -128,6 +154,8 @@ void MeshCoreDeviceController::setupConnections()
             this, &MeshCoreDeviceController::onBatteryMilliVoltsChanged);
     connect(m_device, &MeshCoreDevice::scanningChanged,
             this, &MeshCoreDeviceController::onScanningChanged);
+    connect(m_device, &MeshCoreDevice::rxCaptureChanged,
+            this, &MeshCoreDeviceController::onRxCaptureChanged);
     connect(m_device, &MeshCoreDevice::discoveredBleDevicesChanged,
             this, &MeshCoreDeviceController::onDiscoveredBleDevicesChanged);
     connect(m_device, &MeshCoreDevice::availableSerialPortsChanged,
@@ -157,30 +185,12 @@ void MeshCoreDeviceController::setupConnections()
     connect(m_device, &MeshCoreDevice::exportedContact,
             this, &MeshCoreDeviceController::exportedContact);
 
-    // === Model updates - sync to local models ===
-    // Contact model updates (from contact sync and new adverts)
-    connect(m_device, &MeshCoreDevice::contactReceived,
-            this, &MeshCoreDeviceController::onContactReceived);
-    connect(m_device, &MeshCoreDevice::newAdvertReceived,
-            this, &MeshCoreDeviceController::onContactReceived);
-    connect(m_device, &MeshCoreDevice::contactsCleared,
-            this, &MeshCoreDeviceController::onContactsCleared);
-    
-    // Channel model updates
-    connect(m_device, &MeshCoreDevice::channelInfoReceived,
-            this, &MeshCoreDeviceController::onChannelReceived);
-    connect(m_device, &MeshCoreDevice::channelsCleared,
-            this, &MeshCoreDeviceController::onChannelsCleared);
-    
-    // Message updates
-    connect(m_device, &MeshCoreDevice::contactMessageReceived,
-            this, &MeshCoreDeviceController::onContactMessageReceived);
-    connect(m_device, &MeshCoreDevice::channelMessageReceived,
-            this, &MeshCoreDeviceController::onChannelMessageReceived);
-    
-    // RX Log updates
-    connect(m_device, &MeshCoreDevice::rxLogEntry,
-            this, &MeshCoreDeviceController::onRxLogEntry);
+    // === Model updates - applied in batches ===
+    connect(m_device, &MeshCoreDevice::modelDeltaReady,
+            this, &MeshCoreDeviceController::onModelDelta);
+    connect(&m_rxLogModel, &RxLogModel::enabledChanged, this, [this]() {
+        Q_EMIT doSetRxLogEnabled(m_rxLogModel.isEnabled());
+    });
 }
 
 // === Public slots - forward to worker via signals ===
@@ -232,7 +242,6 @@ void MeshCoreDeviceController::requestSelfInfo()
 
 void MeshCoreDeviceController::requestContacts()
 {
-    m_contactModel.clear();  // Clear local model
     Q_EMIT doRequestContacts();
 }
 
@@ -258,7 +267,6 @@ void MeshCoreDeviceController::requestChannel(int channelIndex)
 
 void MeshCoreDeviceController::requestAllChannels()
 {
-    m_channelModel.clear();  // Clear local model
     Q_EMIT doRequestAllChannels();
 }
 
@@ -324,7 +332,6 @@ void MeshCoreDeviceController::setRadioParams(quint32 freqHz, quint32 bwHz, int
 
 void MeshCoreDeviceController::removeContact(const QByteArray &publicKey)
 {
-    m_contactModel.removeContact(publicKey);  // Update local model
     Q_EMIT doRemoveContact(publicKey);
 }
 
@@ -383,6 +390,16 @@ void MeshCoreDeviceController::setManualAddContacts(bool manual)
     Q_EMIT doSetManualAddContacts(manual);
 }
 
+void MeshCoreDeviceController::startRxCapture(const QString &path)
+{
+    Q_EMIT doStartRxCapture(path);
+}
+
+void MeshCoreDeviceController::stopRxCapture()
+{
+    Q_EMIT doStopRxCapture();
+}
+
 QVariantList MeshCoreDeviceController::availableSerialPorts() const
 {
     // This needs to be fetched from device - for now return cached or query synchronously
@@ -424,6 +441,17 @@ void MeshCoreDeviceController::onErrorStringChanged()
 void MeshCoreDeviceController::onSelfInfoChanged()
 {
     m_selfInfo = m_device->selfInfo();
+
+    // Switch to the history of this identity once its key is known
+    QByteArray publicKey = m_selfInfo.publicKey();
+    if (!publicKey.isEmpty() && publicKey != m_messageStore.devicePublicKey()) {
+        m_messageModel.setStore(nullptr);
+        if (m_messageStore.open(publicKey)) {
+            m_messageModel.setStore(&m_messageStore);
+        }
+        Q_EMIT doOpenSearchIndex(publicKey);
+    }
+
     Q_EMIT selfInfoChanged();
 }
 
@@ -456,43 +484,45 @@ void MeshCoreDeviceController::onAvailableSerialPortsChanged()
     Q_EMIT availableSerialPortsChanged();
 }
 
-// === Model sync slots ===
-
-void MeshCoreDeviceController::onContactReceived(const Contact &contact)
+void MeshCoreDeviceController::onRxCaptureChanged(const QString &path)
 {
-    m_contactModel.updateContact(contact);
+    m_rxCapturePath = path;
+    Q_EMIT rxCaptureChanged();
 }
 
-void MeshCoreDeviceController::onContactsCleared()
-{
-    m_contactModel.clear();
-}
+// === Model sync slots ===
 
-void MeshCoreDeviceController::onChannelReceived(const ChannelInfo &channel)
+void MeshCoreDeviceController::onModelDelta(const ModelDelta &delta)
 {
-    m_channelModel.updateChannel(channel);
-}
+    if (delta.contactsCleared) {
+        m_contactModel.clear();
+    }
+    for (const QByteArray &publicKey : delta.removedContacts) {
+        m_contactModel.removeContact(publicKey);
+    }
+    m_contactModel.mergeContacts(delta.contacts);
 
-void MeshCoreDeviceController::onChannelsCleared()
-{
-    m_channelModel.clear();
-}
+    if (delta.channelsCleared) {
+        m_channelModel.clear();
+    }
+    for (const ChannelInfo &channel : delta.channels) {
+        m_channelModel.updateChannel(channel);
+    }
 
-void MeshCoreDeviceController::onContactMessageReceived(const ContactMessage &message)
-{
-    m_messageModel.addContactMessage(message);
-    Q_EMIT contactMessageReceived(message);
-}
+    m_messageModel.addMessages(delta.messages);
+    m_conversationListModel.addMessages(delta.messages);
+    m_rxLogModel.addEntries(delta.rxLogEntries);
 
-void MeshCoreDeviceController::onChannelMessageReceived(const ChannelMessage &message)
-{
-    m_messageModel.addChannelMessage(message);
-    Q_EMIT channelMessageReceived(message);
-}
+    m_modelDeltaStats.record(delta);
 
-void MeshCoreDeviceController::onRxLogEntry(double snr, qint8 rssi, const QByteArray &rawData)
-{
-    m_rxLogModel.addEntry(snr, rssi, rawData);
+    // Notify QML after the models hold the new messages
+    for (const Message &message : delta.messages) {
+        if (const auto *contactMessage = std::get_if<ContactMessage>(&message)) {
+            Q_EMIT contactMessageReceived(*contactMessage);
+        } else {
+            Q_EMIT channelMessageReceived(std::get<ChannelMessage>(message));
+        }
+    }
 }
 
 } // namespace MeshCore
@@ -6,6 +6,14 @@
 #include <QtQml/qqmlregistration.h>
 
 #include "MeshCoreDevice.h"
+#include "models/ContactModel.h"
+#include "models/ChannelModel.h"
+#include "models/MessageModel.h"
+#include "models/MessageSearchModel.h"
+#include "models/ConversationListModel.h"
+#include "models/RxLogModel.h"
+#include "storage/MessageStore.h"
+#include "storage/MessageSearchIndex.h"
 
 namespace MeshCore {
 
@@ -15,6 +23,9 @@ namespace MeshCore {
  * This class provides the same API as MeshCoreDevice but runs the actual
  * device operations on a separate thread to keep the UI responsive.
  * All communication happens via queued signal/slot connections.
+ *
+ * The list models exist only here. They are built from the ModelDelta
+ * batches published by the worker, which keeps no models of its own.
  */
 class MeshCoreDeviceController : public QObject
 {
@@ -43,7 +54,11 @@ private:
     Q_PROPERTY(ContactModel* contacts READ contacts CONSTANT)
     Q_PROPERTY(ChannelModel* channels READ channels CONSTANT)
     Q_PROPERTY(MessageModel* messages READ messages CONSTANT)
+    Q_PROPERTY(MessageSearchModel* messageSearch READ messageSearch CONSTANT)
+    Q_PROPERTY(ConversationListModel* conversations READ conversations CONSTANT)
     Q_PROPERTY(RxLogModel* rxLog READ rxLog CONSTANT)
+    Q_PROPERTY(bool rxCapturing READ isRxCapturing NOTIFY rxCaptureChanged)
+    Q_PROPERTY(QString rxCapturePath READ rxCapturePath NOTIFY rxCaptureChanged)
 
     Q_PROPERTY(bool scanning READ isScanning NOTIFY scanningChanged)
     Q_PROPERTY(QVariantList discoveredBleDevices READ discoveredBleDevices NOTIFY discoveredBleDevicesChanged)
@@ -67,7 +82,15 @@ public:
     [[nodiscard]] ContactModel *contacts() { return &m_contactModel; }
     [[nodiscard]] ChannelModel *channels() { return &m_channelModel; }
     [[nodiscard]] MessageModel *messages() { return &m_messageModel; }
+    [[nodiscard]] MessageSearchModel *messageSearch() { return &m_messageSearchModel; }
+    [[nodiscard]] ConversationListModel *conversations() { return &m_conversationListModel; }
     [[nodiscard]] RxLogModel *rxLog() { return &m_rxLogModel; }
+    [[nodiscard]] bool isRxCapturing() const { return !m_rxCapturePath.isEmpty(); }
+    [[nodiscard]] QString rxCapturePath() const { return m_rxCapturePath; }
+
+    // Sizes of the model batches received from the worker and the delay they add
+    [[nodiscard]] const ModelDeltaStats &modelDeltaStats() const { return m_modelDeltaStats; }
+    void resetModelDeltaStats() { m_modelDeltaStats = ModelDeltaStats(); }
 
     [[nodiscard]] bool isScanning() const { return m_scanning; }
     [[nodiscard]] QVariantList discoveredBleDevices() const { return m_discoveredBleDevices; }
@@ -133,6 +156,10 @@ public Q_SLOTS:
     void reboot();
     void setManualAddContacts(bool manual);
 
+    // RX capture; an empty path records to a new file in the captures directory
+    void startRxCapture(const QString &path = QString());
+    void stopRxCapture();
+
 Q_SIGNALS:
     // Property change signals
     void connectionStateChanged();
@@ -145,6 +172,7 @@ Q_SIGNALS:
     void scanningChanged();
     void discoveredBleDevicesChanged();
     void availableSerialPortsChanged();
+    void rxCaptureChanged();
 
     // Event signals
     void connectionError(const QString &error);
@@ -200,6 +228,12 @@ Q_SIGNALS:
     void doSendTracePath(const QByteArray &path);
     void doReboot();
     void doSetManualAddContacts(bool manual);
+    void doSetRxLogEnabled(bool enabled);
+    void doStartRxCapture(const QString &path);
+    void doStopRxCapture();
+
+    // Internal signal to search thread
+    void doOpenSearchIndex(const QByteArray &devicePublicKey);
 
 private Q_SLOTS:
     // Slots to receive updates from worker
@@ -212,15 +246,10 @@ private Q_SLOTS:
     void onScanningChanged();
     void onDiscoveredBleDevicesChanged();
     void onAvailableSerialPortsChanged();
+    void onRxCaptureChanged(const QString &path);
 
-    // Forward model updates from worker
-    void onContactReceived(const Contact &contact);
-    void onContactsCleared();
-    void onChannelReceived(const ChannelInfo &channel);
-    void onChannelsCleared();
-    void onContactMessageReceived(const ContactMessage &message);
-    void onChannelMessageReceived(const ChannelMessage &message);
-    void onRxLogEntry(double snr, qint8 rssi, const QByteArray &rawData);
+    // Apply a batch of model updates from the worker
+    void onModelDelta(const ModelDelta &delta);
 
 private:
     void setupConnections();
@@ -228,6 +257,9 @@ private:
     QThread m_workerThread;
     MeshCoreDevice *m_device = nullptr;  // Lives on worker thread
 
+    QThread m_searchThread;
+    MessageSearchIndex *m_searchIndex = nullptr;  // Lives on search thread
+
     // Cached state (main thread copies)
     ConnectionState m_connectionState = ConnectionState::Disconnected;
     ConnectionType m_connectionType = ConnectionType::None;
@@ -237,12 +269,19 @@ private:
     quint16 m_batteryMilliVolts = 0;
     bool m_scanning = false;
     QVariantList m_discoveredBleDevices;
+    QString m_rxCapturePath;
 
     // Models on main thread
     ContactModel m_contactModel;
     ChannelModel m_channelModel;
     MessageModel m_messageModel;
+    MessageSearchModel m_messageSearchModel;
+    ConversationListModel m_conversationListModel;
     RxLogModel m_rxLogModel;
+    ModelDeltaStats m_modelDeltaStats;
+
+    // Message history of the connected identity, paged into m_messageModel
+    MessageStore m_messageStore;
 };
 
 } // namespace MeshCore
@@ -0,0 +1,117 @@
+#include "ModelDelta.h"
+#include <chrono>
+#include <utility>
+
+namespace MeshCore {
+
+namespace {
+
+// Deltas are stamped on the device thread and recorded on the GUI thread,
+// so both ends read the same process-wide steady clock
+qint64 steadyNowMs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+qsizetype ModelDelta::changeCount() const
+{
+    return (contactsCleared ? 1 : 0) + removedContacts.size() + contacts.size()
+           + (channelsCleared ? 1 : 0) + channels.size() + messages.size() + rxLogEntries.size();
+}
+
+void ModelDeltaStats::record(const ModelDelta &delta)
+{
+    qint64 latencyMs = steadyNowMs() - delta.firstChangeMs;
+    qsizetype size = delta.changeCount();
+
+    ++batches;
+    changes += size;
+    maxBatchSize = qMax(maxBatchSize, size);
+    totalLatencyMs += latencyMs;
+    maxLatencyMs = qMax(maxLatencyMs, latencyMs);
+}
+
+ModelDeltaQueue::ModelDeltaQueue(QObject *parent)
+    : QObject(parent)
+    , m_timer(this)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(FlushIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &ModelDeltaQueue::flush);
+}
+
+void ModelDeltaQueue::clearContacts()
+{
+    m_pending.contacts.clear();
+    m_pending.removedContacts.clear();
+    m_pending.contactsCleared = true;
+    changed();
+}
+
+void ModelDeltaQueue::removeContact(const QByteArray &publicKey)
+{
+    m_pending.contacts.removeIf([&publicKey](const Contact &contact) {
+        return contact.publicKeyView() == QByteArrayView(publicKey);
+    });
+    m_pending.removedContacts.append(publicKey);
+    changed();
+}
+
+void ModelDeltaQueue::upsertContacts(const QList<Contact> &contacts)
+{
+    m_pending.contacts.append(contacts);
+    changed();
+}
+
+void ModelDeltaQueue::clearChannels()
+{
+    m_pending.channels.clear();
+    m_pending.channelsCleared = true;
+    changed();
+}
+
+void ModelDeltaQueue::upsertChannel(const ChannelInfo &channel)
+{
+    m_pending.channels.append(channel);
+    changed();
+}
+
+void ModelDeltaQueue::addMessage(const Message &message)
+{
+    m_pending.messages.append(message);
+    changed();
+}
+
+void ModelDeltaQueue::addRxLogEntry(const RxLogEntry &entry)
+{
+    m_pending.rxLogEntries.append(entry);
+    changed();
+}
+
+void ModelDeltaQueue::flush()
+{
+    m_timer.stop();
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    ModelDelta delta = std::exchange(m_pending, ModelDelta());
+    Q_EMIT deltaReady(delta);
+}
+
+void ModelDeltaQueue::changed()
+{
+    if (!m_timer.isActive()) {
+        m_pending.firstChangeMs = steadyNowMs();
+        m_timer.start();
+    }
+
+    if (m_pending.changeCount() >= MaxBatchSize) {
+        flush();
+    }
+}
+
+} // namespace MeshCore
@@ -0,0 +1,102 @@
+#ifndef MODELDELTA_H
+#define MODELDELTA_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QTimer>
+#include <variant>
+
+#include "types/Contact.h"
+#include "types/ChannelInfo.h"
+#include "types/ContactMessage.h"
+#include "types/ChannelMessage.h"
+#include "types/RxLogEntry.h"
+
+namespace MeshCore {
+
+using Message = std::variant<ContactMessage, ChannelMessage>;
+
+/**
+ * @brief One batch of model changes published by the worker thread
+ *
+ * Within a batch, clears are applied first, then removals, then the
+ * inserted or updated rows. Recording a clear or removal drops the pending
+ * rows it would have undone, so this order reproduces the order in which
+ * the changes were made.
+ */
+struct ModelDelta
+{
+    bool contactsCleared = false;
+    QList<QByteArray> removedContacts;  // Public keys
+    QList<Contact> contacts;            // Inserted or updated
+    bool channelsCleared = false;
+    QList<ChannelInfo> channels;        // Inserted or updated
+    QList<Message> messages;            // In arrival order
+    QList<RxLogEntry> rxLogEntries;
+
+    qint64 firstChangeMs = 0;  // Steady clock time of the first change, in ms
+
+    [[nodiscard]] qsizetype changeCount() const;
+    [[nodiscard]] bool isEmpty() const { return changeCount() == 0; }
+};
+
+/**
+ * @brief Batching statistics, recorded where the batches are applied
+ */
+struct ModelDeltaStats
+{
+    quint64 batches = 0;
+    quint64 changes = 0;
+    qsizetype maxBatchSize = 0;
+    qint64 totalLatencyMs = 0;  // First change in a batch until it was applied
+    qint64 maxLatencyMs = 0;
+
+    void record(const ModelDelta &delta);
+    [[nodiscard]] double averageBatchSize() const { return batches ? double(changes) / batches : 0.0; }
+    [[nodiscard]] double averageLatencyMs() const { return batches ? double(totalLatencyMs) / batches : 0.0; }
+};
+
+/**
+ * @brief Collects model changes on the worker thread and publishes them in batches
+ *
+ * The first change of a batch starts a FlushIntervalMs timer, so the GUI
+ * thread receives at most one batch per display frame. A batch that
+ * reaches MaxBatchSize changes is published immediately.
+ */
+class ModelDeltaQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FlushIntervalMs = 16;
+    static constexpr qsizetype MaxBatchSize = 256;
+
+    explicit ModelDeltaQueue(QObject *parent = nullptr);
+
+    void clearContacts();
+    void removeContact(const QByteArray &publicKey);
+    void upsertContacts(const QList<Contact> &contacts);
+    void clearChannels();
+    void upsertChannel(const ChannelInfo &channel);
+    void addMessage(const Message &message);
+    void addRxLogEntry(const RxLogEntry &entry);
+
+    // Publish whatever is pending now
+    void flush();
+
+Q_SIGNALS:
+    void deltaReady(const MeshCore::ModelDelta &delta);
+
+private:
+    void changed();
+
+    ModelDelta m_pending;
+    QTimer m_timer;
+};
+
+} // namespace MeshCore
+
+Q_DECLARE_METATYPE(MeshCore::ModelDelta)
+
+#endif // MODELDELTA_H
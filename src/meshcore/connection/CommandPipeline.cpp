@@ -0,0 +1,252 @@
+#include "CommandPipeline.h"
+#include <QDebug>
+#include <utility>
+
+namespace MeshCore {
+
+namespace {
+
+constexpr quint32 replyBit(ResponseCode code)
+{
+    return 1u << static_cast<quint8>(code);
+}
+
+} // namespace
+
+CommandPipeline::CommandPipeline(SendFunction send, QObject *parent)
+    : QObject(parent)
+    , m_send(std::move(send))
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &CommandPipeline::onTimeout);
+    m_clock.start();
+}
+
+CommandPipeline::~CommandPipeline() = default;
+
+constexpr std::array<CommandPipeline::ReplySpec, 256> CommandPipeline::buildReplySpecs()
+{
+    std::array<ReplySpec, 256> table{};
+
+    // Anything not listed below is a setter acknowledged with Ok
+    for (ReplySpec &spec : table) {
+        spec.final = replyBit(ResponseCode::Ok);
+    }
+
+    auto set = [&table](CommandCode command, quint32 final, quint32 progress = 0) {
+        table[static_cast<quint8>(command)] = ReplySpec{final, progress, true};
+    };
+
+    set(CommandCode::AppStart, replyBit(ResponseCode::SelfInfo));
+    set(CommandCode::DeviceQuery, replyBit(ResponseCode::DeviceInfo));
+    set(CommandCode::GetContacts, replyBit(ResponseCode::EndOfContacts),
+        replyBit(ResponseCode::ContactsStart) | replyBit(ResponseCode::Contact));
+    set(CommandCode::GetDeviceTime, replyBit(ResponseCode::CurrTime));
+    set(CommandCode::GetBatteryVoltage, replyBit(ResponseCode::BatteryVoltage));
+    set(CommandCode::SyncNextMessage, replyBit(ResponseCode::ContactMsgRecv)
+                                      | replyBit(ResponseCode::ChannelMsgRecv)
+                                      | replyBit(ResponseCode::NoMoreMessages));
+    set(CommandCode::ExportContact, replyBit(ResponseCode::ExportContact));
+    set(CommandCode::ExportPrivateKey, replyBit(ResponseCode::PrivateKey));
+    set(CommandCode::GetChannel, replyBit(ResponseCode::ChannelInfo));
+    set(CommandCode::SignStart, replyBit(ResponseCode::SignStart));
+    set(CommandCode::SignFinish, replyBit(ResponseCode::Signature));
+
+    // Messages and remote requests are acknowledged with Sent once queued for the mesh
+    set(CommandCode::SendTxtMsg, replyBit(ResponseCode::Sent));
+    set(CommandCode::SendLogin, replyBit(ResponseCode::Sent));
+    set(CommandCode::SendStatusReq, replyBit(ResponseCode::Sent));
+    set(CommandCode::SendTelemetryReq, replyBit(ResponseCode::Sent));
+    set(CommandCode::SendBinaryReq, replyBit(ResponseCode::Sent));
+    set(CommandCode::SendTracePath, replyBit(ResponseCode::Sent));
+
+    // The device restarts without answering
+    table[static_cast<quint8>(CommandCode::Reboot)] = ReplySpec{0, 0, false};
+
+    return table;
+}
+
+constinit const std::array<CommandPipeline::ReplySpec, 256> CommandPipeline::s_replySpecs =
+    CommandPipeline::buildReplySpecs();
+
+void CommandPipeline::setMaxInFlight(int count)
+{
+    m_maxInFlight = qMax(1, count);
+    pump();
+}
+
+void CommandPipeline::setTimeoutMs(int ms)
+{
+    m_timeoutMs = qMax(1, ms);
+}
+
+quint32 CommandPipeline::enqueue(const QByteArray &frame)
+{
+    Command command;
+    command.id = m_nextId++;
+    command.code = frame.isEmpty() ? 0 : static_cast<quint8>(frame.at(0));
+    command.frame = frame;
+    m_queue.enqueue(command);
+
+    pump();
+    return command.id;
+}
+
+void CommandPipeline::onResponse(quint8 code, bool malformed)
+{
+    if (code >= 32) {
+        return;
+    }
+
+    qint64 now = m_clock.elapsed();
+    m_timedOut.removeIf([now](const Command &command) { return command.deadline <= now; });
+
+    bool failure = code == static_cast<quint8>(ResponseCode::Err)
+                   || code == static_cast<quint8>(ResponseCode::Disabled);
+    quint32 bit = 1u << code;
+    qsizetype index = findReceiver(m_inFlight, bit, failure);
+    qsizetype late = findReceiver(m_timedOut, bit, failure);
+
+    // Replies arrive in command order, so a command sent earlier answers first
+    if (late >= 0 && (index < 0 || m_timedOut.at(late).sentAt < m_inFlight.at(index).sentAt)) {
+        qDebug() << "CommandPipeline: late reply code" << code << "to timed out command"
+                 << m_timedOut.at(late).code;
+        if (failure || (s_replySpecs[m_timedOut.at(late).code].final & bit)) {
+            m_timedOut.removeAt(late);
+        } else {
+            m_timedOut[late].streaming = true;
+            m_timedOut[late].deadline = now + m_timeoutMs;
+        }
+        return;
+    }
+
+    if (index < 0) {
+        qDebug() << "CommandPipeline: reply code" << code << "matches no in-flight command";
+        return;
+    }
+
+    Command &command = m_inFlight[index];
+    if (failure || (s_replySpecs[command.code].final & bit)) {
+        finish(index, failure || malformed ? Result::Failed : Result::Completed);
+        pump();
+        return;
+    }
+
+    // Streaming replies (contact lists) keep the command alive
+    command.streaming = true;
+    command.deadline = now + m_timeoutMs;
+    armTimer();
+}
+
+qsizetype CommandPipeline::findReceiver(const QList<Command> &commands, quint32 bit, bool failure)
+{
+    for (qsizetype i = 0; i < commands.size(); ++i) {
+        const Command &command = commands.at(i);
+        if (failure) {
+            if (!command.streaming) {
+                return i;
+            }
+            continue;
+        }
+        const ReplySpec &spec = s_replySpecs[command.code];
+        if ((spec.final | spec.progress) & bit) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void CommandPipeline::cancelAll()
+{
+    QList<Command> inFlight = std::exchange(m_inFlight, {});
+    QQueue<Command> queued = std::exchange(m_queue, {});
+    m_timedOut.clear();
+    m_timer.stop();
+
+    for (const Command &command : std::as_const(inFlight)) {
+        Q_EMIT commandFinished(command.id, static_cast<CommandCode>(command.code), Result::Cancelled,
+                               m_clock.elapsed() - command.sentAt);
+    }
+    for (const Command &command : std::as_const(queued)) {
+        Q_EMIT commandFinished(command.id, static_cast<CommandCode>(command.code), Result::Cancelled, 0);
+    }
+}
+
+void CommandPipeline::resetLatency()
+{
+    m_latency.fill(Latency());
+}
+
+void CommandPipeline::pump()
+{
+    while (m_inFlight.size() < m_maxInFlight && !m_queue.isEmpty()) {
+        Command command = m_queue.dequeue();
+        command.sentAt = m_clock.elapsed();
+        command.deadline = command.sentAt + m_timeoutMs;
+        QByteArray frame = std::exchange(command.frame, QByteArray());
+
+        if (s_replySpecs[command.code].expectsReply) {
+            m_inFlight.append(command);
+            m_send(frame);
+        } else {
+            m_send(frame);
+            Q_EMIT commandFinished(command.id, static_cast<CommandCode>(command.code), Result::Completed, 0);
+        }
+    }
+
+    armTimer();
+}
+
+void CommandPipeline::finish(qsizetype index, Result result)
+{
+    Command command = m_inFlight.takeAt(index);
+    qint64 latencyMs = m_clock.elapsed() - command.sentAt;
+
+    // Only round trips that produced a reply count towards latency
+    if (result == Result::Completed || result == Result::Failed) {
+        Latency &stats = m_latency[command.code];
+        ++stats.count;
+        stats.totalMs += latencyMs;
+        stats.maxMs = qMax(stats.maxMs, latencyMs);
+        stats.lastMs = latencyMs;
+    }
+
+    armTimer();
+    Q_EMIT commandFinished(command.id, static_cast<CommandCode>(command.code), result, latencyMs);
+}
+
+void CommandPipeline::onTimeout()
+{
+    qint64 now = m_clock.elapsed();
+    m_timedOut.removeIf([now](const Command &command) { return command.deadline <= now; });
+
+    for (qsizetype i = 0; i < m_inFlight.size();) {
+        if (m_inFlight.at(i).deadline <= now) {
+            qWarning() << "CommandPipeline: command" << m_inFlight.at(i).code << "timed out";
+            Command late = m_inFlight.at(i);
+            late.deadline = now + m_timeoutMs;
+            m_timedOut.append(late);
+            finish(i, Result::TimedOut);
+        } else {
+            ++i;
+        }
+    }
+
+    pump();
+}
+
+void CommandPipeline::armTimer()
+{
+    if (m_inFlight.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+
+    qint64 deadline = m_inFlight.first().deadline;
+    for (const Command &command : std::as_const(m_inFlight)) {
+        deadline = qMin(deadline, command.deadline);
+    }
+    m_timer.start(static_cast<int>(qMax<qint64>(0, deadline - m_clock.elapsed())));
+}
+
+} // namespace MeshCore
@@ -0,0 +1,132 @@
+#ifndef COMMANDPIPELINE_H
+#define COMMANDPIPELINE_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QTimer>
+#include <array>
+#include <functional>
+
+#include "../MeshCoreConstants.h"
+
+namespace MeshCore {
+
+/**
+ * @brief Queues outgoing commands and matches them with their replies
+ *
+ * The companion protocol carries no request ids, but the radio answers
+ * commands strictly in the order it receives them. Each command is therefore
+ * tracked with the set of response codes that can finish it, and an incoming
+ * response resolves the oldest in-flight command expecting that code.
+ * Err and Disabled finish the oldest in-flight command that has not yet
+ * started streaming replies, since a command that is streaming was accepted.
+ *
+ * A command that times out is kept aside for another timeout period: a late
+ * reply to it is recognised and dropped rather than resolving the command
+ * sent after it.
+ *
+ * Up to maxInFlight() commands are written to the transport before their
+ * replies arrive; the rest wait in the queue. Commands that get no reply
+ * (Reboot) are resolved as soon as they are written.
+ */
+class CommandPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    using SendFunction = std::function<void(const QByteArray &frame)>;
+
+    enum class Result {
+        Completed,
+        Failed,     // Err or Disabled reply, or a malformed reply frame
+        TimedOut,
+        Cancelled   // Connection closed before a reply arrived
+    };
+    Q_ENUM(Result)
+
+    // Round-trip statistics for one command code
+    struct Latency {
+        quint64 count = 0;
+        qint64 totalMs = 0;
+        qint64 maxMs = 0;
+        qint64 lastMs = 0;
+
+        [[nodiscard]] double averageMs() const { return count ? double(totalMs) / count : 0.0; }
+    };
+
+    static constexpr int DefaultMaxInFlight = 4;
+    static constexpr int DefaultTimeoutMs = 5000;
+
+    explicit CommandPipeline(SendFunction send, QObject *parent = nullptr);
+    ~CommandPipeline() override;
+
+    // Configuration
+    [[nodiscard]] int maxInFlight() const { return m_maxInFlight; }
+    void setMaxInFlight(int count);
+    [[nodiscard]] int timeoutMs() const { return m_timeoutMs; }
+    void setTimeoutMs(int ms);
+
+    // Queue a complete command frame (code byte first). Returns its command id.
+    quint32 enqueue(const QByteArray &frame);
+
+    // Feed every response frame code (not pushes) after it was handled.
+    // malformed marks a reply that could not be decoded.
+    void onResponse(quint8 code, bool malformed = false);
+
+    // Drop everything in flight and queued, reporting them as cancelled
+    void cancelAll();
+
+    [[nodiscard]] int inFlightCount() const { return m_inFlight.size(); }
+    [[nodiscard]] int queuedCount() const { return m_queue.size(); }
+
+    // Latency statistics per command code
+    [[nodiscard]] Latency latency(CommandCode command) const { return m_latency[static_cast<quint8>(command)]; }
+    void resetLatency();
+
+Q_SIGNALS:
+    void commandFinished(quint32 id, MeshCore::CommandCode command,
+                         MeshCore::CommandPipeline::Result result, qint64 latencyMs);
+
+private:
+    // Bit masks over response codes (all below 32)
+    struct ReplySpec {
+        quint32 final = 0;     // Codes that finish the command
+        quint32 progress = 0;  // Codes that belong to it without finishing it
+        bool expectsReply = true;
+    };
+    static constexpr std::array<ReplySpec, 256> buildReplySpecs();
+    static const std::array<ReplySpec, 256> s_replySpecs;
+
+    struct Command {
+        quint32 id = 0;
+        quint8 code = 0;
+        QByteArray frame;
+        qint64 sentAt = 0;
+        qint64 deadline = 0;   // Once timed out, when a late reply is no longer expected
+        bool streaming = false;
+    };
+
+    // Oldest command in the list the reply belongs to, or -1
+    static qsizetype findReceiver(const QList<Command> &commands, quint32 bit, bool failure);
+    void pump();
+    void finish(qsizetype index, Result result);
+    void onTimeout();
+    void armTimer();
+
+    SendFunction m_send;
+    QQueue<Command> m_queue;
+    QList<Command> m_inFlight;  // Oldest first
+    QList<Command> m_timedOut;  // Reported as timed out, still awaiting a late reply
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    quint32 m_nextId = 1;
+    int m_maxInFlight = DefaultMaxInFlight;
+    int m_timeoutMs = DefaultTimeoutMs;
+    std::array<Latency, 256> m_latency{};
+};
+
+} // namespace MeshCore
+
+#endif // COMMANDPIPELINE_H
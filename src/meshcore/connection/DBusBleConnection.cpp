@@ -716,7 +716,7 @@ void DBusBleConnection::onNotifyFdReadyRead()
     
     if (bytesRead > 0) {
         QByteArray data(buffer, bytesRead);
-        qDebug() << "DBus BLE: Received via fd:" << data.size() << "bytes:" << data.toHex();
+        qCDebug(lcFrames) << "DBus BLE: Received via fd:" << data.size() << "bytes:" << data.toHex();
         onFrameReceived(data);
     } else if (bytesRead == 0) {
         qDebug() << "DBus BLE: Notify fd closed";
@@ -780,7 +780,7 @@ void DBusBleConnection::onPropertiesChanged(const QString &interface,
             }
             
             if (!data.isEmpty()) {
-                qDebug() << "DBus BLE: Received notification" << data.size() << "bytes:" << data.toHex();
+                qCDebug(lcFrames) << "DBus BLE: Received notification" << data.size() << "bytes:" << data.toHex();
                 onFrameReceived(data);
             }
         }
@@ -828,7 +828,7 @@ void DBusBleConnection::writeViaFd(const QByteArray &data)
         return;
     }
     
-    qDebug() << "DBus BLE: Writing" << data.size() << "bytes via fd:" << data.toHex();
+    qCDebug(lcFrames) << "DBus BLE: Writing" << data.size() << "bytes via fd:" << data.toHex();
     
     // Respect MTU - split data if needed
     int offset = 0;
@@ -862,7 +862,7 @@ void DBusBleConnection::writeViaDBus(const QByteArray &data)
         return;
     }
     
-    qDebug() << "DBus BLE: Writing" << data.size() << "bytes via DBus:" << data.toHex();
+    qCDebug(lcFrames) << "DBus BLE: Writing" << data.size() << "bytes via DBus:" << data.toHex();
     
     // WriteValue takes a byte array and options dict
     QDBusMessage msg = QDBusMessage::createMethodCall(
@@ -1,10 +1,29 @@
 #include "MeshCoreConnection.h"
 #include "../utils/BufferReader.h"
-#include "../utils/BufferWriter.h"
+#include "ProtocolSchema.h"
+#include <QMetaMethod>
 #include <QTimer>
+#include <tuple>
+
+Q_LOGGING_CATEGORY(lcFrames, "qmeshcore.frames", QtInfoMsg)
 
 namespace MeshCore {
 
+namespace {
+
+// A key or secret of the wrong length would be padded or cut into a
+// different one by the frame schema, so such commands are not sent
+bool hasLength(const char *command, QByteArrayView value, qsizetype length)
+{
+    if (value.size() == length) {
+        return true;
+    }
+    qWarning() << command << "not sent: expected" << length << "bytes, got" << value.size();
+    return false;
+}
+
+} // namespace
+
 MeshCoreConnection::MeshCoreConnection(QObject *parent)
     : QObject(parent)
 {
@@ -26,13 +45,21 @@ void MeshCoreConnection::onConnected()
 void MeshCoreConnection::onDisconnected()
 {
     m_connected = false;
+    m_commandPipeline.cancelAll();
     Q_EMIT disconnected();
 }
 
-void MeshCoreConnection::onFrameReceived(const QByteArray &frame)
+void MeshCoreConnection::onFrameReceived(QByteArrayView frame)
 {
-    qDebug() << "Frame received:" << frame.size() << "bytes, data:" << frame.toHex();
-    Q_EMIT frameReceived(frame);
+    // qCDebug only evaluates its arguments when the category is enabled
+    qCDebug(lcFrames) << "Frame received:" << frame.size() << "bytes, data:" << frame.toByteArray().toHex();
+
+    // Transports may hand us a view into their receive buffer; only take a
+    // copy for the raw frame signal when somebody is listening to it
+    static const QMetaMethod frameReceivedSignal = QMetaMethod::fromSignal(&MeshCoreConnection::frameReceived);
+    if (isSignalConnected(frameReceivedSignal)) {
+        Q_EMIT frameReceived(frame.toByteArray());
+    }
 
     if (frame.isEmpty()) {
         return;
@@ -40,77 +67,86 @@ void MeshCoreConnection::onFrameReceived(const QByteArray &frame)
 
     BufferReader reader(frame);
     quint8 responseCode = reader.readByte();
+    ++m_frameCounts[responseCode];
 
-    // Response codes
-    if (responseCode == static_cast<quint8>(ResponseCode::Ok)) {
-        handleOkResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::Err)) {
-        handleErrorResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::SelfInfo)) {
-        handleSelfInfoResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::DeviceInfo)) {
-        handleDeviceInfoResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::ContactsStart)) {
-        handleContactsStartResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::Contact)) {
-        handleContactResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::EndOfContacts)) {
-        handleEndOfContactsResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::Sent)) {
-        handleSentResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::ContactMsgRecv)) {
-        handleContactMsgRecvResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::ChannelMsgRecv)) {
-        handleChannelMsgRecvResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::NoMoreMessages)) {
-        handleNoMoreMessagesResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::CurrTime)) {
-        handleCurrentTimeResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::ExportContact)) {
-        handleExportContactResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::BatteryVoltage)) {
-        handleBatteryVoltageResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::PrivateKey)) {
-        handlePrivateKeyResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::Disabled)) {
-        handleDisabledResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::ChannelInfo)) {
-        handleChannelInfoResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::SignStart)) {
-        handleSignStartResponse(reader);
-    } else if (responseCode == static_cast<quint8>(ResponseCode::Signature)) {
-        handleSignatureResponse(reader);
-    }
-    // Push codes
-    else if (responseCode == static_cast<quint8>(PushCode::Advert)) {
-        handleAdvertPush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::NewAdvert)) {
-        handleNewAdvertPush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::PathUpdated)) {
-        handlePathUpdatedPush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::SendConfirmed)) {
-        handleSendConfirmedPush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::MsgWaiting)) {
-        handleMsgWaitingPush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::RawData)) {
-        handleRawDataPush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::LoginSuccess)) {
-        handleLoginSuccessPush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::StatusResponse)) {
-        handleStatusResponsePush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::LogRxData)) {
-        handleLogRxDataPush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::TelemetryResponse)) {
-        handleTelemetryResponsePush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::TraceData)) {
-        handleTraceDataPush(reader);
-    } else if (responseCode == static_cast<quint8>(PushCode::BinaryResponse)) {
-        handleBinaryResponsePush(reader);
+    // Single table lookup instead of comparing against every known code
+    FrameHandler handler = s_frameHandlers[responseCode];
+    if (handler) {
+        (this->*handler)(reader);
     } else {
+        ++m_unhandledFrameCount;
         qWarning() << "Unhandled frame code:" << responseCode;
+        return;
+    }
+
+    // Handlers bail out without emitting when the frame is too short
+    if (reader.hasError()) {
+        ++m_malformedFrameCount;
+        qWarning() << "Dropped malformed frame, code:" << responseCode << "size:" << frame.size();
     }
+
+    // Resolve the command this reply answers once its data signal has gone out
+    if (responseCode < static_cast<quint8>(PushCode::Advert)) {
+        m_commandPipeline.onResponse(responseCode, reader.hasError());
+    }
+}
+
+void MeshCoreConnection::resetFrameCounts()
+{
+    m_frameCounts.fill(0);
+    m_unhandledFrameCount = 0;
+    m_malformedFrameCount = 0;
+}
+
+constexpr std::array<MeshCoreConnection::FrameHandler, 256> MeshCoreConnection::buildFrameHandlers()
+{
+    std::array<FrameHandler, 256> table{};
+
+    auto set = [&table](auto code, FrameHandler handler) {
+        table[static_cast<quint8>(code)] = handler;
+    };
+
+    // Response codes
+    set(ResponseCode::Ok, &MeshCoreConnection::handleOkResponse);
+    set(ResponseCode::Err, &MeshCoreConnection::handleErrorResponse);
+    set(ResponseCode::SelfInfo, &MeshCoreConnection::handleSelfInfoResponse);
+    set(ResponseCode::DeviceInfo, &MeshCoreConnection::handleDeviceInfoResponse);
+    set(ResponseCode::ContactsStart, &MeshCoreConnection::handleContactsStartResponse);
+    set(ResponseCode::Contact, &MeshCoreConnection::handleContactResponse);
+    set(ResponseCode::EndOfContacts, &MeshCoreConnection::handleEndOfContactsResponse);
+    set(ResponseCode::Sent, &MeshCoreConnection::handleSentResponse);
+    set(ResponseCode::ContactMsgRecv, &MeshCoreConnection::handleContactMsgRecvResponse);
+    set(ResponseCode::ChannelMsgRecv, &MeshCoreConnection::handleChannelMsgRecvResponse);
+    set(ResponseCode::NoMoreMessages, &MeshCoreConnection::handleNoMoreMessagesResponse);
+    set(ResponseCode::CurrTime, &MeshCoreConnection::handleCurrentTimeResponse);
+    set(ResponseCode::ExportContact, &MeshCoreConnection::handleExportContactResponse);
+    set(ResponseCode::BatteryVoltage, &MeshCoreConnection::handleBatteryVoltageResponse);
+    set(ResponseCode::PrivateKey, &MeshCoreConnection::handlePrivateKeyResponse);
+    set(ResponseCode::Disabled, &MeshCoreConnection::handleDisabledResponse);
+    set(ResponseCode::ChannelInfo, &MeshCoreConnection::handleChannelInfoResponse);
+    set(ResponseCode::SignStart, &MeshCoreConnection::handleSignStartResponse);
+    set(ResponseCode::Signature, &MeshCoreConnection::handleSignatureResponse);
+
+    // Push codes
+    set(PushCode::Advert, &MeshCoreConnection::handleAdvertPush);
+    set(PushCode::NewAdvert, &MeshCoreConnection::handleNewAdvertPush);
+    set(PushCode::PathUpdated, &MeshCoreConnection::handlePathUpdatedPush);
+    set(PushCode::SendConfirmed, &MeshCoreConnection::handleSendConfirmedPush);
+    set(PushCode::MsgWaiting, &MeshCoreConnection::handleMsgWaitingPush);
+    set(PushCode::RawData, &MeshCoreConnection::handleRawDataPush);
+    set(PushCode::LoginSuccess, &MeshCoreConnection::handleLoginSuccessPush);
+    set(PushCode::StatusResponse, &MeshCoreConnection::handleStatusResponsePush);
+    set(PushCode::LogRxData, &MeshCoreConnection::handleLogRxDataPush);
+    set(PushCode::TelemetryResponse, &MeshCoreConnection::handleTelemetryResponsePush);
+    set(PushCode::TraceData, &MeshCoreConnection::handleTraceDataPush);
+    set(PushCode::BinaryResponse, &MeshCoreConnection::handleBinaryResponsePush);
+
+    return table;
 }
 
+constinit const std::array<MeshCoreConnection::FrameHandler, 256> MeshCoreConnection::s_frameHandlers =
+    MeshCoreConnection::buildFrameHandlers();
+
 // Response handlers
 void MeshCoreConnection::handleOkResponse(BufferReader &)
 {
@@ -119,40 +155,36 @@ void MeshCoreConnection::handleOkResponse(BufferReader &)
 
 void MeshCoreConnection::handleErrorResponse(BufferReader &reader)
 {
+    auto [errorCodeField] = Protocol::ErrorResponse::decode(reader);
+
     ErrorCode errCode = ErrorCode::UnsupportedCmd;
-    if (reader.hasRemaining()) {
-        errCode = static_cast<ErrorCode>(reader.readByte());
+    if (!errorCodeField.isEmpty()) {
+        errCode = static_cast<ErrorCode>(errorCodeField.front());
     }
     Q_EMIT errorResponse(errCode);
 }
 
 void MeshCoreConnection::handleSelfInfoResponse(BufferReader &reader)
 {
-    AdvertType type = static_cast<AdvertType>(reader.readByte());
-    quint8 txPower = reader.readByte();
-    quint8 maxTxPower = reader.readByte();
-    QByteArray publicKey = reader.readBytes(32);
-    qint32 advLat = reader.readInt32LE();
-    qint32 advLon = reader.readInt32LE();
-    reader.skip(3);  // reserved
-    bool manualAddContacts = reader.readByte() != 0;
-    quint32 radioFreq = reader.readUInt32LE();
-    quint32 radioBw = reader.readUInt32LE();
-    quint8 radioSf = reader.readByte();
-    quint8 radioCr = reader.readByte();
-    QString name = reader.readString();
-
-    SelfInfo selfInfo(type, txPower, maxTxPower, publicKey, advLat, advLon,
-                      manualAddContacts, radioFreq, radioBw, radioSf, radioCr, name);
+    auto [type, txPower, maxTxPower, publicKey, advLat, advLon, manualAddContacts,
+          radioFreq, radioBw, radioSf, radioCr, name] = Protocol::SelfInfoResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
+    SelfInfo selfInfo(type, txPower, maxTxPower, publicKey.toByteArray(), advLat, advLon,
+                      manualAddContacts != 0, radioFreq, radioBw, radioSf, radioCr, name);
     Q_EMIT selfInfoReceived(selfInfo);
 }
 
 void MeshCoreConnection::handleDeviceInfoResponse(BufferReader &reader)
 {
-    qint8 firmwareVer = reader.readInt8();
-    reader.skip(6);  // reserved
-    QString firmwareBuildDate = reader.readCString(12);
-    QString manufacturerModel = reader.readString();
+    auto [firmwareVer, firmwareBuildDate, manufacturerModel] = Protocol::DeviceInfoResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
 
     DeviceInfo info(firmwareVer, firmwareBuildDate, manufacturerModel);
     Q_EMIT deviceInfoReceived(info);
@@ -160,61 +192,89 @@ void MeshCoreConnection::handleDeviceInfoResponse(BufferReader &reader)
 
 void MeshCoreConnection::handleContactsStartResponse(BufferReader &reader)
 {
-    quint32 count = reader.readUInt32LE();
+    auto [count] = Protocol::ContactsStartResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
     Q_EMIT contactsStarted(count);
 }
 
+// Contact stores the record's key, path and name inline
+static_assert(Contact::PublicKeySize == Protocol::PublicKeySize);
+static_assert(Contact::MaxPathSize == Protocol::MaxPathSize);
+static_assert(Contact::MaxNameSize >= Protocol::MaxNameSize);
+
+Contact MeshCoreConnection::readContactRecord(BufferReader &reader)
+{
+    auto [publicKey, type, flags, outPathLen, outPathField, advName,
+          lastAdvert, advLat, advLon, lastMod] = Protocol::ContactRecord::decode(reader);
+
+    if (reader.hasError()) {
+        return Contact();
+    }
+
+    // Only the first outPathLen bytes of the 64-byte path field are meaningful
+    QByteArrayView outPath = outPathField.first(qBound(0, int(outPathLen), int(Protocol::MaxPathSize)));
+    return Contact(publicKey, type, flags, outPathLen, outPath, advName,
+                   lastAdvert, advLat, advLon, lastMod);
+}
+
 void MeshCoreConnection::handleContactResponse(BufferReader &reader)
 {
-    QByteArray publicKey = reader.readBytes(32);
-    AdvertType type = static_cast<AdvertType>(reader.readByte());
-    quint8 flags = reader.readByte();
-    qint8 outPathLen = reader.readInt8();
-    QByteArray outPath = reader.readBytes(64);
-    QString advName = reader.readCString(32);
-    quint32 lastAdvert = reader.readUInt32LE();
-    qint32 advLat = reader.readInt32LE();  // Signed - can be negative for southern hemisphere
-    qint32 advLon = reader.readInt32LE();  // Signed - can be negative for western hemisphere
-    quint32 lastMod = reader.readUInt32LE();
-
-    Contact contact(publicKey, type, flags, outPathLen, outPath, advName,
-                    lastAdvert, advLat, advLon, lastMod);
+    Contact contact = readContactRecord(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
     Q_EMIT contactReceived(contact);
 }
 
 void MeshCoreConnection::handleEndOfContactsResponse(BufferReader &reader)
 {
-    quint32 mostRecentLastMod = reader.readUInt32LE();
+    auto [mostRecentLastMod] = Protocol::EndOfContactsResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
     Q_EMIT contactsEnded(mostRecentLastMod);
 }
 
 void MeshCoreConnection::handleSentResponse(BufferReader &reader)
 {
-    qint8 result = reader.readInt8();
-    quint32 expectedAckCrc = reader.readUInt32LE();
-    quint32 estTimeout = reader.readUInt32LE();
+    auto [result, expectedAckCrc, estTimeout] = Protocol::SentResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
     Q_EMIT sentResponse(result, expectedAckCrc, estTimeout);
 }
 
 void MeshCoreConnection::handleContactMsgRecvResponse(BufferReader &reader)
 {
-    QByteArray pubKeyPrefix = reader.readBytes(6);
-    quint8 pathLen = reader.readByte();
-    TxtType txtType = static_cast<TxtType>(reader.readByte());
-    quint32 senderTimestamp = reader.readUInt32LE();
-    QString text = reader.readString();
+    auto [pubKeyPrefix, pathLen, txtType, senderTimestamp, text] =
+        Protocol::ContactMsgRecvResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
 
-    ContactMessage msg(pubKeyPrefix, pathLen, txtType, senderTimestamp, text);
+    ContactMessage msg(pubKeyPrefix.toByteArray(), pathLen, txtType, senderTimestamp, text);
     Q_EMIT contactMessageReceived(msg);
 }
 
 void MeshCoreConnection::handleChannelMsgRecvResponse(BufferReader &reader)
 {
-    qint8 channelIdx = reader.readInt8();
-    quint8 pathLen = reader.readByte();
-    TxtType txtType = static_cast<TxtType>(reader.readByte());
-    quint32 senderTimestamp = reader.readUInt32LE();
-    QString text = reader.readString();
+    auto [channelIdx, pathLen, txtType, senderTimestamp, text] =
+        Protocol::ChannelMsgRecvResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
 
     ChannelMessage msg(channelIdx, pathLen, txtType, senderTimestamp, text);
     Q_EMIT channelMessageReceived(msg);
@@ -227,26 +287,46 @@ void MeshCoreConnection::handleNoMoreMessagesResponse(BufferReader &)
 
 void MeshCoreConnection::handleCurrentTimeResponse(BufferReader &reader)
 {
-    quint32 epochSecs = reader.readUInt32LE();
+    auto [epochSecs] = Protocol::CurrentTimeResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
     Q_EMIT currentTimeReceived(epochSecs);
 }
 
 void MeshCoreConnection::handleExportContactResponse(BufferReader &reader)
 {
-    QByteArray advertPacketBytes = reader.readRemainingBytes();
-    Q_EMIT exportContactReceived(advertPacketBytes);
+    auto [advertPacketBytes] = Protocol::ExportContactResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
+    Q_EMIT exportContactReceived(advertPacketBytes.toByteArray());
 }
 
 void MeshCoreConnection::handleBatteryVoltageResponse(BufferReader &reader)
 {
-    quint16 milliVolts = reader.readUInt16LE();
+    auto [milliVolts] = Protocol::BatteryVoltageResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
     Q_EMIT batteryVoltageReceived(milliVolts);
 }
 
 void MeshCoreConnection::handlePrivateKeyResponse(BufferReader &reader)
 {
-    QByteArray privateKey = reader.readBytes(64);
-    Q_EMIT privateKeyReceived(privateKey);
+    auto [privateKey] = Protocol::PrivateKeyResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
+    Q_EMIT privateKeyReceived(privateKey.toByteArray());
 }
 
 void MeshCoreConnection::handleDisabledResponse(BufferReader &)
@@ -256,13 +336,15 @@ void MeshCoreConnection::handleDisabledResponse(BufferReader &)
 
 void MeshCoreConnection::handleChannelInfoResponse(BufferReader &reader)
 {
-    quint8 idx = reader.readUInt8();
-    QString name = reader.readCString(32);
+    auto [idx, name, secretField] = Protocol::ChannelInfoResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
 
-    qsizetype remaining = reader.remainingBytes();
     QByteArray secret;
-    if (remaining == 16) {
-        secret = reader.readBytes(16);
+    if (secretField.size() == 16) {
+        secret = secretField.toByteArray();
     }
 
     ChannelInfo info(idx, name, secret);
@@ -271,52 +353,68 @@ void MeshCoreConnection::handleChannelInfoResponse(BufferReader &reader)
 
 void MeshCoreConnection::handleSignStartResponse(BufferReader &reader)
 {
-    reader.skip(1);  // reserved
-    quint32 maxSignDataLen = reader.readUInt32LE();
+    auto [maxSignDataLen] = Protocol::SignStartResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
     Q_EMIT signStartReceived(maxSignDataLen);
 }
 
 void MeshCoreConnection::handleSignatureResponse(BufferReader &reader)
 {
-    QByteArray signature = reader.readBytes(64);
-    Q_EMIT signatureReceived(signature);
+    auto [signature] = Protocol::SignatureResponse::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
+    Q_EMIT signatureReceived(signature.toByteArray());
 }
 
 // Push handlers
 void MeshCoreConnection::handleAdvertPush(BufferReader &reader)
 {
-    QByteArray publicKey = reader.readBytes(32);
-    Q_EMIT advertPush(publicKey);
+    auto [publicKey] = Protocol::AdvertPush::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
+    Q_EMIT advertPush(publicKey.toByteArray());
 }
 
 void MeshCoreConnection::handleNewAdvertPush(BufferReader &reader)
 {
-    QByteArray publicKey = reader.readBytes(32);
-    AdvertType type = static_cast<AdvertType>(reader.readByte());
-    quint8 flags = reader.readByte();
-    qint8 outPathLen = reader.readInt8();
-    QByteArray outPath = reader.readBytes(64);
-    QString advName = reader.readCString(32);
-    quint32 lastAdvert = reader.readUInt32LE();
-    qint32 advLat = reader.readUInt32LE();
-    qint32 advLon = reader.readUInt32LE();
-    quint32 lastMod = reader.readUInt32LE();
-
-    Contact contact(publicKey, type, flags, outPathLen, outPath, advName,
-                    lastAdvert, advLat, advLon, lastMod);
+    Contact contact = readContactRecord(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
     Q_EMIT newAdvertPush(contact);
 }
 
 void MeshCoreConnection::handlePathUpdatedPush(BufferReader &reader)
 {
-    QByteArray publicKey = reader.readBytes(32);
-    Q_EMIT pathUpdatedPush(publicKey);
+    auto [publicKey] = Protocol::PathUpdatedPush::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
+    Q_EMIT pathUpdatedPush(publicKey.toByteArray());
 }
 
 void MeshCoreConnection::handleSendConfirmedPush(BufferReader &reader)
 {
-    quint32 ackCode = reader.readUInt32LE();
-    quint32 roundTrip = reader.readUInt32LE();
+    auto [ackCode, roundTrip] = Protocol::SendConfirmedPush::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
     Q_EMIT sendConfirmedPush(ackCode, roundTrip);
 }
 
@@ -327,173 +425,149 @@ void MeshCoreConnection::handleMsgWaitingPush(BufferReader &)
 
 void MeshCoreConnection::handleRawDataPush(BufferReader &reader)
 {
-    double snr = reader.readInt8() / 4.0;
-    qint8 rssi = reader.readInt8();
-    reader.skip(1);  // reserved
-    QByteArray payload = reader.readRemainingBytes();
-    Q_EMIT rawDataPush(snr, rssi, payload);
+    auto [snrQuarters, rssi, payload] = Protocol::RawDataPush::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
+    Q_EMIT rawDataPush(snrQuarters / 4.0, rssi, payload.toByteArray());
 }
 
 void MeshCoreConnection::handleLoginSuccessPush(BufferReader &reader)
 {
-    reader.skip(1);  // reserved
-    QByteArray pubKeyPrefix = reader.readBytes(6);
-    Q_EMIT loginSuccessPush(pubKeyPrefix);
+    auto [pubKeyPrefix] = Protocol::LoginSuccessPush::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
+    Q_EMIT loginSuccessPush(pubKeyPrefix.toByteArray());
 }
 
 void MeshCoreConnection::handleStatusResponsePush(BufferReader &reader)
 {
-    reader.skip(1);  // reserved
-    QByteArray pubKeyPrefix = reader.readBytes(6);
-    QByteArray statusData = reader.readRemainingBytes();
+    auto [pubKeyPrefix, statusData] = Protocol::StatusResponsePush::decode(reader);
 
     // Parse repeater stats from status data
     BufferReader statsReader(statusData);
-    quint16 battMv = statsReader.readUInt16LE();
-    quint16 txQueueLen = statsReader.readUInt16LE();
-    qint16 noiseFloor = statsReader.readInt16LE();
-    qint16 lastRssi = statsReader.readInt16LE();
-    quint32 packetsRecv = statsReader.readUInt32LE();
-    quint32 packetsSent = statsReader.readUInt32LE();
-    quint32 totalAirTime = statsReader.readUInt32LE();
-    quint32 totalUpTime = statsReader.readUInt32LE();
-    quint32 sentFlood = statsReader.readUInt32LE();
-    quint32 sentDirect = statsReader.readUInt32LE();
-    quint32 recvFlood = statsReader.readUInt32LE();
-    quint32 recvDirect = statsReader.readUInt32LE();
-    quint16 errEvents = statsReader.readUInt16LE();
-    qint16 lastSnr = statsReader.readInt16LE();
-    quint16 directDups = statsReader.readUInt16LE();
-    quint16 floodDups = statsReader.readUInt16LE();
-
-    RepeaterStats stats(battMv, txQueueLen, noiseFloor, lastRssi, packetsRecv, packetsSent,
-                        totalAirTime, totalUpTime, sentFlood, sentDirect, recvFlood, recvDirect,
-                        errEvents, lastSnr, directDups, floodDups);
-    Q_EMIT statusResponsePush(pubKeyPrefix, stats);
+    auto statsFields = Protocol::RepeaterStatsRecord::decode(statsReader);
+
+    if (reader.hasError() || statsReader.hasError()) {
+        return;
+    }
+
+    RepeaterStats stats = std::make_from_tuple<RepeaterStats>(statsFields);
+    Q_EMIT statusResponsePush(pubKeyPrefix.toByteArray(), stats);
 }
 
 void MeshCoreConnection::handleLogRxDataPush(BufferReader &reader)
 {
-    double snr = reader.readInt8() / 4.0;
-    qint8 rssi = reader.readInt8();
-    QByteArray raw = reader.readRemainingBytes();
-    Q_EMIT logRxDataPush(snr, rssi, raw);
+    auto [snrQuarters, rssi, raw] = Protocol::LogRxDataPush::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
+    Q_EMIT logRxDataPush(snrQuarters / 4.0, rssi, raw.toByteArray());
 }
 
 void MeshCoreConnection::handleTelemetryResponsePush(BufferReader &reader)
 {
-    reader.skip(1);  // reserved
-    QByteArray pubKeyPrefix = reader.readBytes(6);
-    QByteArray lppData = reader.readRemainingBytes();
+    auto [pubKeyPrefix, lppData] = Protocol::TelemetryResponsePush::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
 
-    TelemetryData telemetry = TelemetryData::fromLppData(pubKeyPrefix, lppData);
+    TelemetryData telemetry = TelemetryData::fromLppData(pubKeyPrefix.toByteArray(), lppData);
     Q_EMIT telemetryResponsePush(telemetry);
 }
 
 void MeshCoreConnection::handleTraceDataPush(BufferReader &reader)
 {
-    reader.skip(1);  // reserved
-    quint8 pathLen = reader.readUInt8();
-    quint8 flags = reader.readUInt8();
-    quint32 tag = reader.readUInt32LE();
-    quint32 authCode = reader.readUInt32LE();
+    auto [pathLen, flags, tag, authCode] = Protocol::TraceDataHeader::decode(reader);
     QByteArray pathHashes = reader.readBytes(pathLen);
     QByteArray pathSnrs = reader.readBytes(pathLen);
     qint8 lastSnr = reader.readInt8();
 
+    if (reader.hasError()) {
+        return;
+    }
+
     TraceData trace(pathLen, flags, tag, authCode, pathHashes, pathSnrs, lastSnr);
     Q_EMIT traceDataPush(trace);
 }
 
 void MeshCoreConnection::handleBinaryResponsePush(BufferReader &reader)
 {
-    reader.skip(1);  // reserved
-    quint32 tag = reader.readUInt32LE();
-    QByteArray responseData = reader.readRemainingBytes();
-    Q_EMIT binaryResponsePush(tag, responseData);
+    auto [tag, responseData] = Protocol::BinaryResponsePush::decode(reader);
+
+    if (reader.hasError()) {
+        return;
+    }
+
+    Q_EMIT binaryResponsePush(tag, responseData.toByteArray());
 }
 
 // Command implementations
-void MeshCoreConnection::sendCommandAppStart(const QString &appName)
+quint32 MeshCoreConnection::sendCommandAppStart(const QString &appName)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::AppStart));
-    writer.writeByte(1);  // appVer
-    writer.writeBytes(QByteArray(6, '\0'));  // reserved
-    writer.writeString(appName);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::AppStart::encode(1, appName));  // appVer 1
 }
 
-void MeshCoreConnection::sendCommandSendTxtMsg(TxtType txtType, quint8 attempt,
+quint32 MeshCoreConnection::sendCommandSendTxtMsg(TxtType txtType, quint8 attempt,
                                                 quint32 senderTimestamp,
                                                 const QByteArray &pubKeyPrefix,
                                                 const QString &text)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SendTxtMsg));
-    writer.writeByte(static_cast<quint8>(txtType));
-    writer.writeByte(attempt);
-    writer.writeUInt32LE(senderTimestamp);
-    writer.writeBytes(pubKeyPrefix.left(6));
-    writer.writeString(text);
-    sendToRadioFrame(writer.toByteArray());
+    // A full key is cut to its prefix, as before; a shorter one would address another contact
+    if (pubKeyPrefix.size() < Protocol::PublicKeyPrefixSize) {
+        qWarning() << "SendTxtMsg not sent: expected at least" << Protocol::PublicKeyPrefixSize
+                   << "key prefix bytes, got" << pubKeyPrefix.size();
+        return 0;
+    }
+    return m_commandPipeline.enqueue(Protocol::SendTxtMsg::encode(txtType, attempt, senderTimestamp,
+                                                  pubKeyPrefix, text));
 }
 
-void MeshCoreConnection::sendCommandSendChannelTxtMsg(TxtType txtType, quint8 channelIdx,
+quint32 MeshCoreConnection::sendCommandSendChannelTxtMsg(TxtType txtType, quint8 channelIdx,
                                                        quint32 senderTimestamp,
                                                        const QString &text)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SendChannelTxtMsg));
-    writer.writeByte(static_cast<quint8>(txtType));
-    writer.writeByte(channelIdx);
-    writer.writeUInt32LE(senderTimestamp);
-    writer.writeString(text);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SendChannelTxtMsg::encode(txtType, channelIdx, senderTimestamp, text));
 }
 
-void MeshCoreConnection::sendCommandGetContacts(quint32 since)
+quint32 MeshCoreConnection::sendCommandGetContacts(quint32 since)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::GetContacts));
     if (since > 0) {
-        writer.writeUInt32LE(since);
+        return m_commandPipeline.enqueue(Protocol::GetContactsSince::encode(since));
+    } else {
+        return m_commandPipeline.enqueue(Protocol::GetContacts::encode());
     }
-    sendToRadioFrame(writer.toByteArray());
 }
 
-void MeshCoreConnection::sendCommandGetDeviceTime()
+quint32 MeshCoreConnection::sendCommandGetDeviceTime()
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::GetDeviceTime));
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::GetDeviceTime::encode());
 }
 
-void MeshCoreConnection::sendCommandSetDeviceTime(quint32 epochSecs)
+quint32 MeshCoreConnection::sendCommandSetDeviceTime(quint32 epochSecs)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SetDeviceTime));
-    writer.writeUInt32LE(epochSecs);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SetDeviceTime::encode(epochSecs));
 }
 
-void MeshCoreConnection::sendCommandSendSelfAdvert(SelfAdvertType type)
+quint32 MeshCoreConnection::sendCommandSendSelfAdvert(SelfAdvertType type)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SendSelfAdvert));
-    writer.writeByte(static_cast<quint8>(type));
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SendSelfAdvert::encode(type));
 }
 
-void MeshCoreConnection::sendCommandSetAdvertName(const QString &name)
+quint32 MeshCoreConnection::sendCommandSetAdvertName(const QString &name)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SetAdvertName));
-    writer.writeString(name);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SetAdvertName::encode(name));
 }
 
-void MeshCoreConnection::sendCommandAddUpdateContact(const QByteArray &publicKey,
+quint32 MeshCoreConnection::sendCommandAddUpdateContact(const QByteArray &publicKey,
                                                       AdvertType type, quint8 flags,
                                                       qint8 outPathLen,
                                                       const QByteArray &outPath,
@@ -501,247 +575,179 @@ void MeshCoreConnection::sendCommandAddUpdateContact(const QByteArray &publicKey
                                                       quint32 lastAdvert,
                                                       qint32 advLat, qint32 advLon)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::AddUpdateContact));
-    writer.writeBytes(publicKey);
-    writer.writeByte(static_cast<quint8>(type));
-    writer.writeByte(flags);
-    writer.writeInt8(outPathLen);
-
-    // Ensure outPath is 64 bytes
-    QByteArray paddedPath = outPath;
-    paddedPath.resize(64);
-    writer.writeBytes(paddedPath);
-
-    writer.writeCString(advName, 32);
-    writer.writeUInt32LE(lastAdvert);
-    writer.writeUInt32LE(static_cast<quint32>(advLat));
-    writer.writeUInt32LE(static_cast<quint32>(advLon));
-    sendToRadioFrame(writer.toByteArray());
+    if (!hasLength("AddUpdateContact", publicKey, Protocol::PublicKeySize)) {
+        return 0;
+    }
+    // outPath is zero-padded to the full 64-byte field
+    return m_commandPipeline.enqueue(Protocol::AddUpdateContact::encode(publicKey, type, flags, outPathLen, outPath,
+                                                        advName, lastAdvert, advLat, advLon));
 }
 
-void MeshCoreConnection::sendCommandSyncNextMessage()
+quint32 MeshCoreConnection::sendCommandSyncNextMessage()
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SyncNextMessage));
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SyncNextMessage::encode());
 }
 
-void MeshCoreConnection::sendCommandSetRadioParams(quint32 radioFreq, quint32 radioBw,
+quint32 MeshCoreConnection::sendCommandSetRadioParams(quint32 radioFreq, quint32 radioBw,
                                                     quint8 radioSf, quint8 radioCr)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SetRadioParams));
-    writer.writeUInt32LE(radioFreq);
-    writer.writeUInt32LE(radioBw);
-    writer.writeByte(radioSf);
-    writer.writeByte(radioCr);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SetRadioParams::encode(radioFreq, radioBw, radioSf, radioCr));
 }
 
-void MeshCoreConnection::sendCommandSetTxPower(quint8 txPower)
+quint32 MeshCoreConnection::sendCommandSetTxPower(quint8 txPower)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SetTxPower));
-    writer.writeByte(txPower);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SetTxPower::encode(txPower));
 }
 
-void MeshCoreConnection::sendCommandResetPath(const QByteArray &pubKey)
+quint32 MeshCoreConnection::sendCommandResetPath(const QByteArray &pubKey)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::ResetPath));
-    writer.writeBytes(pubKey);
-    sendToRadioFrame(writer.toByteArray());
+    if (!hasLength("ResetPath", pubKey, Protocol::PublicKeySize)) {
+        return 0;
+    }
+    return m_commandPipeline.enqueue(Protocol::ResetPath::encode(pubKey));
 }
 
-void MeshCoreConnection::sendCommandSetAdvertLatLon(qint32 lat, qint32 lon)
+quint32 MeshCoreConnection::sendCommandSetAdvertLatLon(qint32 lat, qint32 lon)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SetAdvertLatLon));
-    writer.writeInt32LE(lat);
-    writer.writeInt32LE(lon);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SetAdvertLatLon::encode(lat, lon));
 }
 
-void MeshCoreConnection::sendCommandRemoveContact(const QByteArray &pubKey)
+quint32 MeshCoreConnection::sendCommandRemoveContact(const QByteArray &pubKey)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::RemoveContact));
-    writer.writeBytes(pubKey);
-    sendToRadioFrame(writer.toByteArray());
+    if (!hasLength("RemoveContact", pubKey, Protocol::PublicKeySize)) {
+        return 0;
+    }
+    return m_commandPipeline.enqueue(Protocol::RemoveContact::encode(pubKey));
 }
 
-void MeshCoreConnection::sendCommandShareContact(const QByteArray &pubKey)
+quint32 MeshCoreConnection::sendCommandShareContact(const QByteArray &pubKey)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::ShareContact));
-    writer.writeBytes(pubKey);
-    sendToRadioFrame(writer.toByteArray());
+    if (!hasLength("ShareContact", pubKey, Protocol::PublicKeySize)) {
+        return 0;
+    }
+    return m_commandPipeline.enqueue(Protocol::ShareContact::encode(pubKey));
 }
 
-void MeshCoreConnection::sendCommandExportContact(const QByteArray &pubKey)
+quint32 MeshCoreConnection::sendCommandExportContact(const QByteArray &pubKey)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::ExportContact));
-    if (!pubKey.isEmpty()) {
-        writer.writeBytes(pubKey);
+    // Without a key the device exports its own advert
+    if (pubKey.isEmpty()) {
+        return m_commandPipeline.enqueue(Protocol::ExportSelf::encode());
+    } else if (!hasLength("ExportContact", pubKey, Protocol::PublicKeySize)) {
+        return 0;
+    } else {
+        return m_commandPipeline.enqueue(Protocol::ExportContact::encode(pubKey));
     }
-    sendToRadioFrame(writer.toByteArray());
 }
 
-void MeshCoreConnection::sendCommandImportContact(const QByteArray &advertPacketBytes)
+quint32 MeshCoreConnection::sendCommandImportContact(const QByteArray &advertPacketBytes)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::ImportContact));
-    writer.writeBytes(advertPacketBytes);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::ImportContact::encode(advertPacketBytes));
 }
 
-void MeshCoreConnection::sendCommandReboot()
+quint32 MeshCoreConnection::sendCommandReboot()
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::Reboot));
-    writer.writeString(QStringLiteral("reboot"));
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::Reboot::encode(QStringLiteral("reboot")));
 }
 
-void MeshCoreConnection::sendCommandGetBatteryVoltage()
+quint32 MeshCoreConnection::sendCommandGetBatteryVoltage()
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::GetBatteryVoltage));
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::GetBatteryVoltage::encode());
 }
 
-void MeshCoreConnection::sendCommandDeviceQuery(quint8 appTargetVer)
+quint32 MeshCoreConnection::sendCommandDeviceQuery(quint8 appTargetVer)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::DeviceQuery));
-    writer.writeByte(appTargetVer);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::DeviceQuery::encode(appTargetVer));
 }
 
-void MeshCoreConnection::sendCommandExportPrivateKey()
+quint32 MeshCoreConnection::sendCommandExportPrivateKey()
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::ExportPrivateKey));
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::ExportPrivateKey::encode());
 }
 
-void MeshCoreConnection::sendCommandImportPrivateKey(const QByteArray &privateKey)
+quint32 MeshCoreConnection::sendCommandImportPrivateKey(const QByteArray &privateKey)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::ImportPrivateKey));
-    writer.writeBytes(privateKey);
-    sendToRadioFrame(writer.toByteArray());
+    if (!hasLength("ImportPrivateKey", privateKey, Protocol::PrivateKeySize)) {
+        return 0;
+    }
+    return m_commandPipeline.enqueue(Protocol::ImportPrivateKey::encode(privateKey));
 }
 
-void MeshCoreConnection::sendCommandSendRawData(const QByteArray &path, const QByteArray &rawData)
+quint32 MeshCoreConnection::sendCommandSendRawData(const QByteArray &path, const QByteArray &rawData)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SendRawData));
-    writer.writeByte(static_cast<quint8>(path.size()));
-    writer.writeBytes(path);
-    writer.writeBytes(rawData);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SendRawData::encode(path, rawData));
 }
 
-void MeshCoreConnection::sendCommandSendLogin(const QByteArray &publicKey, const QString &password)
+quint32 MeshCoreConnection::sendCommandSendLogin(const QByteArray &publicKey, const QString &password)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SendLogin));
-    writer.writeBytes(publicKey);
-    writer.writeString(password.left(15));  // max 15 chars
-    sendToRadioFrame(writer.toByteArray());
+    if (!hasLength("SendLogin", publicKey, Protocol::PublicKeySize)) {
+        return 0;
+    }
+    return m_commandPipeline.enqueue(Protocol::SendLogin::encode(publicKey, password.left(15)));  // max 15 chars
 }
 
-void MeshCoreConnection::sendCommandSendStatusReq(const QByteArray &publicKey)
+quint32 MeshCoreConnection::sendCommandSendStatusReq(const QByteArray &publicKey)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SendStatusReq));
-    writer.writeBytes(publicKey);
-    sendToRadioFrame(writer.toByteArray());
+    if (!hasLength("SendStatusReq", publicKey, Protocol::PublicKeySize)) {
+        return 0;
+    }
+    return m_commandPipeline.enqueue(Protocol::SendStatusReq::encode(publicKey));
 }
 
-void MeshCoreConnection::sendCommandSendTelemetryReq(const QByteArray &publicKey)
+quint32 MeshCoreConnection::sendCommandSendTelemetryReq(const QByteArray &publicKey)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SendTelemetryReq));
-    writer.writeByte(0);  // reserved
-    writer.writeByte(0);  // reserved
-    writer.writeByte(0);  // reserved
-    writer.writeBytes(publicKey);
-    sendToRadioFrame(writer.toByteArray());
+    if (!hasLength("SendTelemetryReq", publicKey, Protocol::PublicKeySize)) {
+        return 0;
+    }
+    return m_commandPipeline.enqueue(Protocol::SendTelemetryReq::encode(publicKey));
 }
 
-void MeshCoreConnection::sendCommandSendBinaryReq(const QByteArray &publicKey,
+quint32 MeshCoreConnection::sendCommandSendBinaryReq(const QByteArray &publicKey,
                                                    const QByteArray &requestCodeAndParams)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SendBinaryReq));
-    writer.writeBytes(publicKey);
-    writer.writeBytes(requestCodeAndParams);
-    sendToRadioFrame(writer.toByteArray());
+    if (!hasLength("SendBinaryReq", publicKey, Protocol::PublicKeySize)) {
+        return 0;
+    }
+    return m_commandPipeline.enqueue(Protocol::SendBinaryReq::encode(publicKey, requestCodeAndParams));
 }
 
-void MeshCoreConnection::sendCommandGetChannel(quint8 channelIdx)
+quint32 MeshCoreConnection::sendCommandGetChannel(quint8 channelIdx)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::GetChannel));
-    writer.writeByte(channelIdx);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::GetChannel::encode(channelIdx));
 }
 
-void MeshCoreConnection::sendCommandSetChannel(quint8 channelIdx, const QString &name,
+quint32 MeshCoreConnection::sendCommandSetChannel(quint8 channelIdx, const QString &name,
                                                 const QByteArray &secret)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SetChannel));
-    writer.writeByte(channelIdx);
-    writer.writeCString(name, 32);
-    writer.writeBytes(secret);
-    sendToRadioFrame(writer.toByteArray());
+    if (!hasLength("SetChannel", secret, Protocol::ChannelSecretSize)) {
+        return 0;
+    }
+    return m_commandPipeline.enqueue(Protocol::SetChannel::encode(channelIdx, name, secret));
 }
 
-void MeshCoreConnection::sendCommandSignStart()
+quint32 MeshCoreConnection::sendCommandSignStart()
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SignStart));
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SignStart::encode());
 }
 
-void MeshCoreConnection::sendCommandSignData(const QByteArray &dataToSign)
+quint32 MeshCoreConnection::sendCommandSignData(const QByteArray &dataToSign)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SignData));
-    writer.writeBytes(dataToSign);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SignData::encode(dataToSign));
 }
 
-void MeshCoreConnection::sendCommandSignFinish()
+quint32 MeshCoreConnection::sendCommandSignFinish()
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SignFinish));
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SignFinish::encode());
 }
 
-void MeshCoreConnection::sendCommandSendTracePath(quint32 tag, quint32 auth, const QByteArray &path)
+quint32 MeshCoreConnection::sendCommandSendTracePath(quint32 tag, quint32 auth, const QByteArray &path)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SendTracePath));
-    writer.writeUInt32LE(tag);
-    writer.writeUInt32LE(auth);
-    writer.writeByte(0);  // flags
-    writer.writeBytes(path);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SendTracePath::encode(tag, auth, 0, path));  // flags 0
 }
 
-void MeshCoreConnection::sendCommandSetOtherParams(bool manualAddContacts)
+quint32 MeshCoreConnection::sendCommandSetOtherParams(bool manualAddContacts)
 {
-    BufferWriter writer;
-    writer.writeByte(static_cast<quint8>(CommandCode::SetOtherParams));
-    writer.writeByte(manualAddContacts ? 1 : 0);
-    sendToRadioFrame(writer.toByteArray());
+    return m_commandPipeline.enqueue(Protocol::SetOtherParams::encode(manualAddContacts ? 1 : 0));
 }
 
 } // namespace MeshCore
@@ -3,9 +3,12 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QByteArrayView>
+#include <QLoggingCategory>
 #include <QMutex>
 #include <QWaitCondition>
 #include <QTimer>
+#include <array>
 #include <functional>
 
 #include "../MeshCoreConstants.h"
@@ -18,9 +21,14 @@
 #include "../types/RepeaterStats.h"
 #include "../types/TraceData.h"
 #include "../types/TelemetryData.h"
+#include "CommandPipeline.h"
+
+// Per-frame hex dumps; off by default, enable with QT_LOGGING_RULES="qmeshcore.frames.debug=true"
+Q_DECLARE_LOGGING_CATEGORY(lcFrames)
 
 namespace MeshCore {
 
+class BufferReader;
 class BufferWriter;
 
 /**
@@ -44,6 +52,15 @@ public:
     // Abstract methods for subclasses
     virtual void close() = 0;
 
+    // Frame statistics (number of frames received per leading code byte)
+    [[nodiscard]] quint64 frameCount(quint8 code) const { return m_frameCounts[code]; }
+    [[nodiscard]] quint64 unhandledFrameCount() const { return m_unhandledFrameCount; }
+    [[nodiscard]] quint64 malformedFrameCount() const { return m_malformedFrameCount; }
+    void resetFrameCounts();
+
+    // Outgoing command queue; reports completion, timeouts and latency per command
+    [[nodiscard]] CommandPipeline *commandPipeline() { return &m_commandPipeline; }
+
 Q_SIGNALS:
     // Connection state
     void connected();
@@ -90,47 +107,49 @@ Q_SIGNALS:
     void binaryResponsePush(quint32 tag, const QByteArray &responseData);
 
 public Q_SLOTS:
-    // Low-level command methods (send raw commands)
-    void sendCommandAppStart(const QString &appName = QStringLiteral("QMeshCore"));
-    void sendCommandSendTxtMsg(TxtType txtType, quint8 attempt, quint32 senderTimestamp,
+    // Low-level command methods. Each returns the id that
+    // CommandPipeline::commandFinished reports for the command, or 0 when
+    // a key or secret of the wrong length kept it from being sent.
+    quint32 sendCommandAppStart(const QString &appName = QStringLiteral("QMeshCore"));
+    quint32 sendCommandSendTxtMsg(TxtType txtType, quint8 attempt, quint32 senderTimestamp,
                                const QByteArray &pubKeyPrefix, const QString &text);
-    void sendCommandSendChannelTxtMsg(TxtType txtType, quint8 channelIdx,
+    quint32 sendCommandSendChannelTxtMsg(TxtType txtType, quint8 channelIdx,
                                       quint32 senderTimestamp, const QString &text);
-    void sendCommandGetContacts(quint32 since = 0);
-    void sendCommandGetDeviceTime();
-    void sendCommandSetDeviceTime(quint32 epochSecs);
-    void sendCommandSendSelfAdvert(SelfAdvertType type);
-    void sendCommandSetAdvertName(const QString &name);
-    void sendCommandAddUpdateContact(const QByteArray &publicKey, AdvertType type, quint8 flags,
+    quint32 sendCommandGetContacts(quint32 since = 0);
+    quint32 sendCommandGetDeviceTime();
+    quint32 sendCommandSetDeviceTime(quint32 epochSecs);
+    quint32 sendCommandSendSelfAdvert(SelfAdvertType type);
+    quint32 sendCommandSetAdvertName(const QString &name);
+    quint32 sendCommandAddUpdateContact(const QByteArray &publicKey, AdvertType type, quint8 flags,
                                      qint8 outPathLen, const QByteArray &outPath,
                                      const QString &advName, quint32 lastAdvert,
                                      qint32 advLat, qint32 advLon);
-    void sendCommandSyncNextMessage();
-    void sendCommandSetRadioParams(quint32 radioFreq, quint32 radioBw, quint8 radioSf, quint8 radioCr);
-    void sendCommandSetTxPower(quint8 txPower);
-    void sendCommandResetPath(const QByteArray &pubKey);
-    void sendCommandSetAdvertLatLon(qint32 lat, qint32 lon);
-    void sendCommandRemoveContact(const QByteArray &pubKey);
-    void sendCommandShareContact(const QByteArray &pubKey);
-    void sendCommandExportContact(const QByteArray &pubKey = QByteArray());
-    void sendCommandImportContact(const QByteArray &advertPacketBytes);
-    void sendCommandReboot();
-    void sendCommandGetBatteryVoltage();
-    void sendCommandDeviceQuery(quint8 appTargetVer);
-    void sendCommandExportPrivateKey();
-    void sendCommandImportPrivateKey(const QByteArray &privateKey);
-    void sendCommandSendRawData(const QByteArray &path, const QByteArray &rawData);
-    void sendCommandSendLogin(const QByteArray &publicKey, const QString &password);
-    void sendCommandSendStatusReq(const QByteArray &publicKey);
-    void sendCommandSendTelemetryReq(const QByteArray &publicKey);
-    void sendCommandSendBinaryReq(const QByteArray &publicKey, const QByteArray &requestCodeAndParams);
-    void sendCommandGetChannel(quint8 channelIdx);
-    void sendCommandSetChannel(quint8 channelIdx, const QString &name, const QByteArray &secret);
-    void sendCommandSignStart();
-    void sendCommandSignData(const QByteArray &dataToSign);
-    void sendCommandSignFinish();
-    void sendCommandSendTracePath(quint32 tag, quint32 auth, const QByteArray &path);
-    void sendCommandSetOtherParams(bool manualAddContacts);
+    quint32 sendCommandSyncNextMessage();
+    quint32 sendCommandSetRadioParams(quint32 radioFreq, quint32 radioBw, quint8 radioSf, quint8 radioCr);
+    quint32 sendCommandSetTxPower(quint8 txPower);
+    quint32 sendCommandResetPath(const QByteArray &pubKey);
+    quint32 sendCommandSetAdvertLatLon(qint32 lat, qint32 lon);
+    quint32 sendCommandRemoveContact(const QByteArray &pubKey);
+    quint32 sendCommandShareContact(const QByteArray &pubKey);
+    quint32 sendCommandExportContact(const QByteArray &pubKey = QByteArray());
+    quint32 sendCommandImportContact(const QByteArray &advertPacketBytes);
+    quint32 sendCommandReboot();
+    quint32 sendCommandGetBatteryVoltage();
+    quint32 sendCommandDeviceQuery(quint8 appTargetVer);
+    quint32 sendCommandExportPrivateKey();
+    quint32 sendCommandImportPrivateKey(const QByteArray &privateKey);
+    quint32 sendCommandSendRawData(const QByteArray &path, const QByteArray &rawData);
+    quint32 sendCommandSendLogin(const QByteArray &publicKey, const QString &password);
+    quint32 sendCommandSendStatusReq(const QByteArray &publicKey);
+    quint32 sendCommandSendTelemetryReq(const QByteArray &publicKey);
+    quint32 sendCommandSendBinaryReq(const QByteArray &publicKey, const QByteArray &requestCodeAndParams);
+    quint32 sendCommandGetChannel(quint8 channelIdx);
+    quint32 sendCommandSetChannel(quint8 channelIdx, const QString &name, const QByteArray &secret);
+    quint32 sendCommandSignStart();
+    quint32 sendCommandSignData(const QByteArray &dataToSign);
+    quint32 sendCommandSignFinish();
+    quint32 sendCommandSendTracePath(quint32 tag, quint32 auth, const QByteArray &path);
+    quint32 sendCommandSetOtherParams(bool manualAddContacts);
 
 protected:
     // For subclasses to implement
@@ -140,12 +159,27 @@ protected:
     void onConnected();
     void onDisconnected();
 
-    // Call this when a frame is received from the device
-    void onFrameReceived(const QByteArray &frame);
+    // Call this when a frame is received from the device. The frame only
+    // needs to stay valid for the duration of the call.
+    void onFrameReceived(QByteArrayView frame);
 
     bool m_connected = false;
 
 private:
+    // Frame dispatch table, indexed by the first byte of a received frame
+    using FrameHandler = void (MeshCoreConnection::*)(BufferReader &reader);
+    static constexpr std::array<FrameHandler, 256> buildFrameHandlers();
+    static const std::array<FrameHandler, 256> s_frameHandlers;
+
+    CommandPipeline m_commandPipeline{[this](const QByteArray &frame) { sendToRadioFrame(frame); }, this};
+
+    std::array<quint64, 256> m_frameCounts{};
+    quint64 m_unhandledFrameCount = 0;
+    quint64 m_malformedFrameCount = 0;
+
+    // Decodes the contact layout shared by Contact responses and NewAdvert pushes
+    Contact readContactRecord(class BufferReader &reader);
+
     // Response handlers
     void handleOkResponse(class BufferReader &reader);
     void handleErrorResponse(class BufferReader &reader);
@@ -593,7 +593,7 @@ void NusBleConnection::onCharacteristicChanged(const QLowEnergyCharacteristic &c
                                                 const QByteArray &value)
 {
     if (characteristic.uuid() == Ble::CharacteristicUuidTx) {
-        qDebug() << "NUS BLE: Received notification:" << value.size() << "bytes:" << value.toHex();
+        qCDebug(lcFrames) << "NUS BLE: Received notification:" << value.size() << "bytes:" << value.toHex();
         // BLE receives raw protocol data - no frame header to strip
         onFrameReceived(value);
     }
@@ -747,7 +747,7 @@ void NusBleConnection::sendToRadioFrame(const QByteArray &frame)
         return;
     }
 
-    qDebug() << "NUS BLE: Sending frame:" << frame.size() << "bytes:" << frame.toHex();
+    qCDebug(lcFrames) << "NUS BLE: Sending frame:" << frame.size() << "bytes:" << frame.toHex();
     Q_EMIT frameSent(frame);
 
     // For BLE, we send raw data without the serial frame header
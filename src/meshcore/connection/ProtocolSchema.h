@@ -0,0 +1,252 @@
+#ifndef PROTOCOLSCHEMA_H
+#define PROTOCOLSCHEMA_H
+
+#include "../MeshCoreConstants.h"
+#include "../utils/FrameSchema.h"
+
+namespace MeshCore {
+
+/**
+ * @brief Companion protocol frame layouts
+ *
+ * Each command frame (app -> radio) and each response/push payload
+ * (radio -> app) is declared once here. MeshCoreConnection encodes and
+ * decodes exclusively through these declarations.
+ *
+ * Response layouts describe the payload after the code byte, which has
+ * already been consumed by the frame dispatcher.
+ */
+namespace Protocol {
+
+using namespace Schema;
+
+// Size of a full public key and of the prefix used to address messages
+inline constexpr qsizetype PublicKeySize = 32;
+inline constexpr qsizetype PublicKeyPrefixSize = 6;
+inline constexpr qsizetype PrivateKeySize = 64;
+inline constexpr qsizetype ChannelSecretSize = 16;
+inline constexpr qsizetype MaxPathSize = 64;
+inline constexpr qsizetype MaxNameSize = 32;
+
+using PublicKey = Bytes<PublicKeySize>;
+using PublicKeyPrefix = Bytes<PublicKeyPrefixSize>;
+
+// Commands
+
+using AppStart = Frame<CommandCode::AppStart,
+                       UInt8,        // appVer
+                       Reserved<6>,
+                       Utf8Tail>;    // appName
+
+using SendTxtMsg = Frame<CommandCode::SendTxtMsg,
+                         Enum<TxtType>,
+                         UInt8,           // attempt
+                         UInt32,          // senderTimestamp
+                         PublicKeyPrefix,
+                         Utf8Tail>;       // text
+
+using SendChannelTxtMsg = Frame<CommandCode::SendChannelTxtMsg,
+                                Enum<TxtType>,
+                                UInt8,      // channelIdx
+                                UInt32,     // senderTimestamp
+                                Utf8Tail>;  // text
+
+using GetContacts = Frame<CommandCode::GetContacts>;
+using GetContactsSince = Frame<CommandCode::GetContacts, UInt32>;  // since (lastMod)
+
+using GetDeviceTime = Frame<CommandCode::GetDeviceTime>;
+using SetDeviceTime = Frame<CommandCode::SetDeviceTime, UInt32>;  // epochSecs
+
+using SendSelfAdvert = Frame<CommandCode::SendSelfAdvert, Enum<SelfAdvertType>>;
+using SetAdvertName = Frame<CommandCode::SetAdvertName, Utf8Tail>;
+
+// Same fields as ContactRecord below, without the trailing lastMod
+using AddUpdateContact = Frame<CommandCode::AddUpdateContact,
+                               PublicKey,
+                               Enum<AdvertType>,
+                               UInt8,                // flags
+                               Int8,                 // outPathLen
+                               Bytes<MaxPathSize>,   // outPath
+                               CString<MaxNameSize>, // advName
+                               UInt32,               // lastAdvert
+                               Int32,                // advLat
+                               Int32>;               // advLon
+
+using SyncNextMessage = Frame<CommandCode::SyncNextMessage>;
+
+using SetRadioParams = Frame<CommandCode::SetRadioParams,
+                             UInt32,   // radioFreq
+                             UInt32,   // radioBw
+                             UInt8,    // radioSf
+                             UInt8>;   // radioCr
+
+using SetTxPower = Frame<CommandCode::SetTxPower, UInt8>;
+using ResetPath = Frame<CommandCode::ResetPath, PublicKey>;
+using SetAdvertLatLon = Frame<CommandCode::SetAdvertLatLon, Int32, Int32>;
+using RemoveContact = Frame<CommandCode::RemoveContact, PublicKey>;
+using ShareContact = Frame<CommandCode::ShareContact, PublicKey>;
+using ExportSelf = Frame<CommandCode::ExportContact>;
+using ExportContact = Frame<CommandCode::ExportContact, PublicKey>;
+using ImportContact = Frame<CommandCode::ImportContact, Tail>;  // advert packet
+using Reboot = Frame<CommandCode::Reboot, Utf8Tail>;            // "reboot"
+using GetBatteryVoltage = Frame<CommandCode::GetBatteryVoltage>;
+using DeviceQuery = Frame<CommandCode::DeviceQuery, UInt8>;     // appTargetVer
+using ExportPrivateKey = Frame<CommandCode::ExportPrivateKey>;
+using ImportPrivateKey = Frame<CommandCode::ImportPrivateKey, Bytes<PrivateKeySize>>;
+
+using SendRawData = Frame<CommandCode::SendRawData,
+                          UInt8Prefixed,   // path
+                          Tail>;           // rawData
+
+using SendLogin = Frame<CommandCode::SendLogin, PublicKey, Utf8Tail>;  // password
+using SendStatusReq = Frame<CommandCode::SendStatusReq, PublicKey>;
+using SendTelemetryReq = Frame<CommandCode::SendTelemetryReq, Reserved<3>, PublicKey>;
+using SendBinaryReq = Frame<CommandCode::SendBinaryReq, PublicKey, Tail>;  // request code + params
+
+using GetChannel = Frame<CommandCode::GetChannel, UInt8>;  // channelIdx
+using SetChannel = Frame<CommandCode::SetChannel,
+                         UInt8,                 // channelIdx
+                         CString<MaxNameSize>,  // name
+                         Bytes<ChannelSecretSize>>;  // secret
+
+using SignStart = Frame<CommandCode::SignStart>;
+using SignData = Frame<CommandCode::SignData, Tail>;
+using SignFinish = Frame<CommandCode::SignFinish>;
+
+using SendTracePath = Frame<CommandCode::SendTracePath,
+                            UInt32,   // tag
+                            UInt32,   // auth
+                            UInt8,    // flags
+                            Tail>;    // path
+
+using SetOtherParams = Frame<CommandCode::SetOtherParams, UInt8>;  // manualAddContacts
+
+// Responses
+
+using ErrorResponse = Layout<Tail>;  // optional error code byte
+
+using SelfInfoResponse = Layout<Enum<AdvertType>,
+                                UInt8,      // txPower
+                                UInt8,      // maxTxPower
+                                PublicKey,
+                                Int32,      // advLat
+                                Int32,      // advLon
+                                Reserved<3>,
+                                UInt8,      // manualAddContacts
+                                UInt32,     // radioFreq
+                                UInt32,     // radioBw
+                                UInt8,      // radioSf
+                                UInt8,      // radioCr
+                                Utf8Tail>;  // name
+
+using DeviceInfoResponse = Layout<Int8,         // firmwareVer
+                                  Reserved<6>,
+                                  CString<12>,  // firmwareBuildDate
+                                  Utf8Tail>;    // manufacturerModel
+
+using ContactsStartResponse = Layout<UInt32>;  // count
+
+// Shared by the Contact response and the NewAdvert push
+using ContactRecord = Layout<PublicKey,
+                             Enum<AdvertType>,
+                             UInt8,                 // flags
+                             Int8,                  // outPathLen
+                             Bytes<MaxPathSize>,    // outPath
+                             CString<MaxNameSize>,  // advName
+                             UInt32,                // lastAdvert
+                             Int32,                 // advLat
+                             Int32,                 // advLon
+                             UInt32>;               // lastMod
+
+static_assert(AddUpdateContact::fixedSize == 1 + ContactRecord::fixedSize - 4,
+              "AddUpdateContact must mirror ContactRecord without lastMod");
+
+using EndOfContactsResponse = Layout<UInt32>;  // mostRecentLastMod
+
+using SentResponse = Layout<Int8,     // result
+                            UInt32,   // expectedAckCrc
+                            UInt32>;  // estTimeout
+
+using ContactMsgRecvResponse = Layout<PublicKeyPrefix,
+                                      UInt8,      // pathLen
+                                      Enum<TxtType>,
+                                      UInt32,     // senderTimestamp
+                                      Utf8Tail>;  // text
+
+using ChannelMsgRecvResponse = Layout<Int8,       // channelIdx
+                                      UInt8,      // pathLen
+                                      Enum<TxtType>,
+                                      UInt32,     // senderTimestamp
+                                      Utf8Tail>;  // text
+
+using CurrentTimeResponse = Layout<UInt32>;      // epochSecs
+using ExportContactResponse = Layout<Tail>;      // advert packet
+using BatteryVoltageResponse = Layout<UInt16>;   // milliVolts
+using PrivateKeyResponse = Layout<Bytes<PrivateKeySize>>;
+
+using ChannelInfoResponse = Layout<UInt8,                 // idx
+                                   CString<MaxNameSize>,  // name
+                                   Tail>;                 // secret, 16 bytes when present
+
+using SignStartResponse = Layout<Reserved<1>, UInt32>;  // maxSignDataLen
+using SignatureResponse = Layout<Bytes<64>>;
+
+// Pushes
+
+using AdvertPush = Layout<PublicKey>;
+using PathUpdatedPush = Layout<PublicKey>;
+
+using SendConfirmedPush = Layout<UInt32,   // ackCode
+                                 UInt32>;  // roundTrip
+
+using RawDataPush = Layout<Int8,         // snr * 4
+                           Int8,         // rssi
+                           Reserved<1>,
+                           Tail>;        // payload
+
+using LoginSuccessPush = Layout<Reserved<1>, PublicKeyPrefix>;
+
+using StatusResponsePush = Layout<Reserved<1>,
+                                  PublicKeyPrefix,
+                                  Tail>;  // RepeaterStatsRecord
+
+using RepeaterStatsRecord = Layout<UInt16,   // batteryMilliVolts
+                                   UInt16,   // currentTxQueueLength
+                                   Int16,    // noiseFloor
+                                   Int16,    // lastRssi
+                                   UInt32,   // packetsReceived
+                                   UInt32,   // packetsSent
+                                   UInt32,   // totalAirTimeSecs
+                                   UInt32,   // totalUpTimeSecs
+                                   UInt32,   // sentFlood
+                                   UInt32,   // sentDirect
+                                   UInt32,   // receivedFlood
+                                   UInt32,   // receivedDirect
+                                   UInt16,   // errorEvents
+                                   Int16,    // lastSnr
+                                   UInt16,   // directDuplicates
+                                   UInt16>;  // floodDuplicates
+
+using LogRxDataPush = Layout<Int8,    // snr * 4
+                             Int8,    // rssi
+                             Tail>;   // raw packet
+
+using TelemetryResponsePush = Layout<Reserved<1>,
+                                     PublicKeyPrefix,
+                                     Tail>;  // Cayenne LPP data
+
+// Followed by pathLen hash bytes, pathLen SNR bytes and the final SNR
+using TraceDataHeader = Layout<Reserved<1>,
+                               UInt8,     // pathLen
+                               UInt8,     // flags
+                               UInt32,    // tag
+                               UInt32>;   // authCode
+
+using BinaryResponsePush = Layout<Reserved<1>,
+                                  UInt32,  // tag
+                                  Tail>;   // response data
+
+} // namespace Protocol
+} // namespace MeshCore
+
+#endif // PROTOCOLSCHEMA_H
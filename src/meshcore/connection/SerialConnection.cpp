@@ -1,12 +1,15 @@
 #include "SerialConnection.h"
 #include "../MeshCoreConstants.h"
 #include "../utils/BufferReader.h"
-#include "../utils/BufferWriter.h"
 #include <QDebug>
 #include <QThread>
+#include <QtEndian>
 
 namespace MeshCore {
 
+// Initial receive buffer capacity, enough for several maximum-size frames
+static constexpr qsizetype readBufferReserve = 8 * 1024;
+
 SerialConnection::SerialConnection(QObject *parent)
     : MeshCoreConnection(parent)
 {
@@ -56,6 +59,7 @@ void SerialConnection::connectToPort(const QSerialPortInfo &portInfo, qint32 bau
     // Clear any pending data
     m_serialPort->clear();
     m_readBuffer.clear();
+    m_readBuffer.reserve(readBufferReserve);
 
     qDebug() << "Serial connected to" << portInfo.portName();
     onConnected();
@@ -84,8 +88,12 @@ void SerialConnection::onReadyRead()
         return;
     }
 
-    QByteArray newData = m_serialPort->readAll();
-    m_readBuffer.append(newData);
+    processIncomingData(m_serialPort->readAll());
+}
+
+void SerialConnection::processIncomingData(QByteArrayView data)
+{
+    m_readBuffer.append(data);
     processReadBuffer();
 }
 
@@ -131,78 +139,101 @@ void SerialConnection::processReadBuffer()
 {
     // Frame format: [type:1][length:2LE][data:length]
     constexpr qsizetype frameHeaderLength = 3;
+    constexpr qsizetype maxFrameLength = 1024;
+
+    // Walk the buffer with a read offset and drop the consumed prefix once at
+    // the end, so a burst of frames in one readyRead costs a single move
+    // instead of one front-erase per frame or debug line.
+    qsizetype pos = 0;
+    {
+        // Keep the bytes alive while frames are handed out as views: a
+        // handler may close the connection, which clears m_readBuffer.
+        const QByteArray buffer = m_readBuffer;
+        const char *data = buffer.constData();
+        const qsizetype size = buffer.size();
+
+        while (size - pos >= frameHeaderLength) {
+            // Peek at frame header
+            quint8 frameType = static_cast<quint8>(data[pos]);
+
+            // Validate frame type - must be '>' (0x3e) for incoming or '<' (0x3c) for outgoing
+            if (frameType != SerialFrameTypes::Incoming && frameType != SerialFrameTypes::Outgoing) {
+                // Not a valid frame start - could be debug text from device.
+                // Scan once for whichever comes first: a frame marker or the end of the line.
+                qsizetype scan = pos;
+                while (scan < size && data[scan] != '\n'
+                       && static_cast<quint8>(data[scan]) != SerialFrameTypes::Incoming) {
+                    ++scan;
+                }
 
-    while (m_readBuffer.size() >= frameHeaderLength) {
-        // Peek at frame header
-        quint8 frameType = static_cast<quint8>(m_readBuffer.at(0));
-
-        // Validate frame type - must be '>' (0x3e) for incoming or '<' (0x3c) for outgoing
-        if (frameType != SerialFrameTypes::Incoming && frameType != SerialFrameTypes::Outgoing) {
-            // Not a valid frame start - could be debug text from device
-            // Skip until newline or valid frame marker
-            int newlinePos = m_readBuffer.indexOf('\n');
-            int frameMarkerPos = m_readBuffer.indexOf(static_cast<char>(SerialFrameTypes::Incoming));
-            
-            if (frameMarkerPos > 0 && (newlinePos < 0 || frameMarkerPos < newlinePos)) {
-                // Found a frame marker before newline, skip to it
-                QByteArray skipped = m_readBuffer.left(frameMarkerPos);
-                qDebug() << "Skipping non-frame data:" << skipped;
-                m_readBuffer.remove(0, frameMarkerPos);
-            } else if (newlinePos >= 0) {
-                // Skip the debug line including newline
-                QByteArray debugLine = m_readBuffer.left(newlinePos + 1);
-                // Only log if it looks like debug output
-                if (debugLine.contains("DEBUG") || debugLine.contains("INFO") || debugLine.contains("WARN")) {
-                    qDebug() << "Device debug:" << debugLine.trimmed();
+                if (scan == size) {
+                    // No newline yet, might be partial debug line - wait for more data
+                    // But limit buffer size to prevent infinite growth
+                    if (size - pos > maxFrameLength) {
+                        qDebug() << "Discarding oversized buffer without frame marker";
+                        pos = size;
+                    }
+                    break;
                 }
-                m_readBuffer.remove(0, newlinePos + 1);
-            } else {
-                // No newline yet, might be partial debug line - wait for more data
-                // But limit buffer size to prevent infinite growth
-                if (m_readBuffer.size() > 1024) {
-                    qDebug() << "Discarding oversized buffer without frame marker";
-                    m_readBuffer.clear();
+
+                if (data[scan] != '\n') {
+                    // Found a frame marker before newline, skip to it
+                    qDebug() << "Skipping non-frame data:" << QByteArrayView(data + pos, scan - pos);
+                } else {
+                    // Skip the debug line including newline
+                    QByteArrayView debugLine(data + pos, scan + 1 - pos);
+                    // Only log if it looks like debug output
+                    if (debugLine.contains("DEBUG") || debugLine.contains("INFO") || debugLine.contains("WARN")) {
+                        qDebug() << "Device debug:" << debugLine.trimmed();
+                    }
+                    ++scan;
                 }
-                break;
+                pos = scan;
+                continue;
             }
-            continue;
-        }
 
-        // Read frame length (little endian)
-        quint16 frameLength = static_cast<quint8>(m_readBuffer.at(1))
-                            | (static_cast<quint8>(m_readBuffer.at(2)) << 8);
+            // Read frame length (little endian)
+            quint16 frameLength = static_cast<quint8>(data[pos + 1])
+                                | (static_cast<quint8>(data[pos + 2]) << 8);
 
-        if (frameLength == 0 || frameLength > 1024) {
-            // Invalid length, skip this byte
-            qDebug() << "Invalid frame length:" << frameLength << ", skipping byte";
-            m_readBuffer.remove(0, 1);
-            continue;
-        }
+            if (frameLength == 0 || frameLength > maxFrameLength) {
+                // Invalid length, skip this byte
+                qDebug() << "Invalid frame length:" << frameLength << ", skipping byte";
+                ++pos;
+                continue;
+            }
 
-        // Check if we have the complete frame
-        qsizetype totalLength = frameHeaderLength + frameLength;
-        if (m_readBuffer.size() < totalLength) {
-            // Wait for more data
-            break;
-        }
+            // Check if we have the complete frame
+            qsizetype totalLength = frameHeaderLength + frameLength;
+            if (size - pos < totalLength) {
+                // Wait for more data
+                break;
+            }
 
-        // Extract frame data
-        QByteArray frameData = m_readBuffer.mid(frameHeaderLength, frameLength);
-        m_readBuffer.remove(0, totalLength);
+            // Hand the frame out as a view into the buffer
+            QByteArrayView frameData(data + pos + frameHeaderLength, frameLength);
+            pos += totalLength;
 
-        qDebug() << "Received frame type:" << Qt::hex << frameType 
-                 << "length:" << frameLength << "data:" << frameData.toHex();
+            qCDebug(lcFrames) << "Received frame type:" << Qt::hex << frameType
+                     << "length:" << frameLength << "data:" << frameData.toByteArray().toHex();
 
-        // Process the frame (only process incoming frames from device)
-        if (frameType == SerialFrameTypes::Incoming) {
-            onFrameReceived(frameData);
+            // Process the frame (only process incoming frames from device)
+            if (frameType == SerialFrameTypes::Incoming) {
+                onFrameReceived(frameData);
+                if (m_readBuffer.isEmpty()) {
+                    // Connection was closed while handling the frame
+                    return;
+                }
+            }
         }
     }
+
+    m_readBuffer.remove(0, pos);
 }
 
 void SerialConnection::sendToRadioFrame(const QByteArray &frame)
 {
-    qDebug() << "Serial sending frame:" << frame.size() << "bytes, data:" << frame.toHex();
+    qCDebug(lcFrames) << "Serial sending frame:" << frame.size() << "bytes, data:" << frame.toHex();
     Q_EMIT frameSent(frame);
     // Send as "app to radio" frame (0x3c = '<')
     writeFrame(SerialFrameTypes::Outgoing, frame);
@@ -215,16 +246,19 @@ void SerialConnection::writeFrame(quint8 frameType, const QByteArray &frameData)
         return;
     }
 
-    // Build frame: [type:1][length:2LE][data]
-    BufferWriter writer;
-    writer.writeByte(frameType);
-    writer.writeUInt16LE(static_cast<quint16>(frameData.size()));
-    writer.writeBytes(frameData);
-
-    QByteArray fullFrame = writer.toByteArray();
-    qDebug() << "Serial RAW TX:" << fullFrame.toHex(' ');
-    
-    qint64 written = m_serialPort->write(fullFrame);
+    // Frame is [type:1][length:2LE][data]. The header is built on the stack and
+    // written ahead of the payload; QSerialPort copies both into its own write
+    // buffer, so no combined frame needs to be allocated here
+    char header[3];
+    header[0] = static_cast<char>(frameType);
+    qToLittleEndian(static_cast<quint16>(frameData.size()), header + 1);
+    qCDebug(lcFrames) << "Serial RAW TX:" << QByteArray::fromRawData(header, sizeof(header)).toHex(' ')
+             << frameData.toHex(' ');
+
+    qint64 written = m_serialPort->write(header, sizeof(header));
+    if (written == sizeof(header)) {
+        written += m_serialPort->write(frameData);
+    }
     m_serialPort->flush();  // Ensure data is sent immediately
     qDebug() << "Serial wrote" << written << "bytes";
 }
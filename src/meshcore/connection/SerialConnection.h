@@ -43,6 +43,9 @@ public:
 protected:
     void sendToRadioFrame(const QByteArray &frame) override;
 
+    // Appends bytes read from the port and hands out every complete frame
+    void processIncomingData(QByteArrayView data);
+
 private Q_SLOTS:
     void onReadyRead();
     void onErrorOccurred(QSerialPort::SerialPortError error);
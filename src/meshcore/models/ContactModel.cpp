@@ -1,4 +1,6 @@
 #include "ContactModel.h"
+#include <QSet>
+#include <algorithm>
 
 namespace MeshCore {
 
@@ -88,32 +90,41 @@ Contact ContactModel::get(int index) const
 
 Contact ContactModel::findByName(const QString &name) const
 {
-    for (const auto &contact : m_contacts) {
-        if (contact.name() == name) {
-            return contact;
-        }
+    auto it = m_rowByName.constFind(name);
+    if (it == m_rowByName.constEnd()) {
+        return {};
     }
-    return {};
+    return m_contacts.at(*it);
 }
 
 Contact ContactModel::findByPublicKeyPrefix(const QByteArray &prefix) const
 {
-    for (const auto &contact : m_contacts) {
-        if (contact.publicKey().startsWith(prefix)) {
-            return contact;
+    // Ambiguous prefixes resolve to the lowest row, as a scan over the rows would
+    auto [first, last] = prefixRange(prefix);
+    int row = -1;
+    for (qsizetype i = first; i < last; ++i) {
+        int candidate = m_rowsByKey.at(i);
+        if (row < 0 || candidate < row) {
+            row = candidate;
         }
     }
-    return {};
+    return row < 0 ? Contact() : m_contacts.at(row);
 }
 
-int ContactModel::indexOf(const QByteArray &publicKey) const
+QList<Contact> ContactModel::findAllByPublicKeyPrefix(const QByteArray &prefix) const
 {
-    for (int i = 0; i < m_contacts.size(); ++i) {
-        if (m_contacts.at(i).publicKey() == publicKey) {
-            return i;
-        }
+    auto [first, last] = prefixRange(prefix);
+    QList<Contact> result;
+    result.reserve(last - first);
+    for (qsizetype i = first; i < last; ++i) {
+        result.append(m_contacts.at(m_rowsByKey.at(i)));
     }
-    return -1;
+    return result;
+}
+
+int ContactModel::indexOf(const QByteArray &publicKey) const
+{
+    return m_rowByKey.value(publicKey, -1);
 }
 
 void ContactModel::clear()
@@ -123,6 +134,9 @@ void ContactModel::clear()
     }
     beginResetModel();
     m_contacts.clear();
+    m_rowByKey.clear();
+    m_rowByName.clear();
+    m_rowsByKey.clear();
     endResetModel();
     Q_EMIT countChanged();
 }
@@ -132,12 +146,16 @@ void ContactModel::addContact(const Contact &contact)
     // Check if already exists
     int existingIdx = indexOf(contact.publicKey());
     if (existingIdx >= 0) {
-        updateContact(contact);
+        replaceRow(existingIdx, contact);
+        QModelIndex modelIdx = index(existingIdx);
+        Q_EMIT dataChanged(modelIdx, modelIdx);
         return;
     }
 
-    beginInsertRows(QModelIndex(), static_cast<int>(m_contacts.size()), static_cast<int>(m_contacts.size()));
+    int row = static_cast<int>(m_contacts.size());
+    beginInsertRows(QModelIndex(), row, row);
     m_contacts.append(contact);
+    indexAppendedRows(row);
     endInsertRows();
     Q_EMIT countChanged();
 }
@@ -148,10 +166,12 @@ void ContactModel::addContacts(const QList<Contact> &contacts)
         return;
     }
 
-    // Filter out duplicates
+    // Filter out duplicates, including repeats within the batch
     QList<Contact> newContacts;
+    QSet<QByteArray> batchKeys;
     for (const auto &contact : contacts) {
-        if (indexOf(contact.publicKey()) < 0) {
+        if (!m_rowByKey.contains(contact.publicKey()) && !batchKeys.contains(contact.publicKey())) {
+            batchKeys.insert(contact.publicKey());
             newContacts.append(contact);
         }
     }
@@ -165,10 +185,57 @@ void ContactModel::addContacts(const QList<Contact> &contacts)
 
     beginInsertRows(QModelIndex(), first, last);
     m_contacts.append(newContacts);
+    indexAppendedRows(first);
     endInsertRows();
     Q_EMIT countChanged();
 }
 
+void ContactModel::mergeContacts(const QList<Contact> &contacts)
+{
+    if (contacts.isEmpty()) {
+        return;
+    }
+
+    // Existing rows are updated in place and reported with one dataChanged
+    // covering the touched range; new contacts are inserted together
+    QList<Contact> newContacts;
+    QHash<QByteArray, qsizetype> newRows;
+    int firstChanged = static_cast<int>(m_contacts.size());
+    int lastChanged = -1;
+    for (const auto &contact : contacts) {
+        int row = indexOf(contact.publicKey());
+        if (row >= 0) {
+            replaceRow(row, contact);
+            firstChanged = qMin(firstChanged, row);
+            lastChanged = qMax(lastChanged, row);
+            continue;
+        }
+
+        auto it = newRows.constFind(contact.publicKey());
+        if (it == newRows.constEnd()) {
+            newRows.insert(contact.publicKey(), newContacts.size());
+            newContacts.append(contact);
+        } else {
+            newContacts[*it] = contact;
+        }
+    }
+
+    if (lastChanged >= 0) {
+        Q_EMIT dataChanged(index(firstChanged), index(lastChanged));
+    }
+
+    if (!newContacts.isEmpty()) {
+        int first = static_cast<int>(m_contacts.size());
+        int last = first + static_cast<int>(newContacts.size()) - 1;
+
+        beginInsertRows(QModelIndex(), first, last);
+        m_contacts.append(newContacts);
+        indexAppendedRows(first);
+        endInsertRows();
+        Q_EMIT countChanged();
+    }
+}
+
 void ContactModel::updateContact(const Contact &contact)
 {
     int idx = indexOf(contact.publicKey());
@@ -177,7 +244,7 @@ void ContactModel::updateContact(const Contact &contact)
         return;
     }
 
-    m_contacts[idx] = contact;
+    replaceRow(idx, contact);
     QModelIndex modelIdx = index(idx);
     Q_EMIT dataChanged(modelIdx, modelIdx);
 }
@@ -191,8 +258,100 @@ void ContactModel::removeContact(const QByteArray &publicKey)
 
     beginRemoveRows(QModelIndex(), idx, idx);
     m_contacts.removeAt(idx);
+    // Every later row moved up by one
+    rebuildIndex();
     endRemoveRows();
     Q_EMIT countChanged();
 }
 
+void ContactModel::indexAppendedRows(int first)
+{
+    auto keyLess = [this](int lhs, int rhs) {
+        return m_contacts.at(lhs).publicKeyView() < m_contacts.at(rhs).publicKeyView();
+    };
+
+    int end = static_cast<int>(m_contacts.size());
+    for (int row = first; row < end; ++row) {
+        const Contact &contact = m_contacts.at(row);
+        m_rowByKey.insert(contact.publicKey(), row);
+        if (!m_rowByName.contains(contact.name())) {
+            m_rowByName.insert(contact.name(), row);
+        }
+    }
+
+    if (end - first == 1) {
+        auto pos = std::lower_bound(m_rowsByKey.begin(), m_rowsByKey.end(), first, keyLess);
+        m_rowsByKey.insert(pos, first);
+        return;
+    }
+
+    qsizetype sortedCount = m_rowsByKey.size();
+    for (int row = first; row < end; ++row) {
+        m_rowsByKey.append(row);
+    }
+    std::sort(m_rowsByKey.begin() + sortedCount, m_rowsByKey.end(), keyLess);
+    std::inplace_merge(m_rowsByKey.begin(), m_rowsByKey.begin() + sortedCount, m_rowsByKey.end(), keyLess);
+}
+
+void ContactModel::replaceRow(int row, const Contact &contact)
+{
+    // The key is the row identity and never changes, only the name index can
+    QString oldName = m_contacts.at(row).name();
+    m_contacts[row] = contact;
+    if (contact.name() == oldName) {
+        return;
+    }
+
+    if (m_rowByName.value(oldName, -1) == row) {
+        int next = firstRowWithName(oldName);
+        if (next >= 0) {
+            m_rowByName.insert(oldName, next);
+        } else {
+            m_rowByName.remove(oldName);
+        }
+    }
+
+    auto it = m_rowByName.find(contact.name());
+    if (it == m_rowByName.end()) {
+        m_rowByName.insert(contact.name(), row);
+    } else if (row < *it) {
+        *it = row;
+    }
+}
+
+void ContactModel::rebuildIndex()
+{
+    m_rowByKey.clear();
+    m_rowByName.clear();
+    m_rowsByKey.clear();
+    m_rowByKey.reserve(m_contacts.size());
+    m_rowsByKey.reserve(m_contacts.size());
+    indexAppendedRows(0);
+}
+
+int ContactModel::firstRowWithName(const QString &name) const
+{
+    for (int i = 0; i < m_contacts.size(); ++i) {
+        if (m_contacts.at(i).name() == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::pair<qsizetype, qsizetype> ContactModel::prefixRange(const QByteArray &prefix) const
+{
+    auto keyBelow = [this](int row, QByteArrayView key) {
+        return m_contacts.at(row).publicKeyView() < key;
+    };
+
+    // Keys starting with prefix sort contiguously from the first key >= prefix
+    auto first = std::lower_bound(m_rowsByKey.cbegin(), m_rowsByKey.cend(), QByteArrayView(prefix), keyBelow);
+    auto last = first;
+    while (last != m_rowsByKey.cend() && m_contacts.at(*last).publicKeyView().startsWith(prefix)) {
+        ++last;
+    }
+    return {first - m_rowsByKey.cbegin(), last - m_rowsByKey.cbegin()};
+}
+
 } // namespace MeshCore
@@ -2,6 +2,7 @@
 #define CONTACTMODEL_H
 
 #include <QAbstractListModel>
+#include <QHash>
 #include <QtQml/qqmlregistration.h>
 #include "../types/Contact.h"
 
@@ -9,6 +10,10 @@ namespace MeshCore {
 
 /**
  * @brief List model for contacts, suitable for QML ListView
+ *
+ * Lookups by public key, name and key prefix go through indices that every
+ * modifier keeps in sync with the rows: a key hash, a name hash and a list
+ * of rows sorted by public key for prefix searches.
  */
 class ContactModel : public QAbstractListModel
 {
@@ -48,12 +53,17 @@ public:
     Q_INVOKABLE MeshCore::Contact get(int index) const;
     Q_INVOKABLE MeshCore::Contact findByName(const QString &name) const;
     Q_INVOKABLE MeshCore::Contact findByPublicKeyPrefix(const QByteArray &prefix) const;
+    // All contacts whose key starts with prefix, e.g. the candidates for a 1-byte path hash
+    Q_INVOKABLE QList<MeshCore::Contact> findAllByPublicKeyPrefix(const QByteArray &prefix) const;
     Q_INVOKABLE int indexOf(const QByteArray &publicKey) const;
+    [[nodiscard]] const QList<Contact> &contacts() const { return m_contacts; }
 
     // Data modification
     void clear();
     void addContact(const Contact &contact);
     void addContacts(const QList<Contact> &contacts);
+    // Updates known contacts and appends the rest with a single row insertion
+    void mergeContacts(const QList<Contact> &contacts);
     void updateContact(const Contact &contact);
     void removeContact(const QByteArray &publicKey);
 
@@ -61,7 +71,19 @@ Q_SIGNALS:
     void countChanged();
 
 private:
+    void indexAppendedRows(int first);
+    void replaceRow(int row, const Contact &contact);
+    void rebuildIndex();
+    int firstRowWithName(const QString &name) const;
+    // Range of m_rowsByKey whose keys start with prefix
+    std::pair<qsizetype, qsizetype> prefixRange(const QByteArray &prefix) const;
+
     QList<Contact> m_contacts;
+
+    // Lookup indices over m_contacts
+    QHash<QByteArray, int> m_rowByKey;
+    QHash<QString, int> m_rowByName;  // Lowest row carrying each name
+    QList<int> m_rowsByKey;           // Rows ordered by public key
 };
 
 } // namespace MeshCore
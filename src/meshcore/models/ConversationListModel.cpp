@@ -0,0 +1,276 @@
+#include "ConversationListModel.h"
+#include "ContactModel.h"
+#include "ChannelModel.h"
+#include <QTimeZone>
+#include <algorithm>
+
+namespace MeshCore {
+
+ConversationListModel::ConversationListModel(MessageModel *messages, ContactModel *contacts,
+                                             ChannelModel *channels, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_messages(messages)
+    , m_contacts(contacts)
+    , m_channels(channels)
+{
+    connect(m_messages, &QAbstractItemModel::modelReset, this, &ConversationListModel::reload);
+
+    // Names follow the contact and channel lists
+    for (QAbstractItemModel *source : {static_cast<QAbstractItemModel *>(m_contacts),
+                                       static_cast<QAbstractItemModel *>(m_channels)}) {
+        connect(source, &QAbstractItemModel::rowsInserted, this, &ConversationListModel::refreshNames);
+        connect(source, &QAbstractItemModel::rowsRemoved, this, &ConversationListModel::refreshNames);
+        connect(source, &QAbstractItemModel::dataChanged, this, &ConversationListModel::refreshNames);
+        connect(source, &QAbstractItemModel::modelReset, this, &ConversationListModel::refreshNames);
+    }
+}
+
+int ConversationListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(m_rows.size());
+}
+
+QVariant ConversationListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rows.size()) {
+        return {};
+    }
+
+    const Summary &summary = m_rows.at(index.row());
+
+    switch (role) {
+    case KeyRole:
+        return summary.key;
+    case IsChannelRole:
+        return MessageRecord::conversationChannelIndex(summary.key) >= 0;
+    case ChannelIndexRole:
+        return MessageRecord::conversationChannelIndex(summary.key);
+    case SenderPrefixRole:
+        return QString::fromLatin1(MessageRecord::conversationSenderPrefix(summary.key).toHex());
+    case Qt::DisplayRole:
+    case NameRole:
+        return summary.name;
+    case MessageCountRole:
+        return summary.messageCount;
+    case UnreadCountRole:
+        return summary.unreadCount;
+    case LastTextRole:
+        return summary.lastText;
+    case LastTimestampRole:
+        return summary.lastTimestamp;
+    case LastDateTimeRole:
+        return QDateTime::fromSecsSinceEpoch(summary.lastTimestamp, QTimeZone::UTC);
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> ConversationListModel::roleNames() const
+{
+    static QHash<int, QByteArray> roles{
+        {KeyRole, "key"},
+        {IsChannelRole, "isChannel"},
+        {ChannelIndexRole, "channelIndex"},
+        {SenderPrefixRole, "senderPrefix"},
+        {NameRole, "name"},
+        {MessageCountRole, "messageCount"},
+        {UnreadCountRole, "unreadCount"},
+        {LastTextRole, "lastText"},
+        {LastTimestampRole, "lastTimestamp"},
+        {LastDateTimeRole, "lastDateTime"}
+    };
+    return roles;
+}
+
+void ConversationListModel::markRead(int row)
+{
+    if (row < 0 || row >= m_rows.size() || m_rows.at(row).unreadCount == 0) {
+        return;
+    }
+    setTotalUnread(m_totalUnread - m_rows.at(row).unreadCount);
+    m_rows[row].unreadCount = 0;
+    QModelIndex idx = index(row);
+    Q_EMIT dataChanged(idx, idx, {UnreadCountRole});
+}
+
+void ConversationListModel::markAllRead()
+{
+    for (int row = 0; row < m_rows.size(); ++row) {
+        markRead(row);
+    }
+}
+
+ConversationModel *ConversationListModel::conversationAt(int row)
+{
+    if (row < 0 || row >= m_rows.size()) {
+        return nullptr;
+    }
+    return m_messages->conversation(m_rows.at(row).key);
+}
+
+void ConversationListModel::addMessages(const QList<std::variant<ContactMessage, ChannelMessage>> &messages)
+{
+    for (const auto &message : messages) {
+        addRecord(std::visit([](const auto &typed) { return MessageRecord::fromMessage(typed); }, message));
+    }
+}
+
+void ConversationListModel::reload()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_rowByKey.clear();
+
+    // Only the last message of each conversation is read
+    const QList<quint64> keys = m_messages->conversationKeys();
+    m_rows.reserve(keys.size());
+    for (quint64 key : keys) {
+        qsizetype lastRow = m_messages->lastConversationRow(key);
+        if (lastRow < 0) {
+            continue;
+        }
+        QModelIndex last = m_messages->index(static_cast<int>(lastRow));
+
+        Summary summary;
+        summary.key = key;
+        summary.name = resolveName(key);
+        summary.lastText = m_messages->data(last, MessageModel::TextRole).toString();
+        summary.lastTimestamp = m_messages->data(last, MessageModel::TimestampRole).toUInt();
+        summary.messageCount = static_cast<int>(m_messages->conversationSize(key));
+        m_rows.append(summary);
+    }
+    std::sort(m_rows.begin(), m_rows.end(), comesBefore);
+    reindex(0, static_cast<int>(m_rows.size()) - 1);
+
+    endResetModel();
+    setTotalUnread(0);
+    Q_EMIT countChanged();
+}
+
+void ConversationListModel::refreshNames()
+{
+    for (int row = 0; row < m_rows.size(); ++row) {
+        QString name = resolveName(m_rows.at(row).key);
+        if (name != m_rows.at(row).name) {
+            m_rows[row].name = name;
+            QModelIndex idx = index(row);
+            Q_EMIT dataChanged(idx, idx, {Qt::DisplayRole, NameRole});
+        }
+    }
+}
+
+bool ConversationListModel::comesBefore(const Summary &a, const Summary &b)
+{
+    if (a.lastTimestamp != b.lastTimestamp) {
+        return a.lastTimestamp > b.lastTimestamp;
+    }
+    return a.key < b.key;
+}
+
+void ConversationListModel::addRecord(const MessageRecord &record)
+{
+    quint64 key = record.conversationKey();
+    auto it = m_rowByKey.constFind(key);
+    if (it == m_rowByKey.cend()) {
+        Summary summary;
+        summary.key = key;
+        summary.name = resolveName(key);
+        summary.lastText = record.text;
+        summary.lastTimestamp = record.senderTimestamp;
+        summary.messageCount = 1;
+        summary.unreadCount = 1;
+        insertRow(std::move(summary));
+        setTotalUnread(m_totalUnread + 1);
+        return;
+    }
+
+    int row = it.value();
+    Summary &summary = m_rows[row];
+
+    // A message synced late can carry an older timestamp than the last one shown
+    if (record.senderTimestamp >= summary.lastTimestamp) {
+        summary.lastText = record.text;
+        summary.lastTimestamp = record.senderTimestamp;
+    }
+    ++summary.messageCount;
+    ++summary.unreadCount;
+    setTotalUnread(m_totalUnread + 1);
+    reposition(row);
+}
+
+void ConversationListModel::insertRow(Summary summary)
+{
+    int row = static_cast<int>(std::lower_bound(m_rows.cbegin(), m_rows.cend(), summary, comesBefore)
+                               - m_rows.cbegin());
+
+    beginInsertRows(QModelIndex(), row, row);
+    m_rows.insert(row, std::move(summary));
+    reindex(row, static_cast<int>(m_rows.size()) - 1);
+    endInsertRows();
+    Q_EMIT countChanged();
+}
+
+void ConversationListModel::reposition(int row)
+{
+    const Summary &summary = m_rows.at(row);
+
+    // Only the rows between the old and the new place are touched
+    int target = row;
+    if (row > 0 && comesBefore(summary, m_rows.at(row - 1))) {
+        target = static_cast<int>(std::lower_bound(m_rows.cbegin(), m_rows.cbegin() + row, summary, comesBefore)
+                                  - m_rows.cbegin());
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), target);
+        std::rotate(m_rows.begin() + target, m_rows.begin() + row, m_rows.begin() + row + 1);
+        reindex(target, row);
+        endMoveRows();
+    } else if (row + 1 < m_rows.size() && comesBefore(m_rows.at(row + 1), summary)) {
+        target = static_cast<int>(std::lower_bound(m_rows.cbegin() + row + 1, m_rows.cend(), summary, comesBefore)
+                                  - m_rows.cbegin()) - 1;
+        beginMoveRows(QModelIndex(), row, row, QModelIndex(), target + 1);
+        std::rotate(m_rows.begin() + row, m_rows.begin() + row + 1, m_rows.begin() + target + 1);
+        reindex(row, target);
+        endMoveRows();
+    }
+
+    QModelIndex idx = index(target);
+    Q_EMIT dataChanged(idx, idx, {MessageCountRole, UnreadCountRole, LastTextRole,
+                                  LastTimestampRole, LastDateTimeRole});
+}
+
+void ConversationListModel::reindex(int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        m_rowByKey.insert(m_rows.at(row).key, row);
+    }
+}
+
+QString ConversationListModel::resolveName(quint64 key) const
+{
+    int channelIndex = MessageRecord::conversationChannelIndex(key);
+    if (channelIndex >= 0) {
+        for (int row = 0; row < m_channels->count(); ++row) {
+            ChannelInfo channel = m_channels->get(row);
+            if (channel.index() == channelIndex && !channel.name().isEmpty()) {
+                return channel.name();
+            }
+        }
+        return QStringLiteral("Channel %1").arg(channelIndex);
+    }
+
+    QByteArray prefix = MessageRecord::conversationSenderPrefix(key);
+    QString name = m_contacts->findByPublicKeyPrefix(prefix).name();
+    return name.isEmpty() ? QString::fromLatin1(prefix.toHex()) : name;
+}
+
+void ConversationListModel::setTotalUnread(int totalUnread)
+{
+    if (totalUnread != m_totalUnread) {
+        m_totalUnread = totalUnread;
+        Q_EMIT totalUnreadChanged();
+    }
+}
+
+} // namespace MeshCore
@@ -0,0 +1,104 @@
+#ifndef CONVERSATIONLISTMODEL_H
+#define CONVERSATIONLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QtQml/qqmlregistration.h>
+#include <variant>
+#include "MessageModel.h"
+
+namespace MeshCore {
+
+class ContactModel;
+class ChannelModel;
+
+/**
+ * @brief One row per conversation, most recent first
+ *
+ * Each row summarises a conversation of the MessageModel: the resolved
+ * contact or channel name, the number of messages and of unread ones, and
+ * the last message received. Received messages update their row and move
+ * it to its new place with a single row move, so the list is never
+ * re-sorted as a whole. It is rebuilt only when the MessageModel is reset,
+ * reading one message per conversation.
+ *
+ * Unread counts cover the messages received while the application runs.
+ */
+class ConversationListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int totalUnread READ totalUnread NOTIFY totalUnreadChanged)
+
+public:
+    enum Roles {
+        KeyRole = Qt::UserRole + 1,
+        IsChannelRole,
+        ChannelIndexRole,
+        SenderPrefixRole,    // Hex; empty for channels
+        NameRole,            // Contact or channel name, or the prefix if unknown
+        MessageCountRole,
+        UnreadCountRole,
+        LastTextRole,
+        LastTimestampRole,
+        LastDateTimeRole
+    };
+
+    ConversationListModel(MessageModel *messages, ContactModel *contacts, ChannelModel *channels,
+                          QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return static_cast<int>(m_rows.size()); }
+    int totalUnread() const { return m_totalUnread; }
+
+    Q_INVOKABLE void markRead(int row);
+    Q_INVOKABLE void markAllRead();
+    // The messages of the conversation at row
+    Q_INVOKABLE MeshCore::ConversationModel *conversationAt(int row);
+
+    // Counts the messages as unread and moves their conversations up
+    void addMessages(const QList<std::variant<ContactMessage, ChannelMessage>> &messages);
+
+public Q_SLOTS:
+    void reload();
+    void refreshNames();
+
+Q_SIGNALS:
+    void countChanged();
+    void totalUnreadChanged();
+
+private:
+    struct Summary {
+        quint64 key = 0;
+        QString name;
+        QString lastText;
+        quint32 lastTimestamp = 0;
+        int messageCount = 0;
+        int unreadCount = 0;
+    };
+
+    // Sort order: latest message first, ties broken by key so the order is total
+    static bool comesBefore(const Summary &a, const Summary &b);
+
+    void addRecord(const MessageRecord &record);
+    void insertRow(Summary summary);
+    void reposition(int row);
+    void reindex(int first, int last);
+    [[nodiscard]] QString resolveName(quint64 key) const;
+    void setTotalUnread(int totalUnread);
+
+    MessageModel *m_messages;
+    ContactModel *m_contacts;
+    ChannelModel *m_channels;
+
+    QList<Summary> m_rows;             // In sort order
+    QHash<quint64, int> m_rowByKey;
+    int m_totalUnread = 0;
+};
+
+} // namespace MeshCore
+
+#endif // CONVERSATIONLISTMODEL_H
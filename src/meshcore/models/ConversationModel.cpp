@@ -0,0 +1,75 @@
+#include "ConversationModel.h"
+#include "MessageModel.h"
+
+namespace MeshCore {
+
+ConversationModel::ConversationModel(MessageModel *source, quint64 key, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_source(source)
+    , m_key(key)
+{
+}
+
+int ConversationModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(m_source->conversationRows(m_key).size());
+}
+
+QVariant ConversationModel::data(const QModelIndex &index, int role) const
+{
+    const QList<quint32> &rows = m_source->conversationRows(m_key);
+    if (!index.isValid() || index.row() < 0 || index.row() >= rows.size()) {
+        return {};
+    }
+
+    int sourceRow = static_cast<int>(rows.at(index.row()));
+    if (role == MessageRowRole) {
+        return sourceRow;
+    }
+    return m_source->data(m_source->index(sourceRow), role);
+}
+
+QHash<int, QByteArray> ConversationModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = m_source->roleNames();
+    roles.insert(MessageRowRole, "messageRow");
+    return roles;
+}
+
+bool ConversationModel::isChannel() const
+{
+    return (m_key >> 63) != 0;
+}
+
+int ConversationModel::channelIndex() const
+{
+    return MessageRecord::conversationChannelIndex(m_key);
+}
+
+QString ConversationModel::senderPrefix() const
+{
+    return QString::fromLatin1(MessageRecord::conversationSenderPrefix(m_key).toHex());
+}
+
+void ConversationModel::beginAppend(int count)
+{
+    int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+}
+
+void ConversationModel::endAppend()
+{
+    endInsertRows();
+    Q_EMIT countChanged();
+}
+
+void ConversationModel::endReset()
+{
+    endResetModel();
+    Q_EMIT countChanged();
+}
+
+} // namespace MeshCore
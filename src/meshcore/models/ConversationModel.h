@@ -0,0 +1,63 @@
+#ifndef CONVERSATIONMODEL_H
+#define CONVERSATIONMODEL_H
+
+#include <QAbstractListModel>
+#include <QtQml/qqmlregistration.h>
+
+namespace MeshCore {
+
+class MessageModel;
+
+/**
+ * @brief The messages of one conversation, as a view onto a MessageModel
+ *
+ * Holds no rows of its own: it reads the conversation's row list that
+ * MessageModel maintains, and MessageModel notifies it directly when that
+ * list grows or is rebuilt. Instances are created and owned by
+ * MessageModel, one per conversation.
+ */
+class ConversationModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool isChannel READ isChannel CONSTANT)
+    Q_PROPERTY(int channelIndex READ channelIndex CONSTANT)
+    Q_PROPERTY(QString senderPrefix READ senderPrefix CONSTANT)
+
+public:
+    enum Roles {
+        MessageRowRole = Qt::UserRole + 100  // Row in the MessageModel
+    };
+
+    ConversationModel(MessageModel *source, quint64 key, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return rowCount(); }
+
+    [[nodiscard]] quint64 key() const { return m_key; }
+    [[nodiscard]] bool isChannel() const;
+    [[nodiscard]] int channelIndex() const;     // -1 for contact conversations
+    [[nodiscard]] QString senderPrefix() const; // Hex; empty for channels
+
+Q_SIGNALS:
+    void countChanged();
+
+private:
+    friend class MessageModel;
+
+    void beginAppend(int count);
+    void endAppend();
+    void beginReset() { beginResetModel(); }
+    void endReset();
+
+    MessageModel *m_source;
+    quint64 m_key;
+};
+
+} // namespace MeshCore
+
+#endif // CONVERSATIONMODEL_H
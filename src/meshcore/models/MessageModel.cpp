@@ -1,9 +1,14 @@
 #include "MessageModel.h"
-#include "../types/ContactMessage.h"
-#include "../types/ChannelMessage.h"
+#include <QDebug>
+#include <QQmlEngine>
+#include <QTimeZone>
 
 namespace MeshCore {
 
+static_assert(int(MessageRecord::Contact) == MessageModel::ContactMessageType
+              && int(MessageRecord::Channel) == MessageModel::ChannelMessageType,
+              "MessageRecord::Type must match MessageModel::MessageType");
+
 MessageModel::MessageModel(QObject *parent)
     : QAbstractListModel(parent)
 {
@@ -14,76 +19,52 @@ int MessageModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid()) {
         return 0;
     }
-    return static_cast<int>(m_messages.size());
+    return static_cast<int>(messageCount());
 }
 
 QVariant MessageModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() < 0 || index.row() >= m_messages.size()) {
+    if (!index.isValid() || index.row() < 0 || index.row() >= messageCount()) {
         return {};
     }
 
-    const MessageEntry &entry = m_messages.at(index.row());
+    const MessageRecord *stored = recordAt(index.row());
+    if (!stored) {
+        return {};
+    }
+    const MessageRecord &record = *stored;
 
     switch (role) {
     case MessageTypeRole:
-        return static_cast<int>(entry.type);
+        return static_cast<int>(record.type);
 
     case SenderRole:
-        if (entry.type == ContactMessageType) {
-            auto msg = entry.data.value<ContactMessage>();
-            return msg.senderPublicKeyPrefixHex();
-        } else {
-            auto msg = entry.data.value<ChannelMessage>();
-            return QStringLiteral("Channel %1").arg(msg.channelIndex());
+        if (record.type == MessageRecord::Contact) {
+            return QString::fromLatin1(QByteArray::fromRawData(record.senderPrefix.data(), record.senderPrefixSize).toHex());
         }
+        return QStringLiteral("Channel %1").arg(record.channelIndex);
 
     case TextRole:
-        if (entry.type == ContactMessageType) {
-            return entry.data.value<ContactMessage>().text();
-        } else {
-            return entry.data.value<ChannelMessage>().text();
-        }
+        return record.text;
 
     case TimestampRole:
-        if (entry.type == ContactMessageType) {
-            return entry.data.value<ContactMessage>().senderTimestamp();
-        } else {
-            return entry.data.value<ChannelMessage>().senderTimestamp();
-        }
+        return record.senderTimestamp;
 
     case DateTimeRole:
-        if (entry.type == ContactMessageType) {
-            return entry.data.value<ContactMessage>().dateTime();
-        } else {
-            return entry.data.value<ChannelMessage>().dateTime();
-        }
+        return QDateTime::fromSecsSinceEpoch(record.senderTimestamp, QTimeZone::UTC);
 
     case IsDirectRole:
-        if (entry.type == ChannelMessageType) {
-            return entry.data.value<ChannelMessage>().isDirect();
-        }
-        return false;
+        // Channel messages mark direct delivery with a path length of 0xFF
+        return record.type == MessageRecord::Channel && record.pathLen == 0xFF;
 
     case PathLenRole:
-        if (entry.type == ContactMessageType) {
-            return entry.data.value<ContactMessage>().pathLen();
-        } else {
-            return entry.data.value<ChannelMessage>().pathLen();
-        }
+        return record.pathLen;
 
     case ChannelIndexRole:
-        if (entry.type == ChannelMessageType) {
-            return entry.data.value<ChannelMessage>().channelIndex();
-        }
-        return -1;
+        return static_cast<int>(record.channelIndex);
 
     case TextTypeRole:
-        if (entry.type == ContactMessageType) {
-            return static_cast<int>(entry.data.value<ContactMessage>().textType());
-        } else {
-            return static_cast<int>(entry.data.value<ChannelMessage>().textType());
-        }
+        return static_cast<int>(record.textType);
 
     default:
         return {};
@@ -106,34 +87,256 @@ QHash<int, QByteArray> MessageModel::roleNames() const
     return roles;
 }
 
+void MessageModel::setStore(MessageStore *store)
+{
+    if (store == m_store) {
+        return;
+    }
+
+    beginResetModel();
+    beginResetConversations();
+    if (store && !m_messages.isEmpty()) {
+        if (store->append(m_messages)) {
+            m_messages.clear();
+        } else {
+            qWarning() << "MessageModel: keeping messages in memory, the store rejected them";
+            store = nullptr;
+        }
+    }
+    m_store = store;
+    m_pages.clear();
+    m_pageOrder.clear();
+    rebuildConversations();
+    endResetConversations();
+    endResetModel();
+    Q_EMIT countChanged();
+}
+
 void MessageModel::clear()
 {
-    if (m_messages.isEmpty()) {
+    if (messageCount() == 0 && !m_store) {
         return;
     }
     beginResetModel();
+    beginResetConversations();
     m_messages.clear();
+    m_store = nullptr;
+    m_pages.clear();
+    m_pageOrder.clear();
+    m_conversationRows.clear();
+    m_memoryConversationRows.clear();
+    endResetConversations();
     endResetModel();
     Q_EMIT countChanged();
 }
 
 void MessageModel::addContactMessage(const ContactMessage &message)
 {
-    MessageEntry entry{ContactMessageType, QVariant::fromValue(message)};
-
-    beginInsertRows(QModelIndex(), static_cast<int>(m_messages.size()), static_cast<int>(m_messages.size()));
-    m_messages.append(entry);
-    endInsertRows();
-    Q_EMIT countChanged();
+    appendRecords({MessageRecord::fromMessage(message)});
 }
 
 void MessageModel::addChannelMessage(const ChannelMessage &message)
 {
-    MessageEntry entry{ChannelMessageType, QVariant::fromValue(message)};
+    appendRecords({MessageRecord::fromMessage(message)});
+}
+
+void MessageModel::addMessages(const QList<std::variant<ContactMessage, ChannelMessage>> &messages)
+{
+    if (messages.isEmpty()) {
+        return;
+    }
+
+    QList<MessageRecord> records;
+    records.reserve(messages.size());
+    for (const auto &message : messages) {
+        records.append(std::visit([](const auto &typed) { return MessageRecord::fromMessage(typed); }, message));
+    }
+    appendRecords(records);
+}
+
+const QList<quint32> &MessageModel::conversationRows(quint64 key) const
+{
+    auto it = m_conversationRows.find(key);
+    if (it == m_conversationRows.end()) {
+        QList<quint32> rows = m_store ? m_store->conversationRows(key) : QList<quint32>();
+        rows.append(m_memoryConversationRows.value(key));
+        it = m_conversationRows.insert(key, std::move(rows));
+    }
+    return it.value();
+}
+
+QList<quint64> MessageModel::conversationKeys() const
+{
+    QList<quint64> keys = m_store ? m_store->conversationKeys() : QList<quint64>();
+    for (auto it = m_memoryConversationRows.cbegin(); it != m_memoryConversationRows.cend(); ++it) {
+        if (!m_store || m_store->conversationSize(it.key()) == 0) {
+            keys.append(it.key());
+        }
+    }
+    return keys;
+}
+
+qsizetype MessageModel::conversationSize(quint64 key) const
+{
+    return (m_store ? m_store->conversationSize(key) : 0) + m_memoryConversationRows.value(key).size();
+}
+
+qsizetype MessageModel::lastConversationRow(quint64 key) const
+{
+    auto memory = m_memoryConversationRows.constFind(key);
+    if (memory != m_memoryConversationRows.cend() && !memory->isEmpty()) {
+        return memory->last();
+    }
+    if (m_store) {
+        const QList<quint32> last = m_store->conversationRows(key, m_store->conversationSize(key) - 1, 1);
+        if (!last.isEmpty()) {
+            return last.first();
+        }
+    }
+    return -1;
+}
+
+ConversationModel *MessageModel::conversation(quint64 key)
+{
+    ConversationModel *&view = m_conversations[key];
+    if (!view) {
+        view = new ConversationModel(this, key, this);
+        QQmlEngine::setObjectOwnership(view, QQmlEngine::CppOwnership);
+    }
+    return view;
+}
+
+ConversationModel *MessageModel::contactConversation(const QByteArray &publicKey)
+{
+    return conversation(MessageRecord::contactConversationKey(publicKey));
+}
+
+ConversationModel *MessageModel::channelConversation(int channelIndex)
+{
+    return conversation(MessageRecord::channelConversationKey(channelIndex));
+}
+
+void MessageModel::rebuildConversations()
+{
+    // Stored rows are listed by the store; lists are read again when asked for
+    m_conversationRows.clear();
+    m_memoryConversationRows.clear();
+
+    quint32 row = quint32(m_store ? m_store->count() : 0);
+    for (const MessageRecord &record : std::as_const(m_messages)) {
+        m_memoryConversationRows[record.conversationKey()].append(row++);
+    }
+}
+
+void MessageModel::beginResetConversations()
+{
+    for (ConversationModel *view : std::as_const(m_conversations)) {
+        view->beginReset();
+    }
+}
+
+void MessageModel::endResetConversations()
+{
+    for (ConversationModel *view : std::as_const(m_conversations)) {
+        view->endReset();
+    }
+}
+
+qsizetype MessageModel::messageCount() const
+{
+    return (m_store ? m_store->count() : 0) + m_messages.size();
+}
+
+const MessageRecord *MessageModel::recordAt(qsizetype row) const
+{
+    qsizetype storedCount = m_store ? m_store->count() : 0;
+    if (row >= storedCount) {
+        return &m_messages.at(row - storedCount);
+    }
 
-    beginInsertRows(QModelIndex(), static_cast<int>(m_messages.size()), static_cast<int>(m_messages.size()));
-    m_messages.append(entry);
+    qsizetype page = row / PageSize;
+    auto it = m_pages.find(page);
+    if (it == m_pages.end()) {
+        if (m_pages.size() >= MaxCachedPages) {
+            m_pages.remove(m_pageOrder.takeFirst());
+        }
+        it = m_pages.insert(page, m_store->read(page * PageSize, PageSize));
+    } else {
+        m_pageOrder.removeOne(page);
+    }
+    m_pageOrder.append(page);
+
+    qsizetype offset = row - page * PageSize;
+    return offset < it->size() ? &it->at(offset) : nullptr;
+}
+
+void MessageModel::appendRecords(const QList<MessageRecord> &records)
+{
+    if (records.isEmpty()) {
+        return;
+    }
+
+    int first = static_cast<int>(messageCount());
+    int last = first + static_cast<int>(records.size()) - 1;
+
+    // Rows per conversation, so each open view is notified once per batch
+    QHash<quint64, int> appendedPerConversation;
+    for (const MessageRecord &record : records) {
+        ++appendedPerConversation[record.conversationKey()];
+    }
+
+    beginInsertRows(QModelIndex(), first, last);
+    for (auto it = appendedPerConversation.cbegin(); it != appendedPerConversation.cend(); ++it) {
+        if (ConversationModel *view = m_conversations.value(it.key())) {
+            view->beginAppend(it.value());
+        }
+    }
+
+    // Rows stay in order: once the store rejects a batch, later rows are kept in memory too
+    bool stored = false;
+    if (m_store && m_messages.isEmpty()) {
+        stored = m_store->append(records);
+        if (!stored) {
+            qWarning() << "MessageModel: keeping messages from row" << first << "in memory, the store rejected them";
+        }
+    }
+    if (stored) {
+        // The last cached page may be partial and miss the new rows
+        qsizetype page = first / PageSize;
+        if (m_pages.remove(page)) {
+            m_pageOrder.removeOne(page);
+        }
+    } else {
+        m_messages.append(records);
+    }
+
+    // The store lists stored rows itself; loaded lists are extended either way
+    quint32 row = quint32(first);
+    for (const MessageRecord &record : records) {
+        quint64 key = record.conversationKey();
+        auto loaded = m_conversationRows.find(key);
+        if (loaded != m_conversationRows.end()) {
+            loaded->append(row);
+        }
+        if (!stored) {
+            m_memoryConversationRows[key].append(row);
+        }
+        ++row;
+    }
+
+    for (auto it = appendedPerConversation.cbegin(); it != appendedPerConversation.cend(); ++it) {
+        if (ConversationModel *view = m_conversations.value(it.key())) {
+            view->endAppend();
+        }
+    }
     endInsertRows();
+
+    QStringList texts;
+    texts.reserve(records.size());
+    for (const MessageRecord &record : records) {
+        texts.append(record.text);
+    }
+    Q_EMIT messagesAppended(first, texts);
     Q_EMIT countChanged();
 }
 
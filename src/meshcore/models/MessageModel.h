@@ -4,14 +4,35 @@
 #include <QAbstractListModel>
 #include <QtQml/qqmlregistration.h>
 #include <QVariant>
+#include <QHash>
+#include <QStringList>
+#include <variant>
+#include "../types/ContactMessage.h"
+#include "../types/ChannelMessage.h"
+#include "../storage/MessageStore.h"
+#include "ConversationModel.h"
 
 namespace MeshCore {
 
-class ContactMessage;
-class ChannelMessage;
-
 /**
  * @brief Unified message model for both contact and channel messages
+ *
+ * Rows are stored as plain records rather than boxed messages, so data()
+ * reads a field in place without copying the message.
+ *
+ * Once a MessageStore is attached, rows live only in the store. data()
+ * reads them through a cache of PageSize-row pages, of which at most
+ * MaxCachedPages are kept, so memory stays bounded however long the
+ * history grows and only the rows a view scrolls to are ever decoded.
+ * Should the store reject a batch, that batch and every later one are
+ * kept in memory after the stored rows instead.
+ *
+ * The rows of each conversation (a contact's sender prefix or a channel)
+ * are listed by the store. A conversation's list is read into memory when
+ * a view first asks for it and kept up to date as rows are appended;
+ * ConversationModel views read those lists directly, so opening a
+ * conversation never scans the history and a new message only notifies
+ * the view of its own conversation.
  */
 class MessageModel : public QAbstractListModel
 {
@@ -44,22 +65,59 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QHash<int, QByteArray> roleNames() const override;
 
-    int count() const { return static_cast<int>(m_messages.size()); }
+    static constexpr qsizetype PageSize = 256;
+    static constexpr qsizetype MaxCachedPages = 64;
+
+    int count() const { return static_cast<int>(messageCount()); }
+
+    // Pages rows from the store instead of holding them; rows already in the
+    // model are appended to the store first. Pass nullptr to detach.
+    void setStore(MessageStore *store);
+    [[nodiscard]] MessageStore *store() const { return m_store; }
+
+    // Rows of one conversation, in order; see MessageRecord::conversationKey()
+    [[nodiscard]] const QList<quint32> &conversationRows(quint64 key) const;
+    [[nodiscard]] QList<quint64> conversationKeys() const;
+    [[nodiscard]] qsizetype conversationSize(quint64 key) const;
+    [[nodiscard]] qsizetype lastConversationRow(quint64 key) const;  // -1 if empty
 
+    // The view of one conversation, created on first use and owned by this model
+    ConversationModel *conversation(quint64 key);
+    Q_INVOKABLE MeshCore::ConversationModel *contactConversation(const QByteArray &publicKey);
+    Q_INVOKABLE MeshCore::ConversationModel *channelConversation(int channelIndex);
+
+    // Empties the model and detaches the store; stored history is kept on disk
     void clear();
     void addContactMessage(const ContactMessage &message);
     void addChannelMessage(const ChannelMessage &message);
+    // Appends a batch, in order, with a single row insertion
+    void addMessages(const QList<std::variant<ContactMessage, ChannelMessage>> &messages);
 
 Q_SIGNALS:
     void countChanged();
+    // Emitted once the rows are inserted, with the text of each new row
+    void messagesAppended(int firstRow, const QStringList &texts);
 
 private:
-    struct MessageEntry {
-        MessageType type;
-        QVariant data;
-    };
-
-    QList<MessageEntry> m_messages;
+    [[nodiscard]] qsizetype messageCount() const;
+    [[nodiscard]] const MessageRecord *recordAt(qsizetype row) const;
+    void appendRecords(const QList<MessageRecord> &records);
+    void rebuildConversations();
+    void beginResetConversations();
+    void endResetConversations();
+
+    QList<MessageRecord> m_messages;  // All rows without a store, else rows the store rejected
+    MessageStore *m_store = nullptr;
+
+    // Decoded pages of the store, keyed by page number, least recently used first
+    mutable QHash<qsizetype, QList<MessageRecord>> m_pages;
+    mutable QList<qsizetype> m_pageOrder;
+
+    // Complete row lists of the conversations a view has asked for
+    mutable QHash<quint64, QList<quint32>> m_conversationRows;
+    // Rows of m_messages per conversation, which the store does not list
+    QHash<quint64, QList<quint32>> m_memoryConversationRows;
+    QHash<quint64, ConversationModel *> m_conversations;
 };
 
 } // namespace MeshCore
@@ -0,0 +1,105 @@
+#include "MessageSearchModel.h"
+
+namespace MeshCore {
+
+MessageSearchModel::MessageSearchModel(MessageModel *source, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_source(source)
+{
+    connect(m_source, &QAbstractItemModel::rowsInserted, this, &MessageSearchModel::refresh);
+    connect(m_source, &QAbstractItemModel::modelReset, this, &MessageSearchModel::refresh);
+}
+
+int MessageSearchModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(m_hits.size());
+}
+
+QVariant MessageSearchModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_hits.size()) {
+        return {};
+    }
+
+    const MessageSearchHit &hit = m_hits.at(index.row());
+
+    switch (role) {
+    case ScoreRole:
+        return hit.score;
+
+    case MessageRowRole:
+        return static_cast<int>(hit.row);
+
+    default:
+        return m_source->data(m_source->index(static_cast<int>(hit.row)), role);
+    }
+}
+
+QHash<int, QByteArray> MessageSearchModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = m_source->roleNames();
+    roles.insert(ScoreRole, "score");
+    roles.insert(MessageRowRole, "messageRow");
+    return roles;
+}
+
+void MessageSearchModel::setQuery(const QString &query)
+{
+    if (query == m_query) {
+        return;
+    }
+    m_query = query;
+    Q_EMIT queryChanged();
+    refresh();
+}
+
+void MessageSearchModel::refresh()
+{
+    ++m_requestId;
+    if (m_query.trimmed().isEmpty()) {
+        setSearching(false);
+        setHits({});
+        return;
+    }
+
+    setSearching(true);
+    Q_EMIT searchRequested(m_requestId, m_query);
+}
+
+void MessageSearchModel::setResults(quint64 requestId, const QList<MessageSearchHit> &hits)
+{
+    if (requestId != m_requestId) {
+        return;
+    }
+    setSearching(false);
+
+    // The source may have been reset to a shorter history since the query ran
+    QList<MessageSearchHit> valid = hits;
+    int sourceCount = m_source->rowCount();
+    valid.removeIf([sourceCount](const MessageSearchHit &hit) { return hit.row >= quint32(sourceCount); });
+    setHits(valid);
+}
+
+void MessageSearchModel::setSearching(bool searching)
+{
+    if (searching != m_searching) {
+        m_searching = searching;
+        Q_EMIT searchingChanged();
+    }
+}
+
+void MessageSearchModel::setHits(const QList<MessageSearchHit> &hits)
+{
+    if (hits.isEmpty() && m_hits.isEmpty()) {
+        return;
+    }
+    beginResetModel();
+    m_hits = hits;
+    endResetModel();
+    Q_EMIT countChanged();
+}
+
+} // namespace MeshCore
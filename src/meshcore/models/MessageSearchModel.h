@@ -0,0 +1,68 @@
+#ifndef MESSAGESEARCHMODEL_H
+#define MESSAGESEARCHMODEL_H
+
+#include <QAbstractListModel>
+#include <QtQml/qqmlregistration.h>
+#include "MessageModel.h"
+#include "../storage/MessageSearchIndex.h"
+
+namespace MeshCore {
+
+/**
+ * @brief Ranked search results over a MessageModel
+ *
+ * Setting query sends it to the MessageSearchIndex thread; the hits
+ * replace the rows when they arrive, unless a newer query was set in the
+ * meantime. Rows expose every MessageModel role plus the hit's score and
+ * source row. The query is re-run as new messages arrive.
+ */
+class MessageSearchModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    Q_PROPERTY(bool searching READ isSearching NOTIFY searchingChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        ScoreRole = MessageModel::TextTypeRole + 1,
+        MessageRowRole
+    };
+
+    explicit MessageSearchModel(MessageModel *source, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return static_cast<int>(m_hits.size()); }
+
+    [[nodiscard]] QString query() const { return m_query; }
+    void setQuery(const QString &query);
+    [[nodiscard]] bool isSearching() const { return m_searching; }
+
+public Q_SLOTS:
+    void setResults(quint64 requestId, const QList<MeshCore::MessageSearchHit> &hits);
+    void refresh();
+
+Q_SIGNALS:
+    void queryChanged();
+    void searchingChanged();
+    void countChanged();
+    void searchRequested(quint64 requestId, const QString &query);
+
+private:
+    void setSearching(bool searching);
+    void setHits(const QList<MessageSearchHit> &hits);
+
+    MessageModel *m_source;
+    QString m_query;
+    quint64 m_requestId = 0;  // Latest request; older results are dropped
+    bool m_searching = false;
+    QList<MessageSearchHit> m_hits;
+};
+
+} // namespace MeshCore
+
+#endif // MESSAGESEARCHMODEL_H
@@ -0,0 +1,84 @@
+#include "RxCaptureModel.h"
+#include "RxLogModel.h"
+#include <QDir>
+#include <QUrl>
+
+namespace MeshCore {
+
+RxCaptureModel::RxCaptureModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int RxCaptureModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(m_reader.count());
+}
+
+QVariant RxCaptureModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_reader.count()) {
+        return {};
+    }
+
+    RxLogEntry *entry = m_entries.object(index.row());
+    if (!entry) {
+        entry = new RxLogEntry(m_reader.entry(index.row()));
+        m_entries.insert(index.row(), entry);
+    }
+    return RxLogModel::entryData(*entry, role);
+}
+
+QHash<int, QByteArray> RxCaptureModel::roleNames() const
+{
+    return RxLogModel::entryRoleNames();
+}
+
+void RxCaptureModel::setPath(const QString &path)
+{
+    // Accept file URLs as handed out by QML file dialogs
+    QString localPath = path.startsWith(QStringLiteral("file:")) ? QUrl(path).toLocalFile() : path;
+    if (localPath == m_path) {
+        return;
+    }
+    m_path = localPath;
+    Q_EMIT pathChanged();
+    reload();
+}
+
+void RxCaptureModel::reload()
+{
+    beginResetModel();
+    m_entries.clear();
+    if (m_path.isEmpty()) {
+        m_reader.close();
+    } else {
+        m_reader.open(m_path);
+    }
+    endResetModel();
+    Q_EMIT countChanged();
+    Q_EMIT errorStringChanged();
+}
+
+int RxCaptureModel::rowAtTime(const QDateTime &time) const
+{
+    return static_cast<int>(m_reader.rowAtTime(time.toMSecsSinceEpoch()));
+}
+
+QStringList RxCaptureModel::availableCaptures() const
+{
+    QDir dir(RxCapture::directory());
+    const QStringList names = dir.entryList({QStringLiteral("*.") + RxCapture::FileSuffix},
+                                            QDir::Files, QDir::Time);
+    QStringList paths;
+    paths.reserve(names.size());
+    for (const QString &name : names) {
+        paths.append(dir.filePath(name));
+    }
+    return paths;
+}
+
+} // namespace MeshCore
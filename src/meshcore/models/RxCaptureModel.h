@@ -0,0 +1,63 @@
+#ifndef RXCAPTUREMODEL_H
+#define RXCAPTUREMODEL_H
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QDateTime>
+#include <QStringList>
+#include <QtQml/qqmlregistration.h>
+#include "../storage/RxCapture.h"
+
+namespace MeshCore {
+
+/**
+ * @brief Read-only model of a recorded RX capture file
+ *
+ * Exposes the same roles as RxLogModel. Rows are decoded from the mapped
+ * file when a view asks for them, and the last CacheSize decoded entries
+ * are kept, so scrolling through a capture of any size stays cheap.
+ */
+class RxCaptureModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(QString errorString READ errorString NOTIFY errorStringChanged)
+
+public:
+    static constexpr int CacheSize = 1024;
+
+    explicit RxCaptureModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return rowCount(); }
+    [[nodiscard]] QString path() const { return m_path; }
+    void setPath(const QString &path);
+    [[nodiscard]] QString errorString() const { return m_reader.errorString(); }
+
+    // Row of the first entry received at or after the given time
+    Q_INVOKABLE int rowAtTime(const QDateTime &time) const;
+    // Captures in RxCapture::directory(), newest first
+    Q_INVOKABLE QStringList availableCaptures() const;
+
+public Q_SLOTS:
+    void reload();
+
+Q_SIGNALS:
+    void pathChanged();
+    void countChanged();
+    void errorStringChanged();
+
+private:
+    QString m_path;
+    RxCaptureReader m_reader;
+    mutable QCache<int, RxLogEntry> m_entries{CacheSize};
+};
+
+} // namespace MeshCore
+
+#endif // RXCAPTUREMODEL_H
@@ -1,31 +1,41 @@
 #include "RxLogModel.h"
+#include <utility>
 
 namespace MeshCore {
 
 RxLogModel::RxLogModel(QObject *parent)
     : QAbstractListModel(parent)
+    , m_flushTimer(this)
+    , m_groups(this)
 {
+    m_groups.setMaxGroups(m_maxEntries);
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FlushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &RxLogModel::flush);
 }
 
 int RxLogModel::rowCount(const QModelIndex &parent) const
 {
     if (parent.isValid())
         return 0;
-    return m_entries.count();
+    return static_cast<int>(m_count);
 }
 
 QVariant RxLogModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() < 0 || index.row() >= m_entries.count())
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_count)
         return QVariant();
 
-    const RxLogEntry &entry = m_entries.at(index.row());
+    return entryData(entryAt(index.row()), role);
+}
 
+QVariant RxLogModel::entryData(const RxLogEntry &entry, int role)
+{
     switch (role) {
     case TimestampRole:
         return entry.timestamp();
     case TimestampStringRole:
-        return entry.timestamp().toString("hh:mm:ss.zzz");
+        return entry.timestampString();
     case SnrRole:
         return entry.snr();
     case RssiRole:
@@ -50,6 +60,12 @@ QVariant RxLogModel::data(const QModelIndex &index, int role) const
         return entry.hopCount();
     case PathLengthRole:
         return entry.pathLength();
+    case PathHexRole:
+        return entry.pathHex();
+    case PacketHashRole:
+        return QString::number(entry.packetHash(), 16);
+    case SightingRole:
+        return entry.sighting();
     case DestHashRole:
         return entry.destHash();
     case SrcHashRole:
@@ -72,6 +88,11 @@ QVariant RxLogModel::data(const QModelIndex &index, int role) const
 }
 
 QHash<int, QByteArray> RxLogModel::roleNames() const
+{
+    return entryRoleNames();
+}
+
+QHash<int, QByteArray> RxLogModel::entryRoleNames()
 {
     return {
         {TimestampRole, "timestamp"},
@@ -88,6 +109,9 @@ QHash<int, QByteArray> RxLogModel::roleNames() const
         {PayloadVersionRole, "payloadVersion"},
         {HopCountRole, "hopCount"},
         {PathLengthRole, "pathLength"},
+        {PathHexRole, "pathHex"},
+        {PacketHashRole, "packetHash"},
+        {SightingRole, "sighting"},
         {DestHashRole, "destHash"},
         {SrcHashRole, "srcHash"},
         {AdvertNameRole, "advertName"},
@@ -109,19 +133,34 @@ void RxLogModel::setEnabled(bool enabled)
 
 void RxLogModel::setMaxEntries(int max)
 {
-    if (m_maxEntries != max) {
-        m_maxEntries = max;
-        Q_EMIT maxEntriesChanged();
-        
-        // Trim if needed
-        if (m_entries.count() > m_maxEntries) {
-            int toRemove = m_entries.count() - m_maxEntries;
-            beginRemoveRows(QModelIndex(), 0, toRemove - 1);
-            m_entries.remove(0, toRemove);
-            endRemoveRows();
-            Q_EMIT countChanged();
-        }
+    max = qMax(max, 1);
+    if (m_maxEntries == max)
+        return;
+
+    // Pending entries are applied under the old capacity
+    flush();
+
+    // The slot mapping depends on the capacity, so the ring is laid out again from slot 0
+    qsizetype keep = qMin<qsizetype>(m_count, max);
+    qsizetype removed = m_count - keep;
+    if (removed > 0)
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(removed) - 1);
+
+    QList<RxLogEntry> ring;
+    ring.reserve(keep);
+    for (qsizetype row = removed; row < m_count; ++row)
+        ring.append(entryAt(row));
+    m_ring = std::move(ring);
+    m_head = 0;
+    m_count = keep;
+    m_maxEntries = max;
+    m_groups.setMaxGroups(max);
+
+    if (removed > 0) {
+        endRemoveRows();
+        Q_EMIT countChanged();
     }
+    Q_EMIT maxEntriesChanged();
 }
 
 void RxLogModel::addEntry(double snr, qint8 rssi, const QByteArray &rawData)
@@ -129,30 +168,91 @@ void RxLogModel::addEntry(double snr, qint8 rssi, const QByteArray &rawData)
     if (!m_enabled)
         return;
 
-    // Remove oldest entries if we're at capacity
-    if (m_entries.count() >= m_maxEntries) {
-        beginRemoveRows(QModelIndex(), 0, 0);
-        m_entries.removeFirst();
-        endRemoveRows();
-    }
+    addEntry(RxLogEntry(snr, rssi, rawData));
+}
 
-    // Add new entry at the end (newest at bottom)
-    beginInsertRows(QModelIndex(), m_entries.count(), m_entries.count());
-    m_entries.append(RxLogEntry(snr, rssi, rawData));
-    endInsertRows();
-    
-    Q_EMIT countChanged();
+void RxLogModel::addEntry(const RxLogEntry &entry)
+{
+    if (!m_enabled)
+        return;
+
+    m_pending.append(entry);
+    queue();
+}
+
+void RxLogModel::addEntries(const QList<RxLogEntry> &entries)
+{
+    if (!m_enabled || entries.isEmpty())
+        return;
+
+    m_pending.append(entries);
+    queue();
 }
 
 void RxLogModel::clear()
 {
-    if (m_entries.isEmpty())
+    m_flushTimer.stop();
+    m_pending.clear();
+    m_groups.clear();
+
+    if (m_count == 0)
         return;
 
     beginResetModel();
-    m_entries.clear();
+    m_ring.clear();
+    m_head = 0;
+    m_count = 0;
     endResetModel();
     Q_EMIT countChanged();
 }
 
+void RxLogModel::flush()
+{
+    m_flushTimer.stop();
+    if (m_pending.isEmpty())
+        return;
+
+    QList<RxLogEntry> incoming = std::exchange(m_pending, {});
+    m_groups.addEntries(incoming);
+
+    // Evict the oldest rows the incoming ones displace, all in one removal
+    qsizetype overflow = m_count + incoming.size() - m_maxEntries;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(overflow) - 1);
+        m_head = (m_head + overflow) % m_maxEntries;
+        m_count -= overflow;
+        endRemoveRows();
+    }
+
+    int first = static_cast<int>(m_count);
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(incoming.size()) - 1);
+    for (RxLogEntry &entry : incoming) {
+        // The ring grows until it has maxEntries slots, then new entries reuse evicted slots
+        qsizetype slot = (m_head + m_count) % m_maxEntries;
+        if (slot == m_ring.size())
+            m_ring.append(std::move(entry));
+        else
+            m_ring[slot] = std::move(entry);
+        ++m_count;
+    }
+    endInsertRows();
+
+    Q_EMIT countChanged();
+}
+
+const RxLogEntry &RxLogModel::entryAt(qsizetype row) const
+{
+    return m_ring.at((m_head + row) % m_maxEntries);
+}
+
+void RxLogModel::queue()
+{
+    // Entries that would be evicted by the same flush are never inserted
+    if (m_pending.size() > m_maxEntries)
+        m_pending.remove(0, m_pending.size() - m_maxEntries);
+
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
 } // namespace MeshCore
@@ -3,12 +3,22 @@
 
 #include <QAbstractListModel>
 #include <QList>
+#include <QTimer>
 #include "../types/RxLogEntry.h"
+#include "RxPacketGroupModel.h"
 
 namespace MeshCore {
 
 /**
  * @brief Model for displaying RX log entries in a ListView
+ *
+ * Entries are kept in a ring buffer of maxEntries slots: once full, a new
+ * entry overwrites the oldest one in place, and rows are mapped onto slots
+ * from the current head. Added entries are queued and applied once per
+ * display frame, as at most one row removal and one row insertion.
+ *
+ * Each batch also passes through the groups model, which marks repeats of
+ * flooded packets (see SightingRole) and offers the collapsed view.
  */
 class RxLogModel : public QAbstractListModel
 {
@@ -16,8 +26,11 @@ class RxLogModel : public QAbstractListModel
     Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
     Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
     Q_PROPERTY(int maxEntries READ maxEntries WRITE setMaxEntries NOTIFY maxEntriesChanged)
+    Q_PROPERTY(RxPacketGroupModel* groups READ groups CONSTANT)
 
 public:
+    static constexpr int FlushIntervalMs = 16;
+
     enum Roles {
         TimestampRole = Qt::UserRole + 1,
         TimestampStringRole,
@@ -34,6 +47,9 @@ public:
         PayloadVersionRole,
         HopCountRole,
         PathLengthRole,
+        PathHexRole,
+        PacketHashRole,   // Hex; equal for all repeats of a packet
+        SightingRole,     // 0 for the first sighting, n for the n-th repeat
         // Payload-specific
         DestHashRole,
         SrcHashRole,
@@ -51,15 +67,25 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QHash<int, QByteArray> roleNames() const override;
 
+    // Role values and names shared with other models of RX log entries
+    static QVariant entryData(const RxLogEntry &entry, int role);
+    static QHash<int, QByteArray> entryRoleNames();
+
     bool isEnabled() const { return m_enabled; }
     void setEnabled(bool enabled);
 
     int maxEntries() const { return m_maxEntries; }
     void setMaxEntries(int max);
 
+    RxPacketGroupModel *groups() { return &m_groups; }
+
 public Q_SLOTS:
     void addEntry(double snr, qint8 rssi, const QByteArray &rawData);
+    void addEntry(const MeshCore::RxLogEntry &entry);
+    void addEntries(const QList<MeshCore::RxLogEntry> &entries);
     void clear();
+    // Apply the queued entries now
+    void flush();
 
 Q_SIGNALS:
     void countChanged();
@@ -67,7 +93,15 @@ Q_SIGNALS:
     void maxEntriesChanged();
 
 private:
-    QList<RxLogEntry> m_entries;
+    [[nodiscard]] const RxLogEntry &entryAt(qsizetype row) const;
+    void queue();
+
+    QList<RxLogEntry> m_ring;     // Grows up to maxEntries slots, then wraps
+    qsizetype m_head = 0;         // Slot of the oldest entry
+    qsizetype m_count = 0;
+    QList<RxLogEntry> m_pending;  // Added since the last flush
+    QTimer m_flushTimer;
+    RxPacketGroupModel m_groups;
     bool m_enabled = false;
     int m_maxEntries = 500;  // Keep last 500 entries by default
 };
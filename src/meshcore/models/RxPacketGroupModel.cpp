@@ -0,0 +1,179 @@
+#include "RxPacketGroupModel.h"
+#include "RxLogModel.h"
+#include <QVariantMap>
+#include <utility>
+
+namespace MeshCore {
+
+RxPacketGroupModel::RxPacketGroupModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int RxPacketGroupModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(m_groups.size());
+}
+
+QVariant RxPacketGroupModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_groups.size()) {
+        return {};
+    }
+
+    const Group &group = m_groups.at(index.row());
+    const RxLogEntry &first = group.sightings.first();
+
+    switch (role) {
+    case SightingCountRole:
+        return group.sightingCount;
+    case DuplicateCountRole:
+        return group.sightingCount - 1;
+    case BestSnrRole:
+        return group.bestSnr;
+    case BestRssiRole:
+        return group.bestRssi;
+    case SightingsRole: {
+        QVariantList sightings;
+        sightings.reserve(group.sightings.size());
+        for (const RxLogEntry &entry : group.sightings) {
+            sightings.append(QVariantMap{
+                {QStringLiteral("timestampString"), entry.timestampString()},
+                {QStringLiteral("delayMs"), entry.receivedAtMs() - first.receivedAtMs()},
+                {QStringLiteral("snr"), entry.snr()},
+                {QStringLiteral("rssi"), entry.rssi()},
+                {QStringLiteral("hopCount"), entry.hopCount()},
+                {QStringLiteral("pathHex"), entry.pathHex()}
+            });
+        }
+        return sightings;
+    }
+    default:
+        return RxLogModel::entryData(first, role);
+    }
+}
+
+QHash<int, QByteArray> RxPacketGroupModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = RxLogModel::entryRoleNames();
+    roles.insert(SightingCountRole, "sightingCount");
+    roles.insert(DuplicateCountRole, "duplicateCount");
+    roles.insert(BestSnrRole, "bestSnr");
+    roles.insert(BestRssiRole, "bestRssi");
+    roles.insert(SightingsRole, "sightings");
+    return roles;
+}
+
+void RxPacketGroupModel::addEntries(QList<RxLogEntry> &entries)
+{
+    if (entries.isEmpty()) {
+        return;
+    }
+
+    // Groups first seen in this batch are collected apart and inserted at the end
+    QList<Group> added;
+    qsizetype existing = m_groups.size();
+    qsizetype firstChanged = existing;
+    qsizetype lastChanged = -1;
+
+    for (RxLogEntry &entry : entries) {
+        quint64 hash = entry.packetHash();
+        qint64 nowMs = entry.monotonicMs();
+
+        // Ids are consecutive across m_groups and added, so an id maps straight to its group
+        qint64 firstId = m_nextId - (m_groups.size() + added.size());
+        qint64 id = hash != 0 ? m_identities.find(hash, nowMs) : -1;
+        if (id >= firstId) {
+            qsizetype index = id - firstId;
+            Group &group = index < existing ? m_groups[index] : added[index - existing];
+            entry.setSighting(group.sightingCount);
+            addSighting(group, entry);
+            if (index < existing) {
+                firstChanged = qMin(firstChanged, index);
+                lastChanged = qMax(lastChanged, index);
+            }
+            continue;
+        }
+
+        // First sighting, or the packet's group has already scrolled out
+        Group group;
+        group.id = m_nextId++;
+        addSighting(group, entry);
+        if (hash != 0) {
+            m_identities.insert(hash, group.id, nowMs);
+        }
+        added.append(std::move(group));
+    }
+
+    if (lastChanged >= 0) {
+        Q_EMIT dataChanged(index(static_cast<int>(firstChanged)), index(static_cast<int>(lastChanged)),
+                           {SightingCountRole, DuplicateCountRole, BestSnrRole, BestRssiRole, SightingsRole});
+    }
+    if (added.isEmpty()) {
+        return;
+    }
+
+    // Evict the oldest groups the new ones displace, all in one removal
+    qsizetype overflow = m_groups.size() + added.size() - m_maxGroups;
+    if (overflow > 0) {
+        qsizetype removed = qMin(overflow, m_groups.size());
+        if (removed > 0) {
+            beginRemoveRows(QModelIndex(), 0, static_cast<int>(removed) - 1);
+            m_groups.remove(0, removed);
+            endRemoveRows();
+        }
+        added.remove(0, overflow - removed);
+    }
+
+    int first = static_cast<int>(m_groups.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(added.size()) - 1);
+    m_groups.append(std::move(added));
+    endInsertRows();
+
+    Q_EMIT countChanged();
+}
+
+void RxPacketGroupModel::setMaxGroups(int max)
+{
+    m_maxGroups = qMax(max, 1);
+
+    qsizetype overflow = m_groups.size() - m_maxGroups;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(overflow) - 1);
+        m_groups.remove(0, overflow);
+        endRemoveRows();
+        Q_EMIT countChanged();
+    }
+}
+
+void RxPacketGroupModel::clear()
+{
+    m_identities.clear();
+    if (m_groups.isEmpty()) {
+        return;
+    }
+
+    beginResetModel();
+    m_groups.clear();
+    endResetModel();
+    Q_EMIT countChanged();
+}
+
+void RxPacketGroupModel::addSighting(Group &group, const RxLogEntry &entry)
+{
+    if (group.sightings.size() < MaxSightingsPerGroup) {
+        group.sightings.append(entry);
+    }
+    if (group.sightingCount == 0 || entry.snr() > group.bestSnr) {
+        group.bestSnr = entry.snr();
+    }
+    if (group.sightingCount == 0 || entry.rssi() > group.bestRssi) {
+        group.bestRssi = entry.rssi();
+    }
+    ++group.sightingCount;
+}
+
+} // namespace MeshCore
@@ -0,0 +1,76 @@
+#ifndef RXPACKETGROUPMODEL_H
+#define RXPACKETGROUPMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QtQml/qqmlregistration.h>
+#include "../types/RxLogEntry.h"
+#include "../utils/PacketIdentityTable.h"
+
+namespace MeshCore {
+
+/**
+ * @brief Collapsed view of the RX log: one row per distinct packet
+ *
+ * A flooded packet is heard once for every repeater that relays it. Each
+ * entry is matched on its payload hash against the packets seen within
+ * the identity table's window; a repeat is grouped under the row of its
+ * first sighting, which counts the repeats and keeps the SNR, RSSI and
+ * path of each one. Rows expose the roles of the first sighting plus the
+ * group roles below.
+ *
+ * Fed by RxLogModel, which owns it and passes each batch of entries
+ * through addEntries() before showing them.
+ */
+class RxPacketGroupModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    static constexpr int MaxSightingsPerGroup = 64;  // Repeats beyond are only counted
+
+    enum Roles {
+        SightingCountRole = Qt::UserRole + 100,
+        DuplicateCountRole,
+        BestSnrRole,
+        BestRssiRole,
+        SightingsRole   // List of {timestampString, delayMs, snr, rssi, hopCount, pathHex}
+    };
+
+    explicit RxPacketGroupModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return rowCount(); }
+
+    // Groups the entries and records in each which sighting of its packet it is
+    void addEntries(QList<RxLogEntry> &entries);
+    void setMaxGroups(int max);
+    void clear();
+
+Q_SIGNALS:
+    void countChanged();
+
+private:
+    struct Group {
+        qint64 id = 0;
+        QList<RxLogEntry> sightings;   // First sighting, then repeats in arrival order
+        int sightingCount = 0;
+        double bestSnr = 0.0;
+        int bestRssi = 0;
+    };
+
+    static void addSighting(Group &group, const RxLogEntry &entry);
+
+    QList<Group> m_groups;   // In order of first sighting; ids are consecutive
+    PacketIdentityTable m_identities;
+    qint64 m_nextId = 0;
+    int m_maxGroups = 500;
+};
+
+} // namespace MeshCore
+
+#endif // RXPACKETGROUPMODEL_H
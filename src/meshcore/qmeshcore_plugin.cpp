@@ -1,5 +1,6 @@
 #include "qmeshcore_plugin.h"
 #include "MeshCoreDeviceController.h"
+#include "models/RxCaptureModel.h"
 
 #include <QQmlEngine>
 #include <QtQml/qqmlextensionplugin.h>
@@ -32,5 +33,8 @@ void qml_register_types_QMeshCore()
     qmlRegisterUncreatableType<MeshCore::MessageModel>(
         "QMeshCore", 1, 0, "MessageModel",
         "MessageModel is obtained from MeshCoreDevice");
+
+    // Created from QML to browse recorded capture files
+    qmlRegisterType<MeshCore::RxCaptureModel>("QMeshCore", 1, 0, "RxCaptureModel");
 }
 
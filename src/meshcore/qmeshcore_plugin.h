@@ -22,5 +22,6 @@
 #include "models/ContactModel.h"
 #include "models/ChannelModel.h"
 #include "models/MessageModel.h"
+#include "models/RxCaptureModel.h"
 
 #endif // QMESHCORE_PLUGIN_H
@@ -0,0 +1,74 @@
+#include "ContactCache.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace MeshCore {
+
+QString ContactCache::filePath(const QByteArray &devicePublicKey)
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                  + QStringLiteral("/contacts");
+    return dir + QLatin1Char('/') + QString::fromLatin1(devicePublicKey.toHex()) + QStringLiteral(".dat");
+}
+
+ContactCache::Snapshot ContactCache::load(const QByteArray &devicePublicKey)
+{
+    if (devicePublicKey.isEmpty()) {
+        return {};
+    }
+
+    QFile file(filePath(devicePublicKey));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != Magic || version != Version) {
+        qWarning() << "ContactCache: ignoring incompatible cache" << file.fileName();
+        return {};
+    }
+    in.setVersion(QDataStream::Qt_6_0);
+
+    Snapshot snapshot;
+    in >> snapshot.watermark >> snapshot.contacts;
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "ContactCache: ignoring corrupt cache" << file.fileName();
+        return {};
+    }
+
+    return snapshot;
+}
+
+bool ContactCache::save(const QByteArray &devicePublicKey, const QList<Contact> &contacts, quint32 watermark)
+{
+    if (devicePublicKey.isEmpty()) {
+        return false;
+    }
+
+    QString path = filePath(devicePublicKey);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // Written to a temporary file and renamed, so a crash never leaves a torn cache
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "ContactCache: cannot write" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out << Magic << Version;
+    out.setVersion(QDataStream::Qt_6_0);
+    out << watermark << contacts;
+
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+} // namespace MeshCore
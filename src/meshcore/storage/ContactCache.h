@@ -0,0 +1,41 @@
+#ifndef CONTACTCACHE_H
+#define CONTACTCACHE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "../types/Contact.h"
+
+namespace MeshCore {
+
+/**
+ * @brief On-disk copy of a device's contact table
+ *
+ * One file per device public key holds the contacts last synced from that
+ * device together with the lastMod watermark returned by EndOfContacts.
+ * On reconnect only contacts modified after the watermark need to be
+ * fetched with GetContacts(since).
+ */
+class ContactCache
+{
+public:
+    struct Snapshot {
+        QList<Contact> contacts;
+        quint32 watermark = 0;  // 0 when nothing usable is cached
+    };
+
+    // Returns an empty snapshot if the file is missing or unreadable
+    [[nodiscard]] static Snapshot load(const QByteArray &devicePublicKey);
+    static bool save(const QByteArray &devicePublicKey, const QList<Contact> &contacts, quint32 watermark);
+
+    [[nodiscard]] static QString filePath(const QByteArray &devicePublicKey);
+
+private:
+    static constexpr quint32 Magic = 0x514D4343;  // "QMCC"
+    static constexpr quint16 Version = 1;
+};
+
+} // namespace MeshCore
+
+#endif // CONTACTCACHE_H
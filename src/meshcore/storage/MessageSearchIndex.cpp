@@ -0,0 +1,422 @@
+#include "MessageSearchIndex.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "MessageStore.h"
+
+namespace MeshCore {
+
+namespace {
+
+// Keeps the rows that also appear in the sorted list
+template <typename List>
+void intersect(std::vector<quint32> &rows, const List &other)
+{
+    std::vector<quint32> common;
+    common.reserve(qMin(rows.size(), size_t(other.size())));
+    std::set_intersection(rows.begin(), rows.end(), other.begin(), other.end(), std::back_inserter(common));
+    rows.swap(common);
+}
+
+} // namespace
+
+MessageSearchIndex::MessageSearchIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+MessageSearchIndex::~MessageSearchIndex()
+{
+    close();
+}
+
+QStringList MessageSearchIndex::tokenize(QStringView text)
+{
+    QString folded = text.toString().toCaseFolded();
+
+    QStringList tokens;
+    qsizetype start = -1;
+    for (qsizetype i = 0; i <= folded.size(); ++i) {
+        bool inWord = i < folded.size() && folded.at(i).isLetterOrNumber();
+        if (inWord && start < 0) {
+            start = i;
+        } else if (!inWord && start >= 0) {
+            QString token = folded.mid(start, qMin(i - start, MaxTokenLength));
+            if (!tokens.contains(token)) {
+                tokens.append(token);
+            }
+            start = -1;
+        }
+    }
+    return tokens;
+}
+
+QList<MessageSearchHit> MessageSearchIndex::find(const QString &query) const
+{
+    QStringList terms = tokenize(query);
+    if (terms.isEmpty() || m_indexedCount == 0) {
+        return {};
+    }
+
+    double documents = double(m_indexedCount);
+    auto idf = [documents](qsizetype frequency) {
+        return std::log(1.0 + documents / double(qMax(frequency, qsizetype(1))));
+    };
+
+    // The last word also matches as a prefix, unless it is too short to narrow anything down
+    QString prefix;
+    if (terms.last().size() >= MinPrefixLength) {
+        prefix = terms.takeLast();
+    }
+
+    QList<const QList<quint32> *> exactRows;
+    double exactScore = 0.0;
+    for (const QString &term : terms) {
+        auto it = m_postings.constFind(term);
+        if (it == m_postings.cend()) {
+            return {};
+        }
+        exactRows.append(&it.value());
+        exactScore += idf(it->size());
+    }
+
+    // Rarest word first, so the candidate set only shrinks
+    std::sort(exactRows.begin(), exactRows.end(),
+              [](const QList<quint32> *a, const QList<quint32> *b) { return a->size() < b->size(); });
+
+    std::vector<quint32> rows;
+    for (qsizetype i = 0; i < exactRows.size(); ++i) {
+        if (i == 0) {
+            rows.assign(exactRows.at(i)->cbegin(), exactRows.at(i)->cend());
+        } else {
+            intersect(rows, *exactRows.at(i));
+        }
+        if (rows.empty()) {
+            return {};
+        }
+    }
+
+    const QList<quint32> *prefixExactRows = nullptr;
+    double prefixExactScore = 0.0;
+    double prefixScore = 0.0;
+    if (!prefix.isEmpty()) {
+        std::vector<quint32> prefixRows;
+        for (auto it = m_postings.lowerBound(prefix); it != m_postings.cend() && it.key().startsWith(prefix); ++it) {
+            if (it.key().size() == prefix.size()) {
+                prefixExactRows = &it.value();
+            }
+            prefixRows.insert(prefixRows.end(), it->cbegin(), it->cend());
+        }
+        std::sort(prefixRows.begin(), prefixRows.end());
+        prefixRows.erase(std::unique(prefixRows.begin(), prefixRows.end()), prefixRows.end());
+
+        prefixScore = idf(qsizetype(prefixRows.size())) / 2;
+        if (prefixExactRows) {
+            prefixExactScore = idf(prefixExactRows->size());
+        }
+
+        if (exactRows.isEmpty()) {
+            rows.swap(prefixRows);
+        } else {
+            intersect(rows, prefixRows);
+        }
+    }
+
+    QList<MessageSearchHit> hits;
+    hits.reserve(qsizetype(rows.size()));
+    for (quint32 row : rows) {
+        double score = exactScore;
+        if (!prefix.isEmpty()) {
+            bool exact = prefixExactRows
+                         && std::binary_search(prefixExactRows->cbegin(), prefixExactRows->cend(), row);
+            score += exact ? prefixExactScore : prefixScore;
+        }
+        hits.append({row, score});
+    }
+
+    auto ranked = [](const MessageSearchHit &a, const MessageSearchHit &b) {
+        return a.score != b.score ? a.score > b.score : a.row > b.row;
+    };
+    qsizetype kept = qMin(hits.size(), MaxHits);
+    std::partial_sort(hits.begin(), hits.begin() + kept, hits.end(), ranked);
+    hits.resize(kept);
+    return hits;
+}
+
+void MessageSearchIndex::open(const QByteArray &devicePublicKey)
+{
+    close();
+    if (devicePublicKey.isEmpty()) {
+        return;
+    }
+
+    m_devicePublicKey = devicePublicKey;
+    if (!load()) {
+        reset();
+    }
+    catchUp();
+}
+
+void MessageSearchIndex::close()
+{
+    if (!m_devicePublicKey.isEmpty() && (m_unsavedCount > 0 || m_compactPending)) {
+        save();
+    }
+    m_devicePublicKey.clear();
+    m_postings.clear();
+    m_unsaved.clear();
+    m_indexedCount = 0;
+    m_unsavedCount = 0;
+    m_snapshotSize = 0;
+    m_logSize = 0;
+    m_compactPending = false;
+}
+
+void MessageSearchIndex::addMessages(int firstRow, const QStringList &texts)
+{
+    if (m_devicePublicKey.isEmpty()) {
+        return;
+    }
+
+    // Rows the index has not seen yet are already in the store
+    if (firstRow > m_indexedCount) {
+        catchUp();
+    }
+
+    for (qsizetype i = 0; i < texts.size(); ++i) {
+        qsizetype row = firstRow + i;
+        if (row < m_indexedCount) {
+            continue;
+        }
+        addText(quint32(row), texts.at(i));
+        ++m_indexedCount;
+        ++m_unsavedCount;
+    }
+
+    if (m_unsavedCount >= SaveInterval) {
+        save();
+    }
+}
+
+void MessageSearchIndex::search(quint64 requestId, const QString &query)
+{
+    Q_EMIT searchFinished(requestId, find(query));
+}
+
+void MessageSearchIndex::addText(quint32 row, QStringView text)
+{
+    const QStringList tokens = tokenize(text);
+    for (const QString &token : tokens) {
+        QList<quint32> &rows = m_postings[token];
+        if (rows.isEmpty() || rows.last() < row) {
+            rows.append(row);
+            m_unsaved[token].append(row);
+        }
+    }
+}
+
+void MessageSearchIndex::catchUp()
+{
+    MessageStore store;
+    if (!store.open(m_devicePublicKey, QIODevice::ReadOnly)) {
+        return;
+    }
+
+    // An index ahead of its store belongs to history that no longer exists
+    if (store.count() < m_indexedCount) {
+        reset();
+    }
+
+    qsizetype added = 0;
+    while (m_indexedCount < store.count()) {
+        const QList<MessageRecord> records = store.read(m_indexedCount, CatchUpBatchSize);
+        if (records.isEmpty()) {
+            break;
+        }
+        for (const MessageRecord &record : records) {
+            addText(quint32(m_indexedCount++), record.text);
+        }
+        added += records.size();
+    }
+
+    if (added > 0) {
+        m_unsavedCount += added;
+        save();
+    }
+}
+
+void MessageSearchIndex::reset()
+{
+    m_postings.clear();
+    m_unsaved.clear();
+    m_indexedCount = 0;
+    m_unsavedCount = 0;
+    m_compactPending = true;
+}
+
+QString MessageSearchIndex::filePath() const
+{
+    return MessageStore::directory(m_devicePublicKey) + QStringLiteral("/search.dat");
+}
+
+QString MessageSearchIndex::logPath() const
+{
+    return MessageStore::directory(m_devicePublicKey) + QStringLiteral("/search.log");
+}
+
+bool MessageSearchIndex::load()
+{
+    QFile file(filePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != Magic || version != Version) {
+        qWarning() << "MessageSearchIndex: rebuilding incompatible index" << file.fileName();
+        return false;
+    }
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint64 indexedCount = 0;
+    in >> indexedCount >> m_postings;
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "MessageSearchIndex: rebuilding corrupt index" << file.fileName();
+        return false;
+    }
+
+    m_indexedCount = qsizetype(indexedCount);
+    m_snapshotSize = file.size();
+    replayLog();
+    return true;
+}
+
+void MessageSearchIndex::replayLog()
+{
+    m_logSize = 0;
+    QFile log(logPath());
+    if (!log.exists() || !log.open(QIODevice::ReadWrite)) {
+        return;
+    }
+
+    QDataStream in(&log);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    qint64 good = 0;
+    if (magic == LogMagic && version == Version) {
+        good = log.pos();
+        in.setVersion(QDataStream::Qt_6_0);
+
+        // Each delta follows the rows before it; deltas already in the snapshot
+        // remain when a compaction stopped before removing the log
+        while (!in.atEnd()) {
+            quint64 firstRow = 0;
+            quint64 rowCount = 0;
+            Postings delta;
+            in >> firstRow >> rowCount >> delta;
+            if (in.status() != QDataStream::Ok) {
+                break;
+            }
+            if (qsizetype(firstRow + rowCount) <= m_indexedCount) {
+                good = log.pos();
+                continue;
+            }
+            if (qsizetype(firstRow) != m_indexedCount) {
+                break;
+            }
+
+            for (auto it = delta.cbegin(); it != delta.cend(); ++it) {
+                m_postings[it.key()].append(it.value());
+            }
+            m_indexedCount += qsizetype(rowCount);
+            good = log.pos();
+        }
+    }
+
+    // A delta torn by a crash is dropped; catchUp() indexes its rows again
+    if (good < log.size()) {
+        qWarning() << "MessageSearchIndex: truncating damaged log" << log.fileName() << "at" << good;
+        log.resize(good);
+    }
+    m_logSize = good;
+}
+
+bool MessageSearchIndex::save()
+{
+    if (m_compactPending || !appendDelta() || m_logSize > m_snapshotSize) {
+        return compact();
+    }
+    return true;
+}
+
+bool MessageSearchIndex::appendDelta()
+{
+    if (m_unsavedCount == 0) {
+        return true;
+    }
+
+    QFile log(logPath());
+    if (!log.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "MessageSearchIndex: cannot write" << log.fileName() << log.errorString();
+        return false;
+    }
+
+    qint64 start = log.size();
+    QDataStream out(&log);
+    if (start == 0) {
+        out << LogMagic << Version;
+    }
+    out.setVersion(QDataStream::Qt_6_0);
+    out << quint64(m_indexedCount - m_unsavedCount) << quint64(m_unsavedCount) << m_unsaved;
+
+    if (out.status() != QDataStream::Ok || !log.flush()) {
+        log.resize(start);
+        return false;
+    }
+    m_logSize = log.size();
+    m_unsaved.clear();
+    m_unsavedCount = 0;
+    return true;
+}
+
+bool MessageSearchIndex::compact()
+{
+    QString path = filePath();
+
+    // Written to a temporary file and renamed, so a crash never leaves a torn index
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "MessageSearchIndex: cannot write" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out << Magic << Version;
+    out.setVersion(QDataStream::Qt_6_0);
+    out << quint64(m_indexedCount) << m_postings;
+
+    qint64 size = file.size();
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        return false;
+    }
+
+    // The snapshot now holds every delta
+    QFile::remove(logPath());
+    m_snapshotSize = size;
+    m_logSize = 0;
+    m_unsaved.clear();
+    m_unsavedCount = 0;
+    m_compactPending = false;
+    return true;
+}
+
+} // namespace MeshCore
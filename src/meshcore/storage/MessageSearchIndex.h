@@ -0,0 +1,103 @@
+#ifndef MESSAGESEARCHINDEX_H
+#define MESSAGESEARCHINDEX_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+namespace MeshCore {
+
+/**
+ * @brief One search result: a MessageModel row and its relevance
+ */
+struct MessageSearchHit
+{
+    quint32 row = 0;
+    double score = 0.0;
+};
+
+/**
+ * @brief Inverted index over the text of the stored messages
+ *
+ * Maps each case-folded word to the sorted rows of the messages that
+ * contain it. The index lives on its own thread: rows are added as the
+ * MessageModel appends them, and search() answers with searchFinished().
+ *
+ * A query matches messages containing all of its words, the last one also
+ * as a prefix so results follow typing. Hits are ranked by the inverse
+ * document frequency of the matched words, with prefix-only matches
+ * counting half, and then by recency.
+ *
+ * The index is saved next to the MessageStore it covers, together with
+ * the number of rows it holds; open() indexes whatever the store gained
+ * since. Every SaveInterval rows only the postings added since the last
+ * save are appended to a log beside the snapshot. Once the log outgrows
+ * the snapshot the two are compacted into a new snapshot, so the bytes
+ * written stay proportional to the index rather than to the number of
+ * saves.
+ */
+class MessageSearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr quint32 Magic = 0x514D5349;     // "QMSI"
+    static constexpr quint32 LogMagic = 0x514D534C;  // "QMSL"
+    static constexpr quint16 Version = 1;
+
+    static constexpr qsizetype SaveInterval = 1024;   // Rows indexed between saves
+    static constexpr qsizetype CatchUpBatchSize = 4096;
+    static constexpr qsizetype MinPrefixLength = 2;
+    static constexpr qsizetype MaxTokenLength = 32;
+    static constexpr qsizetype MaxHits = 1000;
+
+    explicit MessageSearchIndex(QObject *parent = nullptr);
+    ~MessageSearchIndex() override;
+
+    [[nodiscard]] qsizetype indexedCount() const { return m_indexedCount; }
+    [[nodiscard]] QList<MessageSearchHit> find(const QString &query) const;
+
+    // Case-folded words of the text, each once, in order of appearance
+    [[nodiscard]] static QStringList tokenize(QStringView text);
+
+public Q_SLOTS:
+    void open(const QByteArray &devicePublicKey);
+    void close();
+    void addMessages(int firstRow, const QStringList &texts);
+    void search(quint64 requestId, const QString &query);
+
+Q_SIGNALS:
+    void searchFinished(quint64 requestId, const QList<MeshCore::MessageSearchHit> &hits);
+
+private:
+    using Postings = QMap<QString, QList<quint32>>;
+
+    void addText(quint32 row, QStringView text);
+    void catchUp();
+    void reset();
+    bool load();
+    void replayLog();
+    bool save();
+    bool appendDelta();
+    bool compact();
+    [[nodiscard]] QString filePath() const;
+    [[nodiscard]] QString logPath() const;
+
+    QByteArray m_devicePublicKey;
+    Postings m_postings;  // Ordered, so a prefix is a key range
+    Postings m_unsaved;   // Added since the last save
+    qsizetype m_indexedCount = 0;
+    qsizetype m_unsavedCount = 0;
+    qint64 m_snapshotSize = 0;
+    qint64 m_logSize = 0;
+    bool m_compactPending = false;  // The files on disk no longer match the index
+};
+
+} // namespace MeshCore
+
+Q_DECLARE_METATYPE(MeshCore::MessageSearchHit)
+
+#endif // MESSAGESEARCHINDEX_H
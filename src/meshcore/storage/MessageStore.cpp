@@ -0,0 +1,498 @@
+#include "MessageStore.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <algorithm>
+
+#include "../types/ContactMessage.h"
+#include "../types/ChannelMessage.h"
+#include "../utils/FrameSchema.h"
+
+namespace MeshCore {
+
+namespace {
+
+using namespace Schema;
+
+// type, textType, pathLen, channelIndex, senderTimestamp, senderPrefix, text
+using StoredRecord = Layout<UInt8, Enum<TxtType>, UInt8, Int8, UInt32, UInt8Prefixed, Utf8Tail>;
+
+// StoredRecord without its text, which is last so it can be left undecoded
+using StoredHeader = Layout<UInt8, Enum<TxtType>, UInt8, Int8, UInt32, UInt8Prefixed>;
+
+// segment, offset, size
+using IndexEntry = Layout<UInt32, UInt32, UInt32, Reserved<4>>;
+
+} // namespace
+
+MessageRecord MessageRecord::fromMessage(const ContactMessage &message)
+{
+    MessageRecord record;
+    record.type = Contact;
+    record.text = message.text();
+    record.senderTimestamp = message.senderTimestamp();
+    record.textType = message.textType();
+    record.pathLen = message.pathLen();
+
+    QByteArray prefix = message.senderPublicKeyPrefix();
+    record.senderPrefixSize = static_cast<quint8>(qMin(prefix.size(), qsizetype(record.senderPrefix.size())));
+    std::copy_n(prefix.constData(), record.senderPrefixSize, record.senderPrefix.begin());
+    return record;
+}
+
+MessageRecord MessageRecord::fromMessage(const ChannelMessage &message)
+{
+    MessageRecord record;
+    record.type = Channel;
+    record.text = message.text();
+    record.senderTimestamp = message.senderTimestamp();
+    record.textType = message.textType();
+    record.pathLen = message.pathLen();
+    record.channelIndex = message.channelIndex();
+    return record;
+}
+
+quint64 MessageRecord::conversationKey() const
+{
+    if (type == Channel) {
+        return channelConversationKey(channelIndex);
+    }
+    return contactConversationKey(QByteArrayView(senderPrefix.data(), senderPrefixSize));
+}
+
+quint64 MessageRecord::contactConversationKey(QByteArrayView senderPrefix)
+{
+    // Up to six prefix bytes, big-endian, in the low 48 bits
+    quint64 key = 0;
+    for (qsizetype i = 0; i < 6; ++i) {
+        key = (key << 8) | (i < senderPrefix.size() ? quint8(senderPrefix.at(i)) : 0);
+    }
+    return key;
+}
+
+quint64 MessageRecord::channelConversationKey(int channelIndex)
+{
+    return (quint64(1) << 63) | quint8(channelIndex);
+}
+
+int MessageRecord::conversationChannelIndex(quint64 key)
+{
+    return (key >> 63) ? static_cast<int>(qint8(key & 0xFF)) : -1;
+}
+
+QByteArray MessageRecord::conversationSenderPrefix(quint64 key)
+{
+    if (key >> 63) {
+        return {};
+    }
+    QByteArray prefix(6, Qt::Uninitialized);
+    for (int i = 0; i < 6; ++i) {
+        prefix[i] = static_cast<char>(key >> (8 * (5 - i)));
+    }
+    return prefix;
+}
+
+MessageStore::MessageStore() = default;
+
+MessageStore::~MessageStore()
+{
+    close();
+}
+
+QString MessageStore::directory(const QByteArray &devicePublicKey)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+           + QStringLiteral("/messages/") + QString::fromLatin1(devicePublicKey.toHex());
+}
+
+QString MessageStore::segmentPath(quint32 segment) const
+{
+    return m_directory + QStringLiteral("/log-%1.dat").arg(segment, 6, 10, QLatin1Char('0'));
+}
+
+bool MessageStore::open(const QByteArray &devicePublicKey, QIODevice::OpenMode mode)
+{
+    close();
+    if (devicePublicKey.isEmpty()) {
+        return false;
+    }
+
+    m_directory = directory(devicePublicKey);
+    QDir().mkpath(m_directory);
+
+    bool writable = mode.testFlag(QIODevice::WriteOnly);
+    m_index.setFileName(m_directory + QStringLiteral("/index.dat"));
+    if (!m_index.open(writable ? QIODevice::ReadWrite : QIODevice::ReadOnly)) {
+        qWarning() << "MessageStore: cannot open" << m_index.fileName() << m_index.errorString();
+        return false;
+    }
+
+    // A partial trailing entry is a write that never completed
+    qint64 indexSize = m_index.size();
+    m_count = indexSize / IndexEntrySize;
+    if (!writable) {
+        m_devicePublicKey = devicePublicKey;
+        loadConversations();
+        return true;
+    }
+    if (indexSize % IndexEntrySize != 0) {
+        m_index.resize(m_count * IndexEntrySize);
+    }
+
+    quint32 segment = 0;
+    qint64 end = 0;
+    if (m_count > 0) {
+        BufferReader reader(reinterpret_cast<const char *>(indexEntry(m_count - 1)), IndexEntrySize);
+        auto [lastSegment, offset, size] = IndexEntry::decode(reader);
+        segment = lastSegment;
+        end = qint64(offset) + size;
+    }
+
+    if (!openWriteSegment(segment)) {
+        close();
+        return false;
+    }
+
+    // Drop records written after the last complete index entry
+    if (m_writeSegment.size() > end) {
+        m_writeSegment.resize(end);
+    }
+    m_writeSegment.seek(end);
+
+    m_devicePublicKey = devicePublicKey;
+    loadConversations();
+    catchUpConversations();
+    return true;
+}
+
+void MessageStore::close()
+{
+    unmapAll();
+    m_index.close();
+    m_writeSegment.close();
+    m_devicePublicKey.clear();
+    m_directory.clear();
+    m_count = 0;
+    m_writeSegmentNumber = 0;
+    m_conversationSizes.clear();
+    m_conversationsFailed = false;
+}
+
+bool MessageStore::append(const QList<MessageRecord> &records)
+{
+    if (records.isEmpty()) {
+        return true;
+    }
+    if (!isWritable()) {
+        return false;
+    }
+
+    BufferWriter entries(records.size() * IndexEntrySize);
+    for (const MessageRecord &record : records) {
+        QByteArrayView prefix(record.senderPrefix.data(), record.senderPrefixSize);
+        BufferWriter writer(StoredRecord::capacity(quint8(record.type), record.textType, record.pathLen,
+                                                   record.channelIndex, record.senderTimestamp, prefix,
+                                                   record.text));
+        StoredRecord::write(writer, quint8(record.type), record.textType, record.pathLen,
+                            record.channelIndex, record.senderTimestamp, prefix, record.text);
+        QByteArrayView bytes = writer.view();   // Short records never leave the writer's inline storage
+
+        if (m_writeSegment.pos() > 0 && m_writeSegment.pos() + bytes.size() > SegmentSize) {
+            m_writeSegment.flush();
+            if (!openWriteSegment(m_writeSegmentNumber + 1)) {
+                return false;
+            }
+        }
+
+        qint64 offset = m_writeSegment.pos();
+        if (m_writeSegment.write(bytes.data(), bytes.size()) != bytes.size()) {
+            qWarning() << "MessageStore: cannot write" << m_writeSegment.fileName() << m_writeSegment.errorString();
+            return false;
+        }
+        IndexEntry::write(entries, m_writeSegmentNumber, quint32(offset), quint32(bytes.size()));
+    }
+
+    // Records reach the disk before the index entries that reference them
+    m_writeSegment.flush();
+
+    QByteArray indexBytes = entries.take();
+    m_index.seek(m_count * IndexEntrySize);
+    if (m_index.write(indexBytes) != indexBytes.size() || !m_index.flush()) {
+        qWarning() << "MessageStore: cannot write" << m_index.fileName() << m_index.errorString();
+        m_index.resize(m_count * IndexEntrySize);
+        return false;
+    }
+
+    qsizetype first = m_count;
+    m_count += records.size();
+
+    // Conversation lists follow the index, which they reference
+    if (!m_conversationsFailed) {
+        QHash<quint64, QList<quint32>> rows;
+        for (qsizetype i = 0; i < records.size(); ++i) {
+            rows[records.at(i).conversationKey()].append(quint32(first + i));
+        }
+        if (!appendConversationRows(rows) || !writeConversationsCovered(m_count)) {
+            m_conversationsFailed = true;
+        }
+    }
+    return true;
+}
+
+QList<quint32> MessageStore::conversationRows(quint64 key, qsizetype first, qsizetype count) const
+{
+    qsizetype size = m_conversationSizes.value(key);
+    first = qMax(first, qsizetype(0));
+    qsizetype last = count < 0 ? size : qMin(first + count, size);
+
+    QList<quint32> rows;
+    if (first >= last) {
+        return rows;
+    }
+
+    QFile file(conversationPath(key));
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(first * 4)) {
+        qWarning() << "MessageStore: cannot read" << file.fileName() << file.errorString();
+        return rows;
+    }
+    QByteArray bytes = file.read((last - first) * 4);
+    rows.resize(bytes.size() / 4);
+    qFromLittleEndian<quint32>(bytes.constData(), rows.size(), rows.data());
+    return rows;
+}
+
+QString MessageStore::conversationPath(quint64 key) const
+{
+    return m_directory + QStringLiteral("/conversations/%1.rows").arg(key, 16, 16, QLatin1Char('0'));
+}
+
+void MessageStore::loadConversations()
+{
+    m_conversationSizes.clear();
+
+    // A partial trailing row is a write that never completed, and is ignored
+    QDir dir(m_directory + QStringLiteral("/conversations"));
+    const QFileInfoList files = dir.entryInfoList({QStringLiteral("*.rows")}, QDir::Files);
+    for (const QFileInfo &info : files) {
+        bool ok = false;
+        quint64 key = info.completeBaseName().toULongLong(&ok, 16);
+        if (ok && info.size() >= 4) {
+            m_conversationSizes.insert(key, info.size() / 4);
+        }
+    }
+}
+
+void MessageStore::catchUpConversations()
+{
+    QFile coveredFile(m_directory + QStringLiteral("/conversations.dat"));
+    qsizetype covered = 0;
+    if (coveredFile.open(QIODevice::ReadOnly) && coveredFile.size() == 8) {
+        covered = qsizetype(qFromLittleEndian<quint64>(coveredFile.readAll().constData()));
+    }
+    coveredFile.close();
+
+    // Lists ahead of the index belong to history that no longer exists
+    if (covered > m_count) {
+        qWarning() << "MessageStore: rebuilding conversation lists in" << m_directory;
+        QDir(m_directory + QStringLiteral("/conversations")).removeRecursively();
+        m_conversationSizes.clear();
+        covered = 0;
+    }
+    if (covered == m_count) {
+        return;
+    }
+
+    // Rows a list already holds were written before the covered count was
+    QHash<quint64, quint32> lastRows;
+    for (auto it = m_conversationSizes.cbegin(); it != m_conversationSizes.cend(); ++it) {
+        lastRows.insert(it.key(), conversationRows(it.key(), it.value() - 1, 1).value(0));
+    }
+
+    QHash<quint64, QList<quint32>> rows;
+    quint32 row = quint32(covered);
+    for (qsizetype first = covered; first < m_count; first += CatchUpBatchSize) {
+        const QList<MessageRecord> records = read(first, CatchUpBatchSize, WithoutText);
+        if (records.isEmpty()) {
+            break;
+        }
+        for (const MessageRecord &record : records) {
+            quint64 key = record.conversationKey();
+            auto last = lastRows.constFind(key);
+            if (last == lastRows.cend() || last.value() < row) {
+                rows[key].append(row);
+            }
+            ++row;
+        }
+    }
+
+    if (!appendConversationRows(rows) || !writeConversationsCovered(m_count)) {
+        m_conversationsFailed = true;
+    }
+}
+
+bool MessageStore::appendConversationRows(const QHash<quint64, QList<quint32>> &rows)
+{
+    if (!rows.isEmpty()) {
+        QDir().mkpath(m_directory + QStringLiteral("/conversations"));
+    }
+
+    for (auto it = rows.cbegin(); it != rows.cend(); ++it) {
+        QFile file(conversationPath(it.key()));
+        if (!file.open(QIODevice::ReadWrite)) {
+            qWarning() << "MessageStore: cannot open" << file.fileName() << file.errorString();
+            return false;
+        }
+
+        qsizetype size = m_conversationSizes.value(it.key());
+        QByteArray bytes(it->size() * 4, Qt::Uninitialized);
+        qToLittleEndian<quint32>(it->constData(), it->size(), bytes.data());
+
+        // Overwrites a partial trailing row, if any
+        if (!file.seek(size * 4) || file.write(bytes) != bytes.size() || !file.resize(file.pos())) {
+            qWarning() << "MessageStore: cannot write" << file.fileName() << file.errorString();
+            return false;
+        }
+        m_conversationSizes.insert(it.key(), size + it->size());
+    }
+    return true;
+}
+
+bool MessageStore::writeConversationsCovered(qsizetype count)
+{
+    QFile file(m_directory + QStringLiteral("/conversations.dat"));
+    char bytes[8];
+    qToLittleEndian(quint64(count), bytes);
+    if (!file.open(QIODevice::WriteOnly) || file.write(bytes, sizeof(bytes)) != sizeof(bytes)) {
+        qWarning() << "MessageStore: cannot write" << file.fileName() << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QList<MessageRecord> MessageStore::read(qsizetype first, qsizetype count, TextMode mode) const
+{
+    first = qMax(first, qsizetype(0));
+    qsizetype last = qMin(first + count, m_count);
+
+    QList<MessageRecord> records;
+    if (first >= last) {
+        return records;
+    }
+    records.reserve(last - first);
+
+    for (qsizetype row = first; row < last; ++row) {
+        const uchar *entry = indexEntry(row);
+        if (!entry) {
+            break;
+        }
+        BufferReader entryReader(reinterpret_cast<const char *>(entry), IndexEntrySize);
+        auto [segment, offset, size] = IndexEntry::decode(entryReader);
+
+        QByteArrayView data = segmentData(segment, qint64(offset) + size);
+        if (data.size() < qint64(offset) + size) {
+            qWarning() << "MessageStore: record" << row << "lies outside its segment";
+            break;
+        }
+
+        BufferReader reader(data.sliced(offset, size));
+        auto [type, textType, pathLen, channelIndex, senderTimestamp, prefix] = StoredHeader::decode(reader);
+
+        MessageRecord record;
+        record.type = type == MessageRecord::Channel ? MessageRecord::Channel : MessageRecord::Contact;
+        record.textType = textType;
+        record.pathLen = pathLen;
+        record.channelIndex = channelIndex;
+        record.senderTimestamp = senderTimestamp;
+        record.senderPrefixSize = static_cast<quint8>(qMin(prefix.size(), qsizetype(record.senderPrefix.size())));
+        std::copy_n(prefix.data(), record.senderPrefixSize, record.senderPrefix.begin());
+        if (mode == WithText) {
+            record.text = reader.readString();
+        }
+        records.append(std::move(record));
+    }
+
+    return records;
+}
+
+const uchar *MessageStore::indexEntry(qsizetype row) const
+{
+    // Entries appended since the last mapping are picked up by remapping
+    if (row >= m_indexMappedCount) {
+        if (m_indexMap) {
+            const_cast<QFile &>(m_index).unmap(m_indexMap);
+            m_indexMap = nullptr;
+            m_indexMappedCount = 0;
+        }
+        if (m_count == 0) {
+            return nullptr;
+        }
+        m_indexMap = const_cast<QFile &>(m_index).map(0, m_count * IndexEntrySize);
+        if (!m_indexMap) {
+            qWarning() << "MessageStore: cannot map" << m_index.fileName() << m_index.errorString();
+            return nullptr;
+        }
+        m_indexMappedCount = m_count;
+    }
+    return row < m_indexMappedCount ? m_indexMap + row * IndexEntrySize : nullptr;
+}
+
+QByteArrayView MessageStore::segmentData(quint32 segment, qint64 end) const
+{
+    Segment &mapped = m_segments[segment];
+    if (mapped.mappedSize < end) {
+        if (!mapped.file) {
+            mapped.file = std::make_unique<QFile>(segmentPath(segment));
+            if (!mapped.file->open(QIODevice::ReadOnly)) {
+                qWarning() << "MessageStore: cannot open" << mapped.file->fileName() << mapped.file->errorString();
+                m_segments.erase(segment);
+                return {};
+            }
+        }
+        if (mapped.data) {
+            mapped.file->unmap(mapped.data);
+            mapped.data = nullptr;
+            mapped.mappedSize = 0;
+        }
+
+        // Only the segment being written grows, so mapping it whole is enough
+        qint64 size = mapped.file->size();
+        if (size > 0) {
+            mapped.data = mapped.file->map(0, size);
+            mapped.mappedSize = mapped.data ? size : 0;
+        }
+    }
+    return QByteArrayView(mapped.data, mapped.mappedSize);
+}
+
+bool MessageStore::openWriteSegment(quint32 segment)
+{
+    m_writeSegment.close();
+    m_writeSegment.setFileName(segmentPath(segment));
+    if (!m_writeSegment.open(QIODevice::ReadWrite)) {
+        qWarning() << "MessageStore: cannot open" << m_writeSegment.fileName() << m_writeSegment.errorString();
+        return false;
+    }
+    m_writeSegment.seek(m_writeSegment.size());
+    m_writeSegmentNumber = segment;
+    return true;
+}
+
+void MessageStore::unmapAll()
+{
+    if (m_indexMap) {
+        m_index.unmap(m_indexMap);
+        m_indexMap = nullptr;
+    }
+    m_indexMappedCount = 0;
+
+    for (auto &[number, segment] : m_segments) {
+        if (segment.data) {
+            segment.file->unmap(segment.data);
+        }
+    }
+    m_segments.clear();
+}
+
+} // namespace MeshCore
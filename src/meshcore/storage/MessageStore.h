@@ -0,0 +1,146 @@
+#ifndef MESSAGESTORE_H
+#define MESSAGESTORE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include "../MeshCoreConstants.h"
+
+namespace MeshCore {
+
+class ContactMessage;
+class ChannelMessage;
+
+/**
+ * @brief One stored message, holding the fields of either message type
+ */
+struct MessageRecord
+{
+    enum Type : quint8 {
+        Contact = 0,  // Values match MessageModel::MessageType
+        Channel = 1
+    };
+
+    QString text;
+    quint32 senderTimestamp = 0;
+    Type type = Contact;
+    TxtType textType = TxtType::Plain;
+    quint8 pathLen = 0;
+    qint8 channelIndex = -1;             // Channel messages only
+    quint8 senderPrefixSize = 0;
+    std::array<char, 6> senderPrefix{};  // Contact messages only
+
+    static MessageRecord fromMessage(const ContactMessage &message);
+    static MessageRecord fromMessage(const ChannelMessage &message);
+
+    // Identifies the conversation: the sender prefix or the channel index
+    [[nodiscard]] quint64 conversationKey() const;
+    [[nodiscard]] static quint64 contactConversationKey(QByteArrayView senderPrefix);
+    [[nodiscard]] static quint64 channelConversationKey(int channelIndex);
+    // Inverse of the above: -1 for contact keys, empty for channel keys
+    [[nodiscard]] static int conversationChannelIndex(quint64 key);
+    [[nodiscard]] static QByteArray conversationSenderPrefix(quint64 key);
+};
+
+/**
+ * @brief Append-only message history of one device identity
+ *
+ * Messages are appended to segment files of up to SegmentSize bytes and
+ * located through an index file of fixed 16-byte entries (segment, offset,
+ * size, reserved). Both are memory-mapped for reading, so opening a store
+ * costs the same regardless of how much history it holds; records are
+ * decoded only when read().
+ *
+ * Records are written before their index entry, so a crash can only lose
+ * the last messages, never corrupt earlier ones. A store opened ReadOnly
+ * may share the files with one writer, and sees the rows stored when it
+ * was opened.
+ *
+ * The rows of each conversation are also listed in a file of their own,
+ * appended after the index entries, so a conversation can be opened or
+ * summarised without scanning the history. conversations.dat records how
+ * many rows the lists cover; a writable open() lists whatever rows a
+ * crash left out.
+ */
+class MessageStore
+{
+public:
+    static constexpr qint64 SegmentSize = 4 * 1024 * 1024;
+
+    MessageStore();
+    ~MessageStore();
+    MessageStore(const MessageStore &) = delete;
+    MessageStore &operator=(const MessageStore &) = delete;
+
+    bool open(const QByteArray &devicePublicKey, QIODevice::OpenMode mode = QIODevice::ReadWrite);
+    void close();
+    [[nodiscard]] bool isOpen() const { return m_index.isOpen(); }
+    [[nodiscard]] bool isWritable() const { return m_writeSegment.isOpen(); }
+    [[nodiscard]] QByteArray devicePublicKey() const { return m_devicePublicKey; }
+
+    enum TextMode {
+        WithText,
+        WithoutText  // Leaves text empty and skips decoding it
+    };
+
+    [[nodiscard]] qsizetype count() const { return m_count; }
+    bool append(const QList<MessageRecord> &records);
+    // Rows [first, first + count) clipped to the stored range
+    [[nodiscard]] QList<MessageRecord> read(qsizetype first, qsizetype count, TextMode mode = WithText) const;
+
+    // Rows of each conversation; see MessageRecord::conversationKey()
+    [[nodiscard]] QList<quint64> conversationKeys() const { return m_conversationSizes.keys(); }
+    [[nodiscard]] qsizetype conversationSize(quint64 key) const { return m_conversationSizes.value(key); }
+    // Rows [first, first + count) of the conversation, clipped; count -1 reads to the end
+    [[nodiscard]] QList<quint32> conversationRows(quint64 key, qsizetype first = 0, qsizetype count = -1) const;
+
+    [[nodiscard]] static QString directory(const QByteArray &devicePublicKey);
+
+private:
+    static constexpr qsizetype IndexEntrySize = 16;
+    static constexpr qsizetype CatchUpBatchSize = 4096;
+
+    struct Segment {
+        std::unique_ptr<QFile> file;
+        uchar *data = nullptr;
+        qint64 mappedSize = 0;
+    };
+
+    [[nodiscard]] QString segmentPath(quint32 segment) const;
+    const uchar *indexEntry(qsizetype row) const;
+    QByteArrayView segmentData(quint32 segment, qint64 end) const;
+    bool openWriteSegment(quint32 segment);
+    void unmapAll();
+
+    [[nodiscard]] QString conversationPath(quint64 key) const;
+    void loadConversations();
+    void catchUpConversations();
+    bool appendConversationRows(const QHash<quint64, QList<quint32>> &rows);
+    bool writeConversationsCovered(qsizetype count);
+
+    QByteArray m_devicePublicKey;
+    QString m_directory;
+    qsizetype m_count = 0;
+
+    QFile m_index;                 // Opened for appending and mapped for reading
+    mutable uchar *m_indexMap = nullptr;
+    mutable qsizetype m_indexMappedCount = 0;
+
+    QFile m_writeSegment;          // Segment new records are appended to
+    quint32 m_writeSegmentNumber = 0;
+
+    mutable std::unordered_map<quint32, Segment> m_segments;  // Mapped for reading
+
+    QHash<quint64, qsizetype> m_conversationSizes;
+    bool m_conversationsFailed = false;  // Lists stop being updated until the next open
+};
+
+} // namespace MeshCore
+
+#endif // MESSAGESTORE_H
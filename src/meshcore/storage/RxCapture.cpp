@@ -0,0 +1,382 @@
+#include "RxCapture.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <algorithm>
+#include <utility>
+
+#include "../utils/BufferReader.h"
+#include "../utils/BufferWriter.h"
+#include "../utils/FrameSchema.h"
+
+namespace MeshCore {
+
+namespace {
+
+using namespace Schema;
+
+// magic, version, reserved, start time (ms since epoch)
+using FileHeader = Layout<UInt32, UInt16, Reserved<2>, Int64>;
+
+// type, body size
+using RecordHeader = Layout<Enum<RxCapture::RecordType>, UInt16>;
+
+// ms since start, SNR * 4, RSSI, raw bytes
+using PacketBody = Layout<UInt64, Int8, Int8, Tail>;
+
+// first row, previous index offset, chunk start; followed by u32 offsets
+using IndexBody = Layout<UInt64, UInt64, UInt64>;
+
+// last index offset, row count, magic
+using TrailerBody = Layout<UInt64, UInt64, UInt32>;
+
+constexpr qsizetype TrailerSize = RecordHeader::fixedSize + TrailerBody::fixedSize;
+
+} // namespace
+
+QString RxCapture::directory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/captures");
+}
+
+// === RxCaptureWriter ===
+
+RxCaptureWriter::~RxCaptureWriter()
+{
+    close();
+}
+
+QString RxCaptureWriter::defaultPath()
+{
+    return RxCapture::directory() + QStringLiteral("/rx-")
+           + QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-HHmmss"))
+           + QLatin1Char('.') + RxCapture::FileSuffix;
+}
+
+bool RxCaptureWriter::open(const QString &path)
+{
+    close();
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "RxCaptureWriter: cannot open" << path << m_file.errorString();
+        return false;
+    }
+
+    m_startMs = QDateTime::currentMSecsSinceEpoch();
+    m_lastSinceStartMs = 0;
+    m_rowCount = 0;
+    m_written = 0;
+    m_lastIndexOffset = 0;
+    m_chunkOffsets.clear();
+    m_chunkOffsets.reserve(RxCapture::IndexInterval);
+
+    BufferWriter header(FileHeader::fixedSize);
+    FileHeader::write(header, RxCapture::Magic, RxCapture::Version, m_startMs);
+    m_buffer = header.take();
+    m_buffer.reserve(BufferSize);
+    m_chunkStart = offset();
+    return true;
+}
+
+void RxCaptureWriter::close()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    BufferWriter trailer(TrailerBody::fixedSize);
+    TrailerBody::write(trailer, quint64(m_lastIndexOffset), m_rowCount, RxCapture::Magic);
+    appendRecord(RxCapture::RecordType::Trailer, trailer.view());
+
+    flush();
+    m_file.close();
+}
+
+void RxCaptureWriter::append(qint64 receivedAtMs, double snr, qint8 rssi, QByteArrayView rawData)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    if (m_chunkOffsets.isEmpty()) {
+        m_chunkStart = offset();
+    }
+    m_chunkOffsets.append(quint32(offset() - m_chunkStart));
+
+    // Bodies are limited to 16 bits; radio packets are far smaller
+    rawData.truncate(qMin(rawData.size(), qsizetype(0xFFFF) - PacketBody::fixedSize));
+    // Keep rows in time order for rowAtTime() when the wall clock steps back
+    m_lastSinceStartMs = qMax(receivedAtMs - m_startMs, m_lastSinceStartMs);
+
+    BufferWriter body(PacketBody::fixedSize + rawData.size());
+    PacketBody::write(body, quint64(m_lastSinceStartMs),
+                      qint8(qBound(-128, qRound(snr * 4), 127)), rssi, rawData);
+    appendRecord(RxCapture::RecordType::Packet, body.view());
+    ++m_rowCount;
+
+    if (m_chunkOffsets.size() == RxCapture::IndexInterval) {
+        appendIndex();
+    }
+
+    if (m_buffer.size() >= BufferSize) {
+        flush();
+    }
+}
+
+bool RxCaptureWriter::flush()
+{
+    if (m_buffer.isEmpty()) {
+        return true;
+    }
+
+    qint64 written = m_file.write(m_buffer);
+    if (written != m_buffer.size()) {
+        qWarning() << "RxCaptureWriter: cannot write" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+    m_written += written;
+    m_buffer.resize(0);  // Keeps the capacity
+    return m_file.flush();
+}
+
+void RxCaptureWriter::appendRecord(RxCapture::RecordType type, QByteArrayView body)
+{
+    char header[RecordHeader::fixedSize];
+    header[0] = char(type);
+    qToLittleEndian(quint16(body.size()), header + 1);
+    m_buffer.append(header, sizeof(header));
+    m_buffer.append(body);
+}
+
+void RxCaptureWriter::appendIndex()
+{
+    qint64 indexOffset = offset();
+
+    BufferWriter body(IndexBody::fixedSize + m_chunkOffsets.size() * 4);
+    IndexBody::write(body, quint64(m_rowCount - m_chunkOffsets.size()), quint64(m_lastIndexOffset),
+                     quint64(m_chunkStart));
+    for (quint32 chunkOffset : std::as_const(m_chunkOffsets)) {
+        body.writeUInt32LE(chunkOffset);
+    }
+    appendRecord(RxCapture::RecordType::Index, body.view());
+
+    m_lastIndexOffset = indexOffset;
+    m_chunkOffsets.clear();
+}
+
+// === RxCaptureReader ===
+
+RxCaptureReader::~RxCaptureReader()
+{
+    close();
+}
+
+bool RxCaptureReader::open(const QString &path)
+{
+    close();
+    m_errorString.clear();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail(m_file.errorString());
+    }
+    m_size = m_file.size();
+    if (m_size < FileHeader::fixedSize) {
+        return fail(QStringLiteral("Not a capture file"));
+    }
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        return fail(m_file.errorString());
+    }
+
+    BufferReader header(reinterpret_cast<const char *>(m_data), FileHeader::fixedSize);
+    auto [magic, version, startMs] = FileHeader::decode(header);
+    if (magic != RxCapture::Magic || version != RxCapture::Version) {
+        return fail(QStringLiteral("Not a capture file, or an unsupported version"));
+    }
+    m_startMs = startMs;
+
+    if (!openFromTrailer()) {
+        // Unclosed capture: recover it by walking every record once
+        m_indexOffsets.clear();
+        m_tailOffsets.clear();
+        scan(FileHeader::fixedSize, m_size);
+    }
+    return true;
+}
+
+void RxCaptureReader::close()
+{
+    if (m_data) {
+        m_file.unmap(m_data);
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_indexOffsets.clear();
+    m_tailOffsets.clear();
+}
+
+qsizetype RxCaptureReader::count() const
+{
+    return m_indexOffsets.size() * RxCapture::IndexInterval + m_tailOffsets.size();
+}
+
+RxLogEntry RxCaptureReader::entry(qsizetype row) const
+{
+    Record record;
+    if (!readRecord(recordOffset(row), record) || record.type != RxCapture::RecordType::Packet) {
+        return {};
+    }
+
+    BufferReader reader(record.body);
+    auto [sinceStartMs, snrQuarters, rssi, rawData] = PacketBody::decode(reader);
+    return RxLogEntry(m_startMs + qint64(sinceStartMs), snrQuarters / 4.0, rssi, rawData.toByteArray());
+}
+
+qint64 RxCaptureReader::receivedAtMs(qsizetype row) const
+{
+    Record record;
+    if (!readRecord(recordOffset(row), record) || record.type != RxCapture::RecordType::Packet) {
+        return 0;
+    }
+
+    BufferReader reader(record.body);
+    return m_startMs + qint64(Schema::UInt64::read(reader));
+}
+
+qsizetype RxCaptureReader::rowAtTime(qint64 ms) const
+{
+    qsizetype first = 0;
+    qsizetype last = count();
+    while (first < last) {
+        qsizetype middle = first + (last - first) / 2;
+        if (receivedAtMs(middle) < ms) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+bool RxCaptureReader::readRecord(qint64 offset, Record &record) const
+{
+    if (offset < FileHeader::fixedSize || offset + RecordHeader::fixedSize > m_size) {
+        return false;
+    }
+
+    BufferReader header(reinterpret_cast<const char *>(m_data + offset), RecordHeader::fixedSize);
+    auto [type, size] = RecordHeader::decode(header);
+    qint64 bodyOffset = offset + RecordHeader::fixedSize;
+    if (bodyOffset + size > m_size) {
+        return false;  // Torn write at the end of an unclosed capture
+    }
+
+    record.type = type;
+    record.body = QByteArrayView(m_data + bodyOffset, size);
+    record.end = bodyOffset + size;
+    return true;
+}
+
+qint64 RxCaptureReader::recordOffset(qsizetype row) const
+{
+    if (row < 0 || row >= count()) {
+        return -1;
+    }
+
+    qsizetype chunk = row / RxCapture::IndexInterval;
+    if (chunk >= m_indexOffsets.size()) {
+        return m_tailOffsets.at(row - m_indexOffsets.size() * RxCapture::IndexInterval);
+    }
+
+    Record index;
+    if (!readRecord(m_indexOffsets.at(chunk), index)) {
+        return -1;
+    }
+    BufferReader reader(index.body);
+    auto [firstRow, previousIndex, chunkStart] = IndexBody::decode(reader);
+    reader.skip((row % RxCapture::IndexInterval) * 4);
+    quint32 relative = reader.readUInt32LE();
+    return reader.hasError() ? -1 : qint64(chunkStart) + relative;
+}
+
+bool RxCaptureReader::openFromTrailer()
+{
+    Record trailer;
+    if (m_size < FileHeader::fixedSize + TrailerSize || !readRecord(m_size - TrailerSize, trailer)
+        || trailer.type != RxCapture::RecordType::Trailer || trailer.end != m_size) {
+        return false;
+    }
+
+    BufferReader reader(trailer.body);
+    auto [lastIndex, rowCount, magic] = TrailerBody::decode(reader);
+    if (reader.hasError() || magic != RxCapture::Magic) {
+        return false;
+    }
+
+    // Follow the chain of index records back to the first chunk
+    QList<qint64> indexOffsets;
+    for (qint64 offset = qint64(lastIndex); offset != 0;) {
+        Record index;
+        if (!readRecord(offset, index) || index.type != RxCapture::RecordType::Index) {
+            return false;
+        }
+        BufferReader indexReader(index.body);
+        auto [firstRow, previousIndex, chunkStart] = IndexBody::decode(indexReader);
+        indexOffsets.append(offset);
+        offset = qint64(previousIndex);
+    }
+    std::reverse(indexOffsets.begin(), indexOffsets.end());
+    m_indexOffsets = indexOffsets;
+
+    // Packets after the last full chunk are not indexed
+    qint64 tailStart = FileHeader::fixedSize;
+    if (!m_indexOffsets.isEmpty()) {
+        Record last;
+        if (!readRecord(m_indexOffsets.last(), last)) {
+            return false;
+        }
+        tailStart = last.end;
+    }
+    m_tailOffsets.clear();
+    scan(tailStart, m_size - TrailerSize);
+
+    return count() == qsizetype(rowCount);
+}
+
+void RxCaptureReader::scan(qint64 from, qint64 end)
+{
+    Record record;
+    for (qint64 offset = from; offset < end && readRecord(offset, record); offset = record.end) {
+        switch (record.type) {
+        case RxCapture::RecordType::Packet:
+            m_tailOffsets.append(offset);
+            break;
+        case RxCapture::RecordType::Index:
+            // The chunk it covers now lies behind an index
+            m_indexOffsets.append(offset);
+            m_tailOffsets.clear();
+            break;
+        case RxCapture::RecordType::Trailer:
+            return;
+        default:
+            qWarning() << "RxCaptureReader: unknown record at" << offset << "in" << m_file.fileName();
+            return;
+        }
+    }
+}
+
+bool RxCaptureReader::fail(const QString &error)
+{
+    m_errorString = error;
+    close();
+    return false;
+}
+
+} // namespace MeshCore
@@ -0,0 +1,151 @@
+#ifndef RXCAPTURE_H
+#define RXCAPTURE_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QList>
+#include <QString>
+
+#include "../types/RxLogEntry.h"
+
+namespace MeshCore {
+
+/**
+ * @brief Binary capture file of received radio packets
+ *
+ * A 16-byte file header (magic, version, start time) is followed by
+ * records, each a type byte and a 16-bit body size:
+ *
+ *   Packet   ms since start (u64), SNR * 4 (i8), RSSI (i8), raw bytes;
+ *            never earlier than the previous packet's, so rows stay in
+ *            time order across wall clock changes
+ *   Index    first row, previous index offset, chunk start (u64 each),
+ *            then one u32 offset per packet of the chunk, relative to
+ *            the chunk start; written after every IndexInterval packets
+ *   Trailer  last index offset, row count (u64 each), magic (u32);
+ *            written when the capture is closed
+ *
+ * A closed capture is opened by following the index chain back from the
+ * trailer. An unclosed one, after a crash or while still being written,
+ * is recovered by walking its records once.
+ */
+namespace RxCapture {
+
+inline constexpr quint32 Magic = 0x514D5258;  // "QMRX"
+inline constexpr quint16 Version = 2;
+inline constexpr qsizetype IndexInterval = 1024;
+inline constexpr QLatin1StringView FileSuffix("qmrx");
+
+enum class RecordType : quint8 {
+    Packet = 1,
+    Index = 2,
+    Trailer = 3
+};
+
+// Directory new captures are written to
+[[nodiscard]] QString directory();
+
+} // namespace RxCapture
+
+/**
+ * @brief Buffered, append-only writer of a capture file
+ *
+ * Packets are encoded into an in-memory buffer that is written out when it
+ * reaches BufferSize, so each packet costs a memcpy and the file sees a few
+ * large writes. The owner calls flush() every FlushIntervalMs so a quiet
+ * capture still reaches the disk. Meant to run on the device worker
+ * thread.
+ */
+class RxCaptureWriter
+{
+public:
+    static constexpr qsizetype BufferSize = 64 * 1024;
+    static constexpr qint64 FlushIntervalMs = 1000;
+
+    RxCaptureWriter() = default;
+    ~RxCaptureWriter();
+    RxCaptureWriter(const RxCaptureWriter &) = delete;
+    RxCaptureWriter &operator=(const RxCaptureWriter &) = delete;
+
+    bool open(const QString &path);
+    void close();
+    [[nodiscard]] bool isOpen() const { return m_file.isOpen(); }
+    [[nodiscard]] QString path() const { return m_file.fileName(); }
+    [[nodiscard]] quint64 rowCount() const { return m_rowCount; }
+
+    void append(qint64 receivedAtMs, double snr, qint8 rssi, QByteArrayView rawData);
+    bool flush();
+
+    // A new file in RxCapture::directory() named after the current time
+    [[nodiscard]] static QString defaultPath();
+
+private:
+    void appendRecord(RxCapture::RecordType type, QByteArrayView body);
+    void appendIndex();
+    [[nodiscard]] qint64 offset() const { return m_written + m_buffer.size(); }
+
+    QFile m_file;
+    QByteArray m_buffer;
+    qint64 m_written = 0;          // Bytes already in the file
+
+    qint64 m_startMs = 0;
+    qint64 m_lastSinceStartMs = 0;  // Time of the last packet, ms since start
+    quint64 m_rowCount = 0;
+    qint64 m_chunkStart = 0;       // Offset of the first packet of the current chunk
+    QList<quint32> m_chunkOffsets;
+    qint64 m_lastIndexOffset = 0;
+};
+
+/**
+ * @brief Random access to a memory-mapped capture file
+ *
+ * Opening reads only the index records; a row is located through its
+ * chunk's index and decoded when entry() is called, so captures of any
+ * size open quickly and cost memory only for the rows in use.
+ */
+class RxCaptureReader
+{
+public:
+    RxCaptureReader() = default;
+    ~RxCaptureReader();
+    RxCaptureReader(const RxCaptureReader &) = delete;
+    RxCaptureReader &operator=(const RxCaptureReader &) = delete;
+
+    bool open(const QString &path);
+    void close();
+    [[nodiscard]] bool isOpen() const { return m_data != nullptr; }
+    [[nodiscard]] QString errorString() const { return m_errorString; }
+
+    [[nodiscard]] qsizetype count() const;
+    [[nodiscard]] RxLogEntry entry(qsizetype row) const;
+    [[nodiscard]] qint64 receivedAtMs(qsizetype row) const;
+    // First row received at or after ms, assuming rows are in time order
+    [[nodiscard]] qsizetype rowAtTime(qint64 ms) const;
+
+private:
+    struct Record {
+        RxCapture::RecordType type;
+        QByteArrayView body;
+        qint64 end = 0;
+    };
+
+    [[nodiscard]] bool readRecord(qint64 offset, Record &record) const;
+    [[nodiscard]] qint64 recordOffset(qsizetype row) const;
+    bool openFromTrailer();
+    void scan(qint64 from, qint64 end);
+    bool fail(const QString &error);
+
+    QFile m_file;
+    uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    qint64 m_startMs = 0;
+    QString m_errorString;
+
+    QList<qint64> m_indexOffsets;  // One per full chunk, in row order
+    QList<qint64> m_tailOffsets;   // Packets after the last index
+};
+
+} // namespace MeshCore
+
+#endif // RXCAPTURE_H
@@ -1,5 +1,5 @@
 #include "Advert.h"
-#include "../utils/BufferReader.h"
+#include "../utils/PacketView.h"
 
 namespace MeshCore {
 
@@ -13,16 +13,22 @@ Advert::Advert(const QByteArray &publicKey, quint32 timestamp,
     parseAppData();
 }
 
-Advert Advert::fromBytes(const QByteArray &data)
+Advert::Advert(const AdvertPayload &payload)
+    : m_publicKey(payload.publicKey.toByteArray())
+    , m_timestamp(payload.timestamp)
+    , m_signature(payload.signature.toByteArray())
+    , m_appData(payload.rawAppData.toByteArray())
 {
-    BufferReader reader(data);
-
-    QByteArray publicKey = reader.readBytes(32);
-    quint32 timestamp = reader.readUInt32LE();
-    QByteArray signature = reader.readBytes(64);
-    QByteArray appData = reader.readRemainingBytes();
+    setAppData(payload.appData);
+}
 
-    return Advert(publicKey, timestamp, signature, appData);
+Advert Advert::fromBytes(const QByteArray &data)
+{
+    AdvertPayload payload = AdvertPayload::decode(data);
+    if (!payload.valid) {
+        return Advert();
+    }
+    return Advert(payload);
 }
 
 QString Advert::publicKeyHex() const
@@ -37,7 +43,7 @@ quint8 Advert::flags() const
 
 AdvertType Advert::type() const
 {
-    return static_cast<AdvertType>(m_flags & 0x0F);
+    return static_cast<AdvertType>(m_flags & AdvertFlags::TypeMask);
 }
 
 QString Advert::typeString() const
@@ -63,12 +69,12 @@ bool Advert::hasName() const
 
 double Advert::latitudeDecimal() const
 {
-    return static_cast<double>(m_latitude) / 1e7;
+    return static_cast<double>(m_latitude) / 1e6;
 }
 
 double Advert::longitudeDecimal() const
 {
-    return static_cast<double>(m_longitude) / 1e7;
+    return static_cast<double>(m_longitude) / 1e6;
 }
 
 void Advert::parseAppData()
@@ -76,24 +82,15 @@ void Advert::parseAppData()
     if (m_appData.isEmpty()) {
         return;
     }
+    setAppData(AdvertAppData::decode(m_appData));
+}
 
-    BufferReader reader(m_appData);
-    m_flags = reader.readByte();
-
-    // Parse lat/lon if present
-    if (m_flags & AdvertFlags::LatLonMask) {
-        if (reader.remainingBytes() >= 8) {
-            m_latitude = reader.readInt32LE();
-            m_longitude = reader.readInt32LE();
-        }
-    }
-
-    // Parse name if present
-    if (m_flags & AdvertFlags::NameMask) {
-        if (reader.hasRemaining()) {
-            m_name = reader.readString();
-        }
-    }
+void Advert::setAppData(const AdvertAppData &appData)
+{
+    m_flags = appData.flags;
+    m_latitude = appData.latitude;
+    m_longitude = appData.longitude;
+    m_name = QString::fromUtf8(appData.name);
 }
 
 } // namespace MeshCore
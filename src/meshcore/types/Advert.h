@@ -9,6 +9,9 @@
 
 namespace MeshCore {
 
+struct AdvertAppData;
+struct AdvertPayload;
+
 /**
  * @brief Represents an advertisement packet from a node
  */
@@ -35,6 +38,8 @@ public:
     Advert(const QByteArray &publicKey, quint32 timestamp,
            const QByteArray &signature, const QByteArray &appData);
 
+    explicit Advert(const AdvertPayload &payload);
+
     static Advert fromBytes(const QByteArray &data);
 
     [[nodiscard]] QByteArray publicKey() const { return m_publicKey; }
@@ -59,6 +64,7 @@ public:
 
 private:
     void parseAppData();
+    void setAppData(const AdvertAppData &appData);
 
     QByteArray m_publicKey;   // 32 bytes
     quint32 m_timestamp = 0;
@@ -1,26 +1,45 @@
 #include "Contact.h"
+#include <QDataStream>
+#include <QStringEncoder>
+#include <QVarLengthArray>
+#include <cstring>
 
 namespace MeshCore {
 
-Contact::Contact(const QByteArray &publicKey, AdvertType type, quint8 flags,
-                 qint8 outPathLen, const QByteArray &outPath, const QString &name,
+Contact::Contact(QByteArrayView publicKey, AdvertType type, quint8 flags,
+                 qint8 outPathLen, QByteArrayView outPath, QStringView name,
                  quint32 lastAdvert, qint32 latitude, qint32 longitude, quint32 lastModified)
-    : m_publicKey(publicKey)
-    , m_type(type)
+    : m_type(type)
     , m_flags(flags)
     , m_outPathLen(outPathLen)
-    , m_outPath(outPath)
-    , m_name(name)
     , m_lastAdvert(lastAdvert)
     , m_latitude(latitude)
     , m_longitude(longitude)
     , m_lastModified(lastModified)
 {
+    m_publicKeySize = static_cast<quint8>(qMin(publicKey.size(), qsizetype(PublicKeySize)));
+    std::memcpy(m_publicKey.data(), publicKey.data(), m_publicKeySize);
+
+    m_outPathSize = static_cast<quint8>(qMin(outPath.size(), qsizetype(MaxPathSize)));
+    std::memcpy(m_outPath.data(), outPath.data(), m_outPathSize);
+
+    // A name longer than MaxNameSize bytes is cut before a partial UTF-8 sequence
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    QVarLengthArray<char, 3 * MaxNameSize> utf8(encoder.requiredSpace(name.size()));
+    qsizetype size = encoder.appendToBuffer(utf8.data(), name) - utf8.data();
+    if (size > MaxNameSize) {
+        size = MaxNameSize;
+        while (size > 0 && (static_cast<quint8>(utf8[size]) & 0xC0) == 0x80) {
+            --size;
+        }
+    }
+    m_nameSize = static_cast<quint8>(size);
+    std::memcpy(m_name.data(), utf8.data(), m_nameSize);
 }
 
 QString Contact::publicKeyHex() const
 {
-    return QString::fromLatin1(m_publicKey.toHex());
+    return QString::fromLatin1(QByteArray::fromRawData(m_publicKey.data(), m_publicKeySize).toHex());
 }
 
 double Contact::latitudeDecimal() const
@@ -47,12 +66,43 @@ QString Contact::typeString() const
 
 QByteArray Contact::publicKeyPrefix(int length) const
 {
-    return m_publicKey.left(length);
+    return publicKeyView().first(qBound(0, length, int(m_publicKeySize))).toByteArray();
 }
 
 bool Contact::operator==(const Contact &other) const
 {
-    return m_publicKey == other.m_publicKey;
+    return publicKeyView() == other.publicKeyView();
+}
+
+QDataStream &operator<<(QDataStream &out, const Contact &contact)
+{
+    out << contact.publicKey() << static_cast<quint8>(contact.type()) << contact.flags()
+        << contact.outPathLen() << contact.outPath() << contact.name() << contact.lastAdvert()
+        << contact.latitude() << contact.longitude() << contact.lastModified();
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, Contact &contact)
+{
+    QByteArray publicKey;
+    quint8 type = 0;
+    quint8 flags = 0;
+    qint8 outPathLen = 0;
+    QByteArray outPath;
+    QString name;
+    quint32 lastAdvert = 0;
+    qint32 latitude = 0;
+    qint32 longitude = 0;
+    quint32 lastModified = 0;
+
+    in >> publicKey >> type >> flags >> outPathLen >> outPath >> name >> lastAdvert
+       >> latitude >> longitude >> lastModified;
+
+    if (in.status() == QDataStream::Ok) {
+        contact = Contact(publicKey, static_cast<AdvertType>(type), flags, outPathLen, outPath,
+                          name, lastAdvert, latitude, longitude, lastModified);
+    }
+    return in;
 }
 
 } // namespace MeshCore
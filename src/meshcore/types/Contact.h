@@ -3,10 +3,16 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
+#include <QStringView>
 #include <QtQml/qqmlregistration.h>
+#include <array>
+#include <type_traits>
 #include "../MeshCoreConstants.h"
 
+class QDataStream;
+
 namespace MeshCore {
 
 /**
@@ -14,6 +20,10 @@ namespace MeshCore {
  *
  * This class is a QML-friendly gadget type that holds contact information
  * received from the device.
+ *
+ * The key, path and name are stored inline (the name as UTF-8), so a
+ * Contact owns no heap memory and copies are plain memcpy. The QByteArray
+ * and QString getters build their values on demand.
  */
 class Contact
 {
@@ -35,18 +45,24 @@ class Contact
     Q_PROPERTY(QString typeString READ typeString CONSTANT)
 
 public:
+    // Capacities of the inline fields, matching the device contact record
+    static constexpr int PublicKeySize = 32;
+    static constexpr int MaxPathSize = 64;
+    static constexpr int MaxNameSize = 32;  // UTF-8 bytes; longer names are cut at a character boundary
+
     Contact() = default;
-    Contact(const QByteArray &publicKey, AdvertType type, quint8 flags,
-            qint8 outPathLen, const QByteArray &outPath, const QString &name,
+    Contact(QByteArrayView publicKey, AdvertType type, quint8 flags,
+            qint8 outPathLen, QByteArrayView outPath, QStringView name,
             quint32 lastAdvert, qint32 latitude, qint32 longitude, quint32 lastModified);
 
-    [[nodiscard]] QByteArray publicKey() const { return m_publicKey; }
+    [[nodiscard]] QByteArray publicKey() const { return publicKeyView().toByteArray(); }
+    [[nodiscard]] QByteArrayView publicKeyView() const { return {m_publicKey.data(), m_publicKeySize}; }
     [[nodiscard]] QString publicKeyHex() const;
     [[nodiscard]] AdvertType type() const { return m_type; }
     [[nodiscard]] quint8 flags() const { return m_flags; }
     [[nodiscard]] qint8 outPathLen() const { return m_outPathLen; }
-    [[nodiscard]] QByteArray outPath() const { return m_outPath; }
-    [[nodiscard]] QString name() const { return m_name; }
+    [[nodiscard]] QByteArray outPath() const { return QByteArray(m_outPath.data(), m_outPathSize); }
+    [[nodiscard]] QString name() const { return QString::fromUtf8(m_name.data(), m_nameSize); }
     [[nodiscard]] quint32 lastAdvert() const { return m_lastAdvert; }
     [[nodiscard]] qint32 latitude() const { return m_latitude; }
     [[nodiscard]] qint32 longitude() const { return m_longitude; }
@@ -63,18 +79,27 @@ public:
     bool operator!=(const Contact &other) const { return !(*this == other); }
 
 private:
-    QByteArray m_publicKey;    // 32 bytes
+    std::array<char, PublicKeySize> m_publicKey{};
+    std::array<char, MaxPathSize> m_outPath{};
+    std::array<char, MaxNameSize> m_name{};  // UTF-8, not terminated
+    quint8 m_publicKeySize = 0;              // 0 for an empty contact
+    quint8 m_outPathSize = 0;
+    quint8 m_nameSize = 0;
     AdvertType m_type = AdvertType::None;
     quint8 m_flags = 0;
     qint8 m_outPathLen = 0;
-    QByteArray m_outPath;      // 64 bytes max
-    QString m_name;            // 32 chars max
     quint32 m_lastAdvert = 0;
     qint32 m_latitude = 0;
     qint32 m_longitude = 0;
     quint32 m_lastModified = 0;
 };
 
+static_assert(std::is_trivially_copyable_v<Contact>);
+
+// Serialization for the on-disk contact cache
+QDataStream &operator<<(QDataStream &out, const Contact &contact);
+QDataStream &operator>>(QDataStream &in, Contact &contact);
+
 } // namespace MeshCore
 
 Q_DECLARE_METATYPE(MeshCore::Contact)
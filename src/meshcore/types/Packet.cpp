@@ -1,6 +1,6 @@
 #include "Packet.h"
 #include "Advert.h"
-#include "../utils/BufferReader.h"
+#include "../utils/PacketView.h"
 
 namespace MeshCore {
 
@@ -13,14 +13,14 @@ Packet::Packet(quint8 header, const QByteArray &path, const QByteArray &payload)
 
 Packet Packet::fromBytes(const QByteArray &data)
 {
-    BufferReader reader(data);
-
-    quint8 header = reader.readByte();
-    qint8 pathLen = reader.readInt8();
-    QByteArray path = reader.readBytes(pathLen);
-    QByteArray payload = reader.readRemainingBytes();
+    PacketView view(data);
+    if (!view.isValid()) {
+        return Packet();
+    }
 
-    return Packet(header, path, payload);
+    Packet packet(view.header(), view.path().toByteArray(), view.payload().toByteArray());
+    packet.m_transportCodes = view.transportCodes();
+    return packet;
 }
 
 RouteType Packet::routeType() const
@@ -33,8 +33,8 @@ QString Packet::routeTypeString() const
     switch (routeType()) {
     case RouteType::Flood: return QStringLiteral("FLOOD");
     case RouteType::Direct: return QStringLiteral("DIRECT");
-    case RouteType::Reserved1: return QStringLiteral("RESERVED1");
-    case RouteType::Reserved2: return QStringLiteral("RESERVED2");
+    case RouteType::TransportFlood: return QStringLiteral("TRANSPORT_FLOOD");
+    case RouteType::TransportDirect: return QStringLiteral("TRANSPORT_DIRECT");
     default: return QStringLiteral("UNKNOWN");
     }
 }
@@ -57,6 +57,8 @@ QString Packet::payloadTypeString() const
     case PayloadType::AnonReq: return QStringLiteral("ANON_REQ");
     case PayloadType::Path: return QStringLiteral("PATH");
     case PayloadType::Trace: return QStringLiteral("TRACE");
+    case PayloadType::Multipart: return QStringLiteral("MULTIPART");
+    case PayloadType::Control: return QStringLiteral("CONTROL");
     case PayloadType::RawCustom: return QStringLiteral("RAW_CUSTOM");
     default: return QStringLiteral("UNKNOWN");
     }
@@ -75,4 +77,9 @@ Advert Packet::parseAdvertPayload() const
     return Advert::fromBytes(m_payload);
 }
 
+bool Packet::hasTransportCodes() const
+{
+    return routeType() == RouteType::TransportFlood || routeType() == RouteType::TransportDirect;
+}
+
 } // namespace MeshCore
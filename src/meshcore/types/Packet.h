@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QByteArray>
 #include <QtQml/qqmlregistration.h>
+#include <array>
 #include "../MeshCoreConstants.h"
 
 namespace MeshCore {
@@ -12,6 +13,8 @@ class Advert;
 
 /**
  * @brief Represents a raw MeshCore packet
+ *
+ * An owning copy of the parts of a packet; PacketView decodes them.
  */
 class Packet
 {
@@ -46,6 +49,8 @@ public:
     [[nodiscard]] bool isRouteFlood() const { return routeType() == RouteType::Flood; }
     [[nodiscard]] bool isRouteDirect() const { return routeType() == RouteType::Direct; }
     [[nodiscard]] bool isDoNotRetransmit() const { return m_header == 0xFF; }
+    [[nodiscard]] bool hasTransportCodes() const;
+    [[nodiscard]] std::array<quint16, 2> transportCodes() const { return m_transportCodes; }
 
     void markDoNotRetransmit() { m_header = 0xFF; }
 
@@ -56,6 +61,7 @@ public:
 
 private:
     quint8 m_header = 0;
+    std::array<quint16, 2> m_transportCodes{};
     QByteArray m_path;
     QByteArray m_payload;
 };
@@ -1,154 +1,133 @@
 #include "RxLogEntry.h"
+#include <chrono>
+
+#include "../utils/PacketView.h"
 
 namespace MeshCore {
 
-// Advert flags (from MeshCore protocol)
-static constexpr quint8 ADV_LATLON_MASK = 0x10;
-static constexpr quint8 ADV_BATTERY_MASK = 0x20;
-static constexpr quint8 ADV_TEMPERATURE_MASK = 0x40;
-static constexpr quint8 ADV_NAME_MASK = 0x80;
+namespace {
+
+qint64 steadyNowMs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
 
 RxLogEntry::RxLogEntry(double snr, qint8 rssi, const QByteArray &rawData)
-    : m_timestamp(QDateTime::currentDateTime())
+    : m_receivedAtMs(QDateTime::currentMSecsSinceEpoch())  // No time zone lookup, unlike currentDateTime()
+    , m_monotonicMs(steadyNowMs())
     , m_snr(snr)
     , m_rssi(rssi)
     , m_rawData(rawData)
 {
-    parsePacket();
 }
 
-void RxLogEntry::parsePacket()
+RxLogEntry::RxLogEntry(qint64 receivedAtMs, double snr, qint8 rssi, const QByteArray &rawData)
+    : m_receivedAtMs(receivedAtMs)
+    , m_monotonicMs(receivedAtMs)  // Only the recorded time is known; replayed entries share it
+    , m_snr(snr)
+    , m_rssi(rssi)
+    , m_rawData(rawData)
 {
-    if (m_rawData.isEmpty()) {
-        return;
-    }
-
-    // Parse header byte
-    quint8 header = static_cast<quint8>(m_rawData.at(0));
-    m_routeType = header & 0x03;           // Bits 0-1
-    m_payloadType = (header >> 2) & 0x0F;  // Bits 2-5
-    m_payloadVersion = (header >> 6) & 0x03; // Bits 6-7
-
-    // Determine offset based on route type (transport codes add 4 bytes)
-    int offset = 1;
-    bool hasTransportCodes = (m_routeType == RouteTransportFlood || m_routeType == RouteTransportDirect);
-    if (hasTransportCodes) {
-        offset += 4;  // Skip 2x 16-bit transport codes
-    }
-
-    // Parse path length if we have enough data
-    if (m_rawData.size() > offset) {
-        m_pathLength = static_cast<quint8>(m_rawData.at(offset));
-        // Hop count is path_length / 6 (each hop is 6 bytes: public key prefix)
-        m_hopCount = m_pathLength / 6;
-        offset += 1;  // Skip path_len byte
-    }
-
-    // Skip path bytes
-    offset += m_pathLength;
+}
 
-    // Extract payload
-    if (m_rawData.size() > offset) {
-        QByteArray payload = m_rawData.mid(offset);
-        parsePayload(payload);
+const RxLogEntry::ParsedPacket &RxLogEntry::parsed() const
+{
+    if (!m_parsed) {
+        m_parsed.emplace();
+        parsePacket(m_rawData, *m_parsed);
     }
+    return *m_parsed;
 }
 
-void RxLogEntry::parsePayload(const QByteArray &payload)
+void RxLogEntry::parsePacket(const QByteArray &rawData, ParsedPacket &packet)
 {
-    if (payload.isEmpty()) {
+    PacketView view(rawData);
+    if (!view.hasHeader()) {
         return;
     }
 
-    switch (m_payloadType) {
+    packet.routeType = static_cast<int>(view.routeType());
+    packet.payloadType = static_cast<int>(view.payloadType());
+    packet.payloadVersion = view.payloadVersion();
+    if (!view.isValid()) {
+        return;
+    }
+
+    packet.pathLength = static_cast<int>(view.path().size());
+    // Hop count is path_length / 6 (each hop is 6 bytes: public key prefix)
+    packet.hopCount = packet.pathLength / 6;
+    packet.packetHash = view.payloadHash();
+
+    switch (packet.payloadType) {
     case PayloadRequest:
     case PayloadResponse:
     case PayloadTextMsg:
-    case PayloadAck:
-    case PayloadGroupText:
-    case PayloadGroupData:
     case PayloadPath:
-        // These have dest/src hash prefix
-        if (payload.size() >= 2) {
-            m_destHash = static_cast<quint8>(payload.at(0));
-            m_srcHash = static_cast<quint8>(payload.at(1));
+        if (AddressedPayload addressed = view.addressed(); addressed.valid) {
+            packet.destHash = addressed.destHash;
+            packet.srcHash = addressed.srcHash;
         }
         break;
-        
-    case PayloadAdvert:
-        parseAdvert(payload);
+
+    case PayloadGroupText:
+    case PayloadGroupData:
+        // Addressed to a channel; its hash is shown as the destination
+        if (GroupPayload group = view.group(); group.valid) {
+            packet.destHash = group.channelHash;
+        }
         break;
-        
+
     case PayloadAnonRequest:
-        // Has dest hash and 32-byte ephemeral public key
-        if (payload.size() >= 1) {
-            m_destHash = static_cast<quint8>(payload.at(0));
+        if (AnonRequestPayload request = view.anonRequest(); request.valid) {
+            packet.destHash = request.destHash;
         }
         break;
-        
+
+    case PayloadAdvert:
+        if (AdvertPayload advert = view.advert(); advert.valid) {
+            const AdvertAppData &appData = advert.appData;
+            packet.advertType = static_cast<int>(appData.type());
+            if (appData.hasLatLon() && appData.valid) {
+                packet.latitude = appData.latitude / 1e6;
+                packet.longitude = appData.longitude / 1e6;
+                packet.hasLocation = true;
+            }
+            packet.advertName = QString::fromUtf8(appData.name);
+        }
+        break;
+
     default:
         break;
     }
 }
 
-void RxLogEntry::parseAdvert(const QByteArray &payload)
+QString RxLogEntry::timestampString() const
 {
-    // Advert structure:
-    // 32 bytes: public key
-    // 4 bytes: timestamp
-    // 64 bytes: signature
-    // rest: app_data (flags + optional fields)
-    
-    if (payload.size() < 100) {  // 32 + 4 + 64 = 100 minimum
-        return;
-    }
-
-    int offset = 32 + 4 + 64;  // Skip pub key, timestamp, signature
-    
-    if (payload.size() <= offset) {
-        return;
-    }
-
-    quint8 flags = static_cast<quint8>(payload.at(offset));
-    m_advertType = flags & 0x0F;
-    offset++;
-
-    // Parse lat/lon if present
-    if ((flags & ADV_LATLON_MASK) && payload.size() >= offset + 8) {
-        qint32 latRaw = static_cast<quint8>(payload.at(offset)) |
-                       (static_cast<quint8>(payload.at(offset + 1)) << 8) |
-                       (static_cast<quint8>(payload.at(offset + 2)) << 16) |
-                       (static_cast<quint8>(payload.at(offset + 3)) << 24);
-        qint32 lonRaw = static_cast<quint8>(payload.at(offset + 4)) |
-                       (static_cast<quint8>(payload.at(offset + 5)) << 8) |
-                       (static_cast<quint8>(payload.at(offset + 6)) << 16) |
-                       (static_cast<quint8>(payload.at(offset + 7)) << 24);
-        m_latitude = latRaw / 1e6;
-        m_longitude = lonRaw / 1e6;
-        m_hasLocation = true;
-        offset += 8;
+    if (m_timestampString.isEmpty()) {
+        m_timestampString = timestamp().toString(QStringLiteral("hh:mm:ss.zzz"));
     }
+    return m_timestampString;
+}
 
-    // Parse name if present (null-terminated string)
-    if ((flags & ADV_NAME_MASK) && payload.size() > offset) {
-        QByteArray nameBytes = payload.mid(offset);
-        int nullPos = nameBytes.indexOf('\0');
-        if (nullPos >= 0) {
-            m_advertName = QString::fromUtf8(nameBytes.left(nullPos));
-        } else {
-            m_advertName = QString::fromUtf8(nameBytes);
-        }
+QString RxLogEntry::rawDataHex() const
+{
+    if (m_rawDataHex.isEmpty() && !m_rawData.isEmpty()) {
+        m_rawDataHex = QString::fromLatin1(m_rawData.toHex(' ').toUpper());
     }
+    return m_rawDataHex;
 }
 
-QString RxLogEntry::rawDataHex() const
+QString RxLogEntry::pathHex() const
 {
-    return QString::fromLatin1(m_rawData.toHex(' ').toUpper());
+    return QString::fromLatin1(PacketView(m_rawData).path().toByteArray().toHex(' ').toUpper());
 }
 
 QString RxLogEntry::routeTypeName() const
 {
-    switch (m_routeType) {
+    switch (routeType()) {
     case RouteTransportFlood: return QStringLiteral("T-FLOOD");
     case RouteFlood: return QStringLiteral("FLOOD");
     case RouteDirect: return QStringLiteral("DIRECT");
@@ -159,7 +138,7 @@ QString RxLogEntry::routeTypeName() const
 
 QString RxLogEntry::payloadTypeName() const
 {
-    switch (m_payloadType) {
+    switch (payloadType()) {
     case PayloadRequest: return QStringLiteral("REQ");
     case PayloadResponse: return QStringLiteral("RESP");
     case PayloadTextMsg: return QStringLiteral("TEXT");
@@ -179,7 +158,7 @@ QString RxLogEntry::payloadTypeName() const
 
 QString RxLogEntry::advertTypeName() const
 {
-    switch (m_advertType) {
+    switch (advertType()) {
     case 0: return QStringLiteral("None");
     case 1: return QStringLiteral("Chat");
     case 2: return QStringLiteral("Repeater");
@@ -6,23 +6,32 @@
 #include <QString>
 #include <QDateTime>
 #include <QtQml/qqmlregistration.h>
+#include <optional>
 
 namespace MeshCore {
 
 /**
  * @brief Represents a received radio packet log entry
  * 
- * Parses MeshCore packet header to extract routing and payload information.
+ * Decodes the packet with PacketView to extract routing and payload information.
  * Header byte format:
  *   Bits 0-1 (0x03): Route Type
  *   Bits 2-5 (0x3C): Payload Type  
  *   Bits 6-7 (0xC0): Payload Version
+ *
+ * Constructing an entry only records the reception time, SNR, RSSI and raw
+ * bytes. The packet is parsed on the first access to a parsed field, and
+ * the hex dump and time string are formatted on first use; all three are
+ * then kept with the entry. These caches are not synchronised, so an
+ * entry must not be read from two threads at once.
  */
 class RxLogEntry
 {
     Q_GADGET
 
     Q_PROPERTY(QDateTime timestamp READ timestamp CONSTANT)
+    Q_PROPERTY(QString timestampString READ timestampString CONSTANT)
+    Q_PROPERTY(qint64 receivedAtMs READ receivedAtMs CONSTANT)
     Q_PROPERTY(double snr READ snr CONSTANT)
     Q_PROPERTY(int rssi READ rssi CONSTANT)
     Q_PROPERTY(QByteArray rawData READ rawData CONSTANT)
@@ -37,6 +46,9 @@ class RxLogEntry
     Q_PROPERTY(int payloadVersion READ payloadVersion CONSTANT)
     Q_PROPERTY(int hopCount READ hopCount CONSTANT)
     Q_PROPERTY(int pathLength READ pathLength CONSTANT)
+    Q_PROPERTY(QString pathHex READ pathHex CONSTANT)
+    Q_PROPERTY(quint64 packetHash READ packetHash CONSTANT)
+    Q_PROPERTY(int sighting READ sighting CONSTANT)
     
     // Payload-specific parsed fields
     Q_PROPERTY(int destHash READ destHash CONSTANT)
@@ -78,8 +90,16 @@ public:
 
     RxLogEntry() = default;
     RxLogEntry(double snr, qint8 rssi, const QByteArray &rawData);
+    // An entry received earlier, e.g. read back from a capture file
+    RxLogEntry(qint64 receivedAtMs, double snr, qint8 rssi, const QByteArray &rawData);
 
-    [[nodiscard]] QDateTime timestamp() const { return m_timestamp; }
+    // Reception time in local time; stored as UTC milliseconds since the epoch
+    [[nodiscard]] QDateTime timestamp() const { return QDateTime::fromMSecsSinceEpoch(m_receivedAtMs); }
+    [[nodiscard]] QString timestampString() const;  // "hh:mm:ss.zzz", local time
+    [[nodiscard]] qint64 receivedAtMs() const { return m_receivedAtMs; }
+    // Steady clock time at reception, in ms; unaffected by clock changes.
+    // Entries received earlier use receivedAtMs(), so only compare entries of one source.
+    [[nodiscard]] qint64 monotonicMs() const { return m_monotonicMs; }
     [[nodiscard]] double snr() const { return m_snr; }
     [[nodiscard]] int rssi() const { return m_rssi; }
     [[nodiscard]] QByteArray rawData() const { return m_rawData; }
@@ -87,49 +107,65 @@ public:
     [[nodiscard]] int dataLength() const { return m_rawData.size(); }
     
     // Parsed packet info
-    [[nodiscard]] int routeType() const { return m_routeType; }
+    [[nodiscard]] int routeType() const { return parsed().routeType; }
     [[nodiscard]] QString routeTypeName() const;
-    [[nodiscard]] int payloadType() const { return m_payloadType; }
+    [[nodiscard]] int payloadType() const { return parsed().payloadType; }
     [[nodiscard]] QString payloadTypeName() const;
-    [[nodiscard]] int payloadVersion() const { return m_payloadVersion; }
-    [[nodiscard]] int hopCount() const { return m_hopCount; }
-    [[nodiscard]] int pathLength() const { return m_pathLength; }
+    [[nodiscard]] int payloadVersion() const { return parsed().payloadVersion; }
+    [[nodiscard]] int hopCount() const { return parsed().hopCount; }
+    [[nodiscard]] int pathLength() const { return parsed().pathLength; }
+    [[nodiscard]] QString pathHex() const;
+    // Same for every repeat of a flooded packet; see PacketView::payloadHash()
+    [[nodiscard]] quint64 packetHash() const { return parsed().packetHash; }
+
+    // 0 for the first sighting of a packet, n for its n-th repeat; set by RxPacketGroupModel
+    [[nodiscard]] int sighting() const { return m_sighting; }
+    void setSighting(int sighting) { m_sighting = sighting; }
     
     // Payload-specific parsed fields
-    [[nodiscard]] int destHash() const { return m_destHash; }
-    [[nodiscard]] int srcHash() const { return m_srcHash; }
-    [[nodiscard]] QString advertName() const { return m_advertName; }
-    [[nodiscard]] int advertType() const { return m_advertType; }
+    [[nodiscard]] int destHash() const { return parsed().destHash; }
+    [[nodiscard]] int srcHash() const { return parsed().srcHash; }
+    [[nodiscard]] QString advertName() const { return parsed().advertName; }
+    [[nodiscard]] int advertType() const { return parsed().advertType; }
     [[nodiscard]] QString advertTypeName() const;
-    [[nodiscard]] bool hasLocation() const { return m_hasLocation; }
-    [[nodiscard]] double latitude() const { return m_latitude; }
-    [[nodiscard]] double longitude() const { return m_longitude; }
+    [[nodiscard]] bool hasLocation() const { return parsed().hasLocation; }
+    [[nodiscard]] double latitude() const { return parsed().latitude; }
+    [[nodiscard]] double longitude() const { return parsed().longitude; }
 
 private:
-    void parsePacket();
-    void parsePayload(const QByteArray &payload);
-    void parseAdvert(const QByteArray &payload);
+    struct ParsedPacket {
+        // Header fields
+        int routeType = -1;
+        int payloadType = -1;
+        int payloadVersion = 0;
+        int hopCount = 0;
+        int pathLength = 0;
+        quint64 packetHash = 0;
+
+        // Payload-specific fields
+        int destHash = -1;
+        int srcHash = -1;
+        QString advertName;
+        int advertType = 0;
+        bool hasLocation = false;
+        double latitude = 0.0;
+        double longitude = 0.0;
+    };
+
+    const ParsedPacket &parsed() const;
+    static void parsePacket(const QByteArray &rawData, ParsedPacket &packet);
 
-    QDateTime m_timestamp;
+    qint64 m_receivedAtMs = 0;
+    qint64 m_monotonicMs = 0;
     double m_snr = 0.0;
     qint8 m_rssi = 0;
     QByteArray m_rawData;
-    
-    // Parsed header fields
-    int m_routeType = -1;
-    int m_payloadType = -1;
-    int m_payloadVersion = 0;
-    int m_hopCount = 0;
-    int m_pathLength = 0;
-    
-    // Payload-specific fields
-    int m_destHash = -1;
-    int m_srcHash = -1;
-    QString m_advertName;
-    int m_advertType = 0;
-    bool m_hasLocation = false;
-    double m_latitude = 0.0;
-    double m_longitude = 0.0;
+    int m_sighting = 0;
+
+    // Filled on first use
+    mutable std::optional<ParsedPacket> m_parsed;
+    mutable QString m_rawDataHex;
+    mutable QString m_timestampString;
 };
 
 } // namespace MeshCore
@@ -21,7 +21,7 @@ TelemetryData::TelemetryData(const QByteArray &senderPublicKeyPrefix, const QLis
 {
 }
 
-TelemetryData TelemetryData::fromLppData(const QByteArray &pubKeyPrefix, const QByteArray &lppData)
+TelemetryData TelemetryData::fromLppData(const QByteArray &pubKeyPrefix, QByteArrayView lppData)
 {
     QList<TelemetryValue> values = CayenneLpp::parse(lppData);
     return TelemetryData(pubKeyPrefix, values);
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QVariant>
 #include <QVariantList>
 #include <QtQml/qqmlregistration.h>
@@ -51,7 +52,7 @@ public:
     TelemetryData() = default;
     TelemetryData(const QByteArray &senderPublicKeyPrefix, const QList<TelemetryValue> &values);
 
-    static TelemetryData fromLppData(const QByteArray &pubKeyPrefix, const QByteArray &lppData);
+    static TelemetryData fromLppData(const QByteArray &pubKeyPrefix, QByteArrayView lppData);
 
     [[nodiscard]] QByteArray senderPublicKeyPrefix() const { return m_senderPublicKeyPrefix; }
     [[nodiscard]] QString senderPublicKeyPrefixHex() const;
@@ -1,9 +1,13 @@
 #include "BufferReader.h"
 #include <QtEndian>
-#include <stdexcept>
 
 namespace MeshCore {
 
+BufferReader::BufferReader(QByteArrayView data)
+    : m_data(data)
+{
+}
+
 BufferReader::BufferReader(const QByteArray &data)
     : m_data(data)
 {
@@ -14,20 +18,29 @@ BufferReader::BufferReader(const char *data, qsizetype size)
 {
 }
 
+bool BufferReader::require(qsizetype count)
+{
+    if (m_status != Ok || count < 0 || remainingBytes() < count) {
+        m_status = ReadPastEnd;
+        return false;
+    }
+    return true;
+}
+
 void BufferReader::skip(qsizetype count)
 {
-    if (m_position + count > m_data.size()) {
-        throw std::out_of_range("BufferReader::skip: not enough bytes");
+    if (!require(count)) {
+        return;
     }
     m_position += count;
 }
 
 quint8 BufferReader::readByte()
 {
-    if (m_position >= m_data.size()) {
-        throw std::out_of_range("BufferReader::readByte: end of buffer");
+    if (!require(1)) {
+        return 0;
     }
-    return static_cast<quint8>(m_data.at(m_position++));
+    return static_cast<quint8>(m_data[m_position++]);
 }
 
 qint8 BufferReader::readInt8()
@@ -37,8 +50,8 @@ qint8 BufferReader::readInt8()
 
 qint16 BufferReader::readInt16LE()
 {
-    if (remainingBytes() < 2) {
-        throw std::out_of_range("BufferReader::readInt16LE: not enough bytes");
+    if (!require(2)) {
+        return 0;
     }
     qint16 value = qFromLittleEndian<qint16>(m_data.constData() + m_position);
     m_position += 2;
@@ -47,8 +60,8 @@ qint16 BufferReader::readInt16LE()
 
 quint16 BufferReader::readUInt16LE()
 {
-    if (remainingBytes() < 2) {
-        throw std::out_of_range("BufferReader::readUInt16LE: not enough bytes");
+    if (!require(2)) {
+        return 0;
     }
     quint16 value = qFromLittleEndian<quint16>(m_data.constData() + m_position);
     m_position += 2;
@@ -57,8 +70,8 @@ quint16 BufferReader::readUInt16LE()
 
 qint32 BufferReader::readInt32LE()
 {
-    if (remainingBytes() < 4) {
-        throw std::out_of_range("BufferReader::readInt32LE: not enough bytes");
+    if (!require(4)) {
+        return 0;
     }
     qint32 value = qFromLittleEndian<qint32>(m_data.constData() + m_position);
     m_position += 4;
@@ -67,8 +80,8 @@ qint32 BufferReader::readInt32LE()
 
 quint32 BufferReader::readUInt32LE()
 {
-    if (remainingBytes() < 4) {
-        throw std::out_of_range("BufferReader::readUInt32LE: not enough bytes");
+    if (!require(4)) {
+        return 0;
     }
     quint32 value = qFromLittleEndian<quint32>(m_data.constData() + m_position);
     m_position += 4;
@@ -77,8 +90,8 @@ quint32 BufferReader::readUInt32LE()
 
 qint16 BufferReader::readInt16BE()
 {
-    if (remainingBytes() < 2) {
-        throw std::out_of_range("BufferReader::readInt16BE: not enough bytes");
+    if (!require(2)) {
+        return 0;
     }
     qint16 value = qFromBigEndian<qint16>(m_data.constData() + m_position);
     m_position += 2;
@@ -87,8 +100,8 @@ qint16 BufferReader::readInt16BE()
 
 quint16 BufferReader::readUInt16BE()
 {
-    if (remainingBytes() < 2) {
-        throw std::out_of_range("BufferReader::readUInt16BE: not enough bytes");
+    if (!require(2)) {
+        return 0;
     }
     quint16 value = qFromBigEndian<quint16>(m_data.constData() + m_position);
     m_position += 2;
@@ -97,8 +110,8 @@ quint16 BufferReader::readUInt16BE()
 
 qint32 BufferReader::readInt32BE()
 {
-    if (remainingBytes() < 4) {
-        throw std::out_of_range("BufferReader::readInt32BE: not enough bytes");
+    if (!require(4)) {
+        return 0;
     }
     qint32 value = qFromBigEndian<qint32>(m_data.constData() + m_position);
     m_position += 4;
@@ -107,8 +120,8 @@ qint32 BufferReader::readInt32BE()
 
 quint32 BufferReader::readUInt32BE()
 {
-    if (remainingBytes() < 4) {
-        throw std::out_of_range("BufferReader::readUInt32BE: not enough bytes");
+    if (!require(4)) {
+        return 0;
     }
     quint32 value = qFromBigEndian<quint32>(m_data.constData() + m_position);
     m_position += 4;
@@ -117,14 +130,14 @@ quint32 BufferReader::readUInt32BE()
 
 qint32 BufferReader::readInt24BE()
 {
-    if (remainingBytes() < 3) {
-        throw std::out_of_range("BufferReader::readInt24BE: not enough bytes");
+    if (!require(3)) {
+        return 0;
     }
 
     // Read 24-bit big-endian value
-    qint32 value = (static_cast<quint8>(m_data.at(m_position)) << 16)
-                 | (static_cast<quint8>(m_data.at(m_position + 1)) << 8)
-                 | static_cast<quint8>(m_data.at(m_position + 2));
+    qint32 value = (static_cast<quint8>(m_data[m_position]) << 16)
+                 | (static_cast<quint8>(m_data[m_position + 1]) << 8)
+                 | static_cast<quint8>(m_data[m_position + 2]);
     m_position += 3;
 
     // Sign extend from 24-bit to 32-bit
@@ -138,27 +151,42 @@ qint32 BufferReader::readInt24BE()
 
 QByteArray BufferReader::readBytes(qsizetype count)
 {
-    if (remainingBytes() < count) {
-        throw std::out_of_range("BufferReader::readBytes: not enough bytes");
+    return readBytesView(count).toByteArray();
+}
+
+QByteArray BufferReader::readRemainingBytes()
+{
+    return readBytes(remainingBytes());
+}
+
+QByteArrayView BufferReader::readBytesView(qsizetype count)
+{
+    if (!require(count)) {
+        return {};
     }
-    QByteArray result = m_data.mid(m_position, count);
+    QByteArrayView result = m_data.sliced(m_position, count);
     m_position += count;
     return result;
 }
 
-QByteArray BufferReader::readRemainingBytes()
+QByteArrayView BufferReader::readRemainingBytesView()
 {
-    return readBytes(remainingBytes());
+    return readBytesView(remainingBytes());
 }
 
 QString BufferReader::readString()
 {
-    return QString::fromUtf8(readRemainingBytes());
+    return QString::fromUtf8(readRemainingBytesView());
 }
 
 QString BufferReader::readCString(qsizetype maxLength)
 {
-    QByteArray bytes = readBytes(maxLength);
+    return QString::fromUtf8(readCStringView(maxLength));
+}
+
+QByteArrayView BufferReader::readCStringView(qsizetype maxLength)
+{
+    QByteArrayView bytes = readBytesView(maxLength);
 
     // Find null terminator
     qsizetype nullPos = bytes.indexOf('\0');
@@ -166,7 +194,7 @@ QString BufferReader::readCString(qsizetype maxLength)
         bytes.truncate(nullPos);
     }
 
-    return QString::fromUtf8(bytes);
+    return bytes;
 }
 
 } // namespace MeshCore
@@ -2,6 +2,7 @@
 #define BUFFERREADER_H
 
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
 #include <cstdint>
 
@@ -10,21 +11,43 @@ namespace MeshCore {
 /**
  * @brief Utility class for reading binary data from a byte buffer
  *
- * Provides methods to read various data types from a QByteArray buffer,
+ * Provides methods to read various data types from a byte buffer,
  * maintaining an internal read position. All reads advance the position.
+ *
+ * The reader does not copy its input: it keeps a view of the buffer it was
+ * constructed from, so that buffer must outlive the reader. The *View()
+ * methods return non-owning views into the same buffer; use them for fields
+ * that are only inspected or parsed further, and the QByteArray/QString
+ * variants only for values that are actually stored.
+ *
+ * Reads never throw. Like QDataStream, a read past the end of the buffer
+ * puts the reader into the ReadPastEnd state and returns a zero/empty
+ * value without advancing; once in that state all further reads fail too.
+ * Decoders read all fields and check status() once before using them.
  */
 class BufferReader
 {
 public:
+    enum Status {
+        Ok,
+        ReadPastEnd
+    };
+
+    explicit BufferReader(QByteArrayView data);
     explicit BufferReader(const QByteArray &data);
     explicit BufferReader(const char *data, qsizetype size);
+    BufferReader(QByteArray &&) = delete;  // Would leave the view dangling
 
     // Position management
     [[nodiscard]] qsizetype position() const { return m_position; }
     [[nodiscard]] qsizetype remainingBytes() const { return m_data.size() - m_position; }
     [[nodiscard]] bool hasRemaining() const { return remainingBytes() > 0; }
     void skip(qsizetype count);
-    void reset() { m_position = 0; }
+    void reset() { m_position = 0; m_status = Ok; }
+
+    // Error state
+    [[nodiscard]] Status status() const { return m_status; }
+    [[nodiscard]] bool hasError() const { return m_status != Ok; }
 
     // Single byte reads
     [[nodiscard]] quint8 readByte();
@@ -46,20 +69,29 @@ public:
     // Special reads
     [[nodiscard]] qint32 readInt24BE(); // 24-bit signed big-endian
 
-    // Byte array reads
+    // Byte array reads (owning copies)
     [[nodiscard]] QByteArray readBytes(qsizetype count);
     [[nodiscard]] QByteArray readRemainingBytes();
 
+    // Byte array reads (non-owning views into the underlying buffer)
+    [[nodiscard]] QByteArrayView readBytesView(qsizetype count);
+    [[nodiscard]] QByteArrayView readRemainingBytesView();
+
     // String reads
     [[nodiscard]] QString readString();           // Reads remaining bytes as UTF-8
     [[nodiscard]] QString readCString(qsizetype maxLength); // Reads null-terminated string
+    [[nodiscard]] QByteArrayView readCStringView(qsizetype maxLength); // Raw bytes up to the terminator
 
     // Raw data access
-    [[nodiscard]] const QByteArray &data() const { return m_data; }
+    [[nodiscard]] QByteArrayView data() const { return m_data; }
 
 private:
-    QByteArray m_data;
+    // Returns true if count more bytes can be read, otherwise enters ReadPastEnd
+    bool require(qsizetype count);
+
+    QByteArrayView m_data;
     qsizetype m_position = 0;
+    Status m_status = Ok;
 };
 
 } // namespace MeshCore
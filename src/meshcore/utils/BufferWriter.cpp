@@ -1,104 +1,204 @@
 #include "BufferWriter.h"
+#include <QStringEncoder>
 #include <QtEndian>
+#include <cstring>
+#include <utility>
 
 namespace MeshCore {
 
+namespace {
+
+bool isSurrogatePair(QStringView str, qsizetype i)
+{
+    return str[i].isHighSurrogate() && i + 1 < str.size() && str[i + 1].isLowSurrogate();
+}
+
+// UTF-8 bytes for the character at str[i]. A lone surrogate is encoded as
+// U+FFFD, which also takes 3 bytes.
+qsizetype utf8Size(QStringView str, qsizetype i)
+{
+    const char16_t c = str[i].unicode();
+    if (c < 0x80) {
+        return 1;
+    }
+    if (c < 0x800) {
+        return 2;
+    }
+    return isSurrogatePair(str, i) ? 4 : 3;
+}
+
+// UTF-16 code units taken by the character at str[i]
+qsizetype utf16Units(QStringView str, qsizetype i)
+{
+    return isSurrogatePair(str, i) ? 2 : 1;
+}
+
+} // namespace
+
 BufferWriter::BufferWriter(qsizetype reserveSize)
 {
-    m_buffer.reserve(reserveSize);
+    if (reserveSize > InlineCapacity) {
+        m_heap.reserve(reserveSize);
+        m_onHeap = true;
+    }
+}
+
+QByteArrayView BufferWriter::view() const
+{
+    if (m_onHeap) {
+        return m_heap;
+    }
+    return QByteArrayView(m_inline.data(), m_inlineSize);
+}
+
+QByteArray BufferWriter::take()
+{
+    QByteArray result = m_onHeap ? std::exchange(m_heap, QByteArray())
+                                 : QByteArray(m_inline.data(), m_inlineSize);
+    clear();
+    return result;
+}
+
+void BufferWriter::clear()
+{
+    m_heap.clear();
+    m_inlineSize = 0;
+    m_onHeap = false;
+}
+
+char *BufferWriter::grow(qsizetype count)
+{
+    if (!m_onHeap) {
+        if (m_inlineSize + count <= InlineCapacity) {
+            char *end = m_inline.data() + m_inlineSize;
+            m_inlineSize += count;
+            return end;
+        }
+
+        // Spill to the heap, with room to keep growing
+        m_heap.reserve(qMax(2 * InlineCapacity, m_inlineSize + count));
+        m_heap.append(m_inline.data(), m_inlineSize);
+        m_onHeap = true;
+    }
+
+    qsizetype start = m_heap.size();
+    m_heap.resize(start + count);
+    return m_heap.data() + start;
+}
+
+void BufferWriter::truncate(qsizetype size)
+{
+    if (m_onHeap) {
+        m_heap.truncate(size);
+    } else {
+        m_inlineSize = qMin(m_inlineSize, size);
+    }
 }
 
 void BufferWriter::writeByte(quint8 value)
 {
-    m_buffer.append(static_cast<char>(value));
+    *grow(1) = static_cast<char>(value);
 }
 
 void BufferWriter::writeInt16LE(qint16 value)
 {
-    char bytes[2];
-    qToLittleEndian(value, bytes);
-    m_buffer.append(bytes, 2);
+    qToLittleEndian(value, grow(2));
 }
 
 void BufferWriter::writeUInt16LE(quint16 value)
 {
-    char bytes[2];
-    qToLittleEndian(value, bytes);
-    m_buffer.append(bytes, 2);
+    qToLittleEndian(value, grow(2));
 }
 
 void BufferWriter::writeInt32LE(qint32 value)
 {
-    char bytes[4];
-    qToLittleEndian(value, bytes);
-    m_buffer.append(bytes, 4);
+    qToLittleEndian(value, grow(4));
 }
 
 void BufferWriter::writeUInt32LE(quint32 value)
 {
-    char bytes[4];
-    qToLittleEndian(value, bytes);
-    m_buffer.append(bytes, 4);
+    qToLittleEndian(value, grow(4));
 }
 
 void BufferWriter::writeInt16BE(qint16 value)
 {
-    char bytes[2];
-    qToBigEndian(value, bytes);
-    m_buffer.append(bytes, 2);
+    qToBigEndian(value, grow(2));
 }
 
 void BufferWriter::writeUInt16BE(quint16 value)
 {
-    char bytes[2];
-    qToBigEndian(value, bytes);
-    m_buffer.append(bytes, 2);
+    qToBigEndian(value, grow(2));
 }
 
 void BufferWriter::writeInt32BE(qint32 value)
 {
-    char bytes[4];
-    qToBigEndian(value, bytes);
-    m_buffer.append(bytes, 4);
+    qToBigEndian(value, grow(4));
 }
 
 void BufferWriter::writeUInt32BE(quint32 value)
 {
-    char bytes[4];
-    qToBigEndian(value, bytes);
-    m_buffer.append(bytes, 4);
+    qToBigEndian(value, grow(4));
 }
 
 void BufferWriter::writeBytes(const QByteArray &data)
 {
-    m_buffer.append(data);
+    writeBytes(data.constData(), data.size());
 }
 
 void BufferWriter::writeBytes(const char *data, qsizetype size)
 {
-    m_buffer.append(data, size);
+    if (size > 0) {
+        std::memcpy(grow(size), data, size);
+    }
+}
+
+void BufferWriter::writeZeros(qsizetype count)
+{
+    if (count > 0) {
+        std::memset(grow(count), 0, count);
+    }
+}
+
+qsizetype BufferWriter::utf8Length(QStringView str)
+{
+    qsizetype length = 0;
+    for (qsizetype i = 0; i < str.size(); i += utf16Units(str, i)) {
+        length += utf8Size(str, i);
+    }
+    return length;
 }
 
 void BufferWriter::writeString(const QString &str)
 {
-    m_buffer.append(str.toUtf8());
+    // Encode straight into the buffer rather than through a temporary QByteArray.
+    // Growing by the exact length rather than the 3x worst case keeps long
+    // texts in the inline buffer.
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    qsizetype start = size();
+    char *field = grow(utf8Length(str));
+    char *end = encoder.appendToBuffer(field, str);
+    truncate(start + (end - field));
 }
 
 void BufferWriter::writeCString(const QString &str, qsizetype maxLength)
 {
-    QByteArray utf8 = str.toUtf8();
-
-    // Create fixed-size buffer
-    QByteArray buffer(maxLength, '\0');
+    if (maxLength <= 0) {
+        return;
+    }
 
-    // Copy string bytes (leaving room for null terminator)
-    qsizetype copyLen = qMin(utf8.size(), maxLength - 1);
-    for (qsizetype i = 0; i < copyLen; ++i) {
-        buffer[i] = utf8.at(i);
+    // Whole characters that fit before the null terminator
+    qsizetype units = 0;
+    qsizetype length = 0;
+    while (units < str.size() && length + utf8Size(str, units) <= maxLength - 1) {
+        length += utf8Size(str, units);
+        units += utf16Units(str, units);
     }
 
-    // Last byte is always null (already set)
-    m_buffer.append(buffer);
+    // Encode them in place, pad the rest with nulls
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    char *field = grow(maxLength);
+    encoder.appendToBuffer(field, QStringView(str).first(units));
+    std::memset(field + length, 0, maxLength - length);
 }
 
 } // namespace MeshCore
@@ -2,7 +2,9 @@
 #define BUFFERWRITER_H
 
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
+#include <array>
 #include <cstdint>
 
 namespace MeshCore {
@@ -10,22 +12,35 @@ namespace MeshCore {
 /**
  * @brief Utility class for writing binary data to a byte buffer
  *
- * Provides methods to write various data types to a QByteArray buffer.
+ * Provides methods to write various data types to a byte buffer.
  * Data is appended sequentially.
+ *
+ * Up to InlineCapacity bytes are kept in storage inside the writer, so
+ * building a command frame or a storage record allocates nothing. Larger
+ * contents, or a reserve size above InlineCapacity, move to a heap
+ * QByteArray. Finish with view() when the bytes are only passed on, or with
+ * take() when a QByteArray must be kept: that costs the one allocation of
+ * the result, or none when the contents are already on the heap.
  */
 class BufferWriter
 {
 public:
+    static constexpr qsizetype InlineCapacity = 256;
+
     BufferWriter() = default;
     explicit BufferWriter(qsizetype reserveSize);
+    BufferWriter(const BufferWriter &) = delete;
+    BufferWriter &operator=(const BufferWriter &) = delete;
 
     // Get the accumulated data
-    [[nodiscard]] QByteArray toByteArray() const { return m_buffer; }
-    [[nodiscard]] const QByteArray &data() const { return m_buffer; }
-    [[nodiscard]] qsizetype size() const { return m_buffer.size(); }
+    [[nodiscard]] QByteArrayView view() const;   // Valid until the next write
+    [[nodiscard]] QByteArray toByteArray() const { return view().toByteArray(); }
+    [[nodiscard]] QByteArray take();             // Leaves the writer empty
+    [[nodiscard]] qsizetype size() const { return m_onHeap ? m_heap.size() : m_inlineSize; }
+    [[nodiscard]] bool isInline() const { return !m_onHeap; }
 
     // Clear the buffer
-    void clear() { m_buffer.clear(); }
+    void clear();
 
     // Single byte writes
     void writeByte(quint8 value);
@@ -47,13 +62,24 @@ public:
     // Byte array writes
     void writeBytes(const QByteArray &data);
     void writeBytes(const char *data, qsizetype size);
+    void writeZeros(qsizetype count);
 
     // String writes
     void writeString(const QString &str);                       // Write as UTF-8 bytes
     void writeCString(const QString &str, qsizetype maxLength); // Write null-terminated with fixed length
 
+    // Bytes writeString() will append for str
+    [[nodiscard]] static qsizetype utf8Length(QStringView str);
+
 private:
-    QByteArray m_buffer;
+    // Appends count uninitialised bytes and returns a pointer to them
+    char *grow(qsizetype count);
+    void truncate(qsizetype size);
+
+    std::array<char, InlineCapacity> m_inline;
+    qsizetype m_inlineSize = 0;
+    QByteArray m_heap;
+    bool m_onHeap = false;
 };
 
 } // namespace MeshCore
@@ -2,6 +2,7 @@
 #define CAYENNELPP_H
 
 #include <QByteArray>
+#include <QByteArrayView>
 #include <QList>
 #include <QString>
 #include "../types/TelemetryData.h"
@@ -50,7 +51,7 @@ public:
     /**
      * @brief Parse CayenneLPP formatted bytes into telemetry values
      */
-    static QList<TelemetryValue> parse(const QByteArray &data);
+    static QList<TelemetryValue> parse(QByteArrayView data);
 
     /**
      * @brief Get human-readable name for LPP type
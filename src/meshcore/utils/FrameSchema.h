@@ -0,0 +1,313 @@
+#ifndef FRAMESCHEMA_H
+#define FRAMESCHEMA_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QtEndian>
+#include <tuple>
+#include <type_traits>
+
+#include "BufferReader.h"
+#include "BufferWriter.h"
+
+namespace MeshCore {
+namespace Schema {
+
+/**
+ * @brief Building blocks for declaring companion protocol frame layouts
+ *
+ * A layout is a list of field types. Each field knows its encoded size and
+ * how to write and read itself, so encoders and decoders for a layout are
+ * generated from that one declaration:
+ *
+ * @code
+ * using SentResponse = Layout<Int8, UInt32, UInt32>;
+ * auto [result, ackCrc, timeout] = SentResponse::decode(reader);
+ *
+ * using SetTxPower = Frame<CommandCode::SetTxPower, UInt8>;
+ * sendToRadioFrame(SetTxPower::encode(txPower));
+ * @endcode
+ *
+ * Fields without a value (Reserved) are skipped on decode and zero-filled on
+ * encode; they take no argument and produce no tuple element. Decoding never
+ * throws: check the reader's status after decode() before using the values.
+ */
+
+// Little-endian integer of type T; enums are stored as their underlying type
+template <typename T>
+struct Integer
+{
+    static_assert(std::is_integral_v<T> || std::is_enum_v<T>);
+    using Storage = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>,
+                                                std::type_identity<T>>::type;
+
+    static constexpr bool hasValue = true;
+    static constexpr bool isVariable = false;
+    static constexpr qsizetype fixedSize = sizeof(Storage);
+
+    template <typename V>
+    static constexpr qsizetype capacity(const V &) { return fixedSize; }
+
+    template <typename V>
+    static void write(BufferWriter &writer, V value)
+    {
+        char bytes[sizeof(Storage)];
+        qToLittleEndian(static_cast<Storage>(value), bytes);
+        writer.writeBytes(bytes, sizeof(Storage));
+    }
+
+    static T read(BufferReader &reader)
+    {
+        QByteArrayView bytes = reader.readBytesView(fixedSize);
+        return reader.hasError() ? T{} : static_cast<T>(qFromLittleEndian<Storage>(bytes.data()));
+    }
+};
+
+using UInt8 = Integer<quint8>;
+using Int8 = Integer<qint8>;
+using UInt16 = Integer<quint16>;
+using Int16 = Integer<qint16>;
+using UInt32 = Integer<quint32>;
+using Int32 = Integer<qint32>;
+using UInt64 = Integer<quint64>;
+using Int64 = Integer<qint64>;
+
+template <typename E>
+using Enum = Integer<E>;
+
+// Fixed-length byte field; shorter input is zero-padded, longer is truncated.
+// Keys and secrets must not be reshaped that way: check their length first.
+template <qsizetype N>
+struct Bytes
+{
+    static constexpr bool hasValue = true;
+    static constexpr bool isVariable = false;
+    static constexpr qsizetype fixedSize = N;
+
+    static constexpr qsizetype capacity(QByteArrayView) { return fixedSize; }
+
+    static void write(BufferWriter &writer, QByteArrayView value)
+    {
+        qsizetype length = qMin(value.size(), N);
+        writer.writeBytes(value.data(), length);
+        writer.writeZeros(N - length);
+    }
+
+    static QByteArrayView read(BufferReader &reader) { return reader.readBytesView(N); }
+};
+
+// Fixed-length, null-padded UTF-8 string field
+template <qsizetype N>
+struct CString
+{
+    static constexpr bool hasValue = true;
+    static constexpr bool isVariable = false;
+    static constexpr qsizetype fixedSize = N;
+
+    // Only the characters that fit are encoded
+    static qsizetype capacity(const QString &) { return N; }
+
+    static void write(BufferWriter &writer, const QString &value) { writer.writeCString(value, N); }
+
+    static QString read(BufferReader &reader) { return reader.readCString(N); }
+};
+
+// Reserved bytes: written as zeros, skipped when reading
+template <qsizetype N>
+struct Reserved
+{
+    static constexpr bool hasValue = false;
+    static constexpr bool isVariable = false;
+    static constexpr qsizetype fixedSize = N;
+
+    static constexpr qsizetype capacity() { return fixedSize; }
+
+    static void write(BufferWriter &writer) { writer.writeZeros(N); }
+
+    static void read(BufferReader &reader) { reader.skip(N); }
+};
+
+// All remaining bytes of the frame
+struct Tail
+{
+    static constexpr bool hasValue = true;
+    static constexpr bool isVariable = true;
+    static constexpr qsizetype fixedSize = 0;
+
+    static qsizetype capacity(QByteArrayView value) { return value.size(); }
+
+    static void write(BufferWriter &writer, QByteArrayView value)
+    {
+        writer.writeBytes(value.data(), value.size());
+    }
+
+    static QByteArrayView read(BufferReader &reader) { return reader.readRemainingBytesView(); }
+};
+
+// All remaining bytes of the frame, as UTF-8 text
+struct Utf8Tail
+{
+    static constexpr bool hasValue = true;
+    static constexpr bool isVariable = true;
+    static constexpr qsizetype fixedSize = 0;
+
+    // The exact encoded length, so a long text does not push the frame past
+    // the writer's inline buffer
+    static qsizetype capacity(const QString &value) { return BufferWriter::utf8Length(value); }
+
+    static void write(BufferWriter &writer, const QString &value) { writer.writeString(value); }
+
+    static QString read(BufferReader &reader) { return reader.readString(); }
+};
+
+// Byte string preceded by its length as a single byte
+struct UInt8Prefixed
+{
+    static constexpr bool hasValue = true;
+    static constexpr bool isVariable = true;
+    static constexpr qsizetype fixedSize = 1;
+
+    static qsizetype capacity(QByteArrayView value) { return fixedSize + value.size(); }
+
+    static void write(BufferWriter &writer, QByteArrayView value)
+    {
+        qsizetype length = qMin<qsizetype>(value.size(), 0xFF);
+        writer.writeByte(static_cast<quint8>(length));
+        writer.writeBytes(value.data(), length);
+    }
+
+    static QByteArrayView read(BufferReader &reader)
+    {
+        quint8 length = reader.readByte();
+        return reader.readBytesView(length);
+    }
+};
+
+namespace Detail {
+
+// Walks a field list, consuming one argument per field that has a value
+template <typename... Fields>
+struct FieldList;
+
+template <>
+struct FieldList<>
+{
+    static constexpr qsizetype capacity() { return 0; }
+    static void write(BufferWriter &) {}
+};
+
+template <typename Field, typename... Rest>
+struct FieldList<Field, Rest...>
+{
+    template <typename... Args>
+    static qsizetype capacity(const Args &...args)
+    {
+        if constexpr (Field::hasValue) {
+            return capacityWithValue(args...);
+        } else {
+            return Field::capacity() + FieldList<Rest...>::capacity(args...);
+        }
+    }
+
+    template <typename... Args>
+    static void write(BufferWriter &writer, const Args &...args)
+    {
+        if constexpr (Field::hasValue) {
+            writeWithValue(writer, args...);
+        } else {
+            Field::write(writer);
+            FieldList<Rest...>::write(writer, args...);
+        }
+    }
+
+private:
+    template <typename Arg, typename... Args>
+    static qsizetype capacityWithValue(const Arg &arg, const Args &...args)
+    {
+        return Field::capacity(arg) + FieldList<Rest...>::capacity(args...);
+    }
+
+    template <typename Arg, typename... Args>
+    static void writeWithValue(BufferWriter &writer, const Arg &arg, const Args &...args)
+    {
+        Field::write(writer, arg);
+        FieldList<Rest...>::write(writer, args...);
+    }
+};
+
+template <typename Field>
+auto readField(BufferReader &reader)
+{
+    if constexpr (Field::hasValue) {
+        return std::tuple<decltype(Field::read(reader))>(Field::read(reader));
+    } else {
+        Field::read(reader);
+        return std::tuple<>();
+    }
+}
+
+} // namespace Detail
+
+/**
+ * @brief A frame body described by its field list
+ */
+template <typename... Fields>
+struct Layout
+{
+    // Encoded size of the fixed part; exact when isFixedSize is true
+    static constexpr qsizetype fixedSize = (qsizetype(0) + ... + Fields::fixedSize);
+    static constexpr bool isFixedSize = (!Fields::isVariable && ...);
+    static constexpr qsizetype valueCount = (qsizetype(0) + ... + (Fields::hasValue ? 1 : 0));
+
+    // Bytes needed to encode the given values
+    template <typename... Args>
+    static qsizetype capacity(const Args &...args)
+    {
+        return Detail::FieldList<Fields...>::capacity(args...);
+    }
+
+    template <typename... Args>
+    static void write(BufferWriter &writer, const Args &...args)
+    {
+        static_assert(sizeof...(Args) == valueCount, "Argument count does not match the layout");
+        Detail::FieldList<Fields...>::write(writer, args...);
+    }
+
+    // Reads all fields in order, returning a tuple of the valued ones
+    static auto decode(BufferReader &reader)
+    {
+        // Braced initialisation guarantees left-to-right evaluation
+        auto parts = std::tuple<decltype(Detail::readField<Fields>(reader))...>{
+            Detail::readField<Fields>(reader)...};
+        return std::apply([](auto &&...part) { return std::tuple_cat(std::move(part)...); },
+                          std::move(parts));
+    }
+};
+
+/**
+ * @brief A complete frame: a leading code byte followed by a layout
+ *
+ * encode() reserves the full frame up front, so building a command costs
+ * one allocation and the result is moved out of the writer.
+ */
+template <auto Code, typename... Fields>
+struct Frame : Layout<Fields...>
+{
+    static constexpr quint8 code = static_cast<quint8>(Code);
+    static constexpr qsizetype fixedSize = 1 + Layout<Fields...>::fixedSize;
+
+    template <typename... Args>
+    static QByteArray encode(const Args &...args)
+    {
+        BufferWriter writer(1 + Layout<Fields...>::capacity(args...));
+        writer.writeByte(code);
+        Layout<Fields...>::write(writer, args...);
+        return writer.take();
+    }
+};
+
+} // namespace Schema
+} // namespace MeshCore
+
+#endif // FRAMESCHEMA_H
@@ -0,0 +1,63 @@
+#include "PacketIdentityTable.h"
+
+namespace MeshCore {
+
+PacketIdentityTable::PacketIdentityTable(qsizetype capacity, qint64 windowMs)
+    : m_capacity(qMax(capacity, qsizetype(1)))
+    , m_windowMs(windowMs)
+{
+    m_ids.reserve(m_capacity);
+}
+
+qint64 PacketIdentityTable::find(quint64 hash, qint64 nowMs)
+{
+    expire(nowMs);
+    return m_ids.value(hash, -1);
+}
+
+void PacketIdentityTable::insert(quint64 hash, qint64 id, qint64 nowMs)
+{
+    expire(nowMs);
+    if (m_count == m_capacity) {
+        evictOldest();
+    }
+
+    qsizetype slot = (m_head + m_count) % m_capacity;
+    if (slot == m_slots.size()) {
+        m_slots.append({hash, id, nowMs});
+    } else {
+        m_slots[slot] = {hash, id, nowMs};
+    }
+    ++m_count;
+    m_ids.insert(hash, id);
+}
+
+void PacketIdentityTable::clear()
+{
+    m_ids.clear();
+    m_slots.clear();
+    m_head = 0;
+    m_count = 0;
+}
+
+void PacketIdentityTable::expire(qint64 nowMs)
+{
+    while (m_count > 0 && nowMs - m_slots.at(m_head).firstSeenMs > m_windowMs) {
+        evictOldest();
+    }
+}
+
+void PacketIdentityTable::evictOldest()
+{
+    const Slot &oldest = m_slots.at(m_head);
+
+    // A hash inserted again since points to its newer slot
+    auto it = m_ids.find(oldest.hash);
+    if (it != m_ids.end() && it.value() == oldest.id) {
+        m_ids.erase(it);
+    }
+    m_head = (m_head + 1) % m_capacity;
+    --m_count;
+}
+
+} // namespace MeshCore
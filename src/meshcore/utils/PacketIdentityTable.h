@@ -0,0 +1,55 @@
+#ifndef PACKETIDENTITYTABLE_H
+#define PACKETIDENTITYTABLE_H
+
+#include <QHash>
+#include <QList>
+
+namespace MeshCore {
+
+/**
+ * @brief Bounded, time-windowed table of recently seen packet hashes
+ *
+ * Maps the payload hash of a packet (see PacketView::payloadHash()) to an
+ * id chosen by the caller at its first sighting, so repeats of a flooded
+ * packet arriving over other paths can be recognised. Hashes are kept in
+ * order of first sighting, in a ring of capacity slots: a hash is
+ * forgotten once windowMs has passed since its first sighting or when the
+ * ring is full and its slot is needed. Lookups and inserts are O(1).
+ */
+class PacketIdentityTable
+{
+public:
+    static constexpr qsizetype DefaultCapacity = 4096;
+    static constexpr qint64 DefaultWindowMs = 60 * 1000;
+
+    explicit PacketIdentityTable(qsizetype capacity = DefaultCapacity, qint64 windowMs = DefaultWindowMs);
+
+    // Id recorded for the hash within the window, or -1
+    [[nodiscard]] qint64 find(quint64 hash, qint64 nowMs);
+    // Records the hash, replacing any id it had
+    void insert(quint64 hash, qint64 id, qint64 nowMs);
+    void clear();
+
+    [[nodiscard]] qsizetype size() const { return m_ids.size(); }
+
+private:
+    struct Slot {
+        quint64 hash = 0;
+        qint64 id = -1;
+        qint64 firstSeenMs = 0;
+    };
+
+    void expire(qint64 nowMs);
+    void evictOldest();
+
+    qsizetype m_capacity;
+    qint64 m_windowMs;
+    QHash<quint64, qint64> m_ids;   // Hash -> id
+    QList<Slot> m_slots;            // Ring, oldest first from m_head
+    qsizetype m_head = 0;
+    qsizetype m_count = 0;
+};
+
+} // namespace MeshCore
+
+#endif // PACKETIDENTITYTABLE_H
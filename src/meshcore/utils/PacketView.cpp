@@ -0,0 +1,236 @@
+#include "PacketView.h"
+#include "BufferReader.h"
+#include "FrameSchema.h"
+#include <QHashFunctions>
+
+namespace MeshCore {
+
+namespace {
+
+using namespace Schema;
+
+// public key, timestamp, signature, app data
+using AdvertLayout = Layout<Bytes<32>, UInt32, Bytes<64>, Tail>;
+
+// dest hash, src hash, MAC and ciphertext
+using AddressedLayout = Layout<UInt8, UInt8, Tail>;
+
+// dest hash, ephemeral public key, MAC and ciphertext
+using AnonRequestLayout = Layout<UInt8, Bytes<32>, Tail>;
+
+// channel hash, MAC and ciphertext
+using GroupLayout = Layout<UInt8, Tail>;
+
+// message checksum
+using AckLayout = Layout<UInt32>;
+
+// tag, auth code, flags, path hashes
+using TraceLayout = Layout<UInt32, UInt32, UInt8, Tail>;
+
+} // namespace
+
+AdvertAppData AdvertAppData::decode(QByteArrayView appData)
+{
+    AdvertAppData result;
+    BufferReader reader(appData);
+
+    result.flags = reader.readByte();
+    if (result.flags & AdvertFlags::LatLonMask) {
+        result.latitude = reader.readInt32LE();
+        result.longitude = reader.readInt32LE();
+    }
+
+    // Two optional 16-bit feature fields come before the name
+    if (result.flags & AdvertFlags::BatteryMask) {
+        reader.skip(2);
+    }
+    if (result.flags & AdvertFlags::TemperatureMask) {
+        reader.skip(2);
+    }
+    if (result.flags & AdvertFlags::NameMask) {
+        result.name = reader.readCStringView(reader.remainingBytes());
+    }
+
+    result.valid = !reader.hasError();
+    return result;
+}
+
+AdvertPayload AdvertPayload::decode(QByteArrayView payload)
+{
+    AdvertPayload result;
+    BufferReader reader(payload);
+    auto [publicKey, timestamp, signature, appData] = AdvertLayout::decode(reader);
+    if (reader.hasError()) {
+        return result;
+    }
+
+    result.publicKey = publicKey;
+    result.timestamp = timestamp;
+    result.signature = signature;
+    result.rawAppData = appData;
+    result.appData = AdvertAppData::decode(appData);
+    result.valid = true;
+    return result;
+}
+
+AddressedPayload AddressedPayload::decode(QByteArrayView payload)
+{
+    AddressedPayload result;
+    BufferReader reader(payload);
+    auto [destHash, srcHash, encrypted] = AddressedLayout::decode(reader);
+    if (!reader.hasError()) {
+        result = {true, destHash, srcHash, encrypted};
+    }
+    return result;
+}
+
+AnonRequestPayload AnonRequestPayload::decode(QByteArrayView payload)
+{
+    AnonRequestPayload result;
+    BufferReader reader(payload);
+    auto [destHash, senderPublicKey, encrypted] = AnonRequestLayout::decode(reader);
+    if (!reader.hasError()) {
+        result = {true, destHash, senderPublicKey, encrypted};
+    }
+    return result;
+}
+
+GroupPayload GroupPayload::decode(QByteArrayView payload)
+{
+    GroupPayload result;
+    BufferReader reader(payload);
+    auto [channelHash, encrypted] = GroupLayout::decode(reader);
+    if (!reader.hasError()) {
+        result = {true, channelHash, encrypted};
+    }
+    return result;
+}
+
+AckPayload AckPayload::decode(QByteArrayView payload)
+{
+    AckPayload result;
+    BufferReader reader(payload);
+    auto [checksum] = AckLayout::decode(reader);
+    if (!reader.hasError()) {
+        result = {true, checksum};
+    }
+    return result;
+}
+
+TracePayload TracePayload::decode(QByteArrayView payload)
+{
+    TracePayload result;
+    BufferReader reader(payload);
+    auto [tag, authCode, flags, pathHashes] = TraceLayout::decode(reader);
+    if (!reader.hasError()) {
+        result = {true, tag, authCode, flags, pathHashes};
+    }
+    return result;
+}
+
+PacketView::PacketView(QByteArrayView data)
+    : m_data(data)
+{
+    BufferReader reader(data);
+
+    m_header = reader.readByte();
+    if (hasTransportCodes()) {
+        m_transportCodes[0] = reader.readUInt16LE();
+        m_transportCodes[1] = reader.readUInt16LE();
+    }
+    quint8 pathLength = reader.readByte();
+    m_path = reader.readBytesView(pathLength);
+    m_payload = reader.readRemainingBytesView();
+
+    m_valid = !reader.hasError();
+    if (!m_valid) {
+        m_path = {};
+        m_payload = {};
+    }
+}
+
+RouteType PacketView::routeType() const
+{
+    return static_cast<RouteType>(m_header & PacketHeader::RouteMask);
+}
+
+PayloadType PacketView::payloadType() const
+{
+    return static_cast<PayloadType>((m_header >> PacketHeader::TypeShift) & PacketHeader::TypeMask);
+}
+
+quint8 PacketView::payloadVersion() const
+{
+    return (m_header >> PacketHeader::VerShift) & PacketHeader::VerMask;
+}
+
+bool PacketView::hasTransportCodes() const
+{
+    return routeType() == RouteType::TransportFlood || routeType() == RouteType::TransportDirect;
+}
+
+quint64 PacketView::payloadHash() const
+{
+    if (!m_valid) {
+        return 0;
+    }
+    return qHashBits(m_payload.data(), size_t(m_payload.size()), size_t(payloadType()));
+}
+
+AdvertPayload PacketView::advert() const
+{
+    if (!m_valid || payloadType() != PayloadType::Advert) {
+        return {};
+    }
+    return AdvertPayload::decode(m_payload);
+}
+
+AddressedPayload PacketView::addressed() const
+{
+    if (!m_valid) {
+        return {};
+    }
+    switch (payloadType()) {
+    case PayloadType::Req:
+    case PayloadType::Response:
+    case PayloadType::TxtMsg:
+    case PayloadType::Path:
+        return AddressedPayload::decode(m_payload);
+    default:
+        return {};
+    }
+}
+
+AnonRequestPayload PacketView::anonRequest() const
+{
+    if (!m_valid || payloadType() != PayloadType::AnonReq) {
+        return {};
+    }
+    return AnonRequestPayload::decode(m_payload);
+}
+
+GroupPayload PacketView::group() const
+{
+    if (!m_valid || (payloadType() != PayloadType::GrpTxt && payloadType() != PayloadType::GrpData)) {
+        return {};
+    }
+    return GroupPayload::decode(m_payload);
+}
+
+AckPayload PacketView::ack() const
+{
+    if (!m_valid || payloadType() != PayloadType::Ack) {
+        return {};
+    }
+    return AckPayload::decode(m_payload);
+}
+
+TracePayload PacketView::trace() const
+{
+    if (!m_valid || payloadType() != PayloadType::Trace) {
+        return {};
+    }
+    return TracePayload::decode(m_payload);
+}
+
+} // namespace MeshCore
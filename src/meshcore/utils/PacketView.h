@@ -0,0 +1,169 @@
+#ifndef PACKETVIEW_H
+#define PACKETVIEW_H
+
+#include <QByteArrayView>
+#include <array>
+#include "../MeshCoreConstants.h"
+
+namespace MeshCore {
+
+/**
+ * @brief Flags, location and name at the end of an advert
+ */
+struct AdvertAppData
+{
+    bool valid = false;
+    quint8 flags = 0;
+    qint32 latitude = 0;   // Degrees * 1e6, as in Contact
+    qint32 longitude = 0;
+    QByteArrayView name;   // UTF-8, without terminator
+
+    [[nodiscard]] AdvertType type() const { return static_cast<AdvertType>(flags & AdvertFlags::TypeMask); }
+    [[nodiscard]] bool hasLatLon() const { return flags & AdvertFlags::LatLonMask; }
+    [[nodiscard]] bool hasName() const { return flags & AdvertFlags::NameMask; }
+
+    static AdvertAppData decode(QByteArrayView appData);
+};
+
+/**
+ * @brief Advert payload: public key, timestamp, signature and app data
+ */
+struct AdvertPayload
+{
+    bool valid = false;
+    QByteArrayView publicKey;   // 32 bytes
+    quint32 timestamp = 0;
+    QByteArrayView signature;   // 64 bytes
+    QByteArrayView rawAppData;
+    AdvertAppData appData;
+
+    static AdvertPayload decode(QByteArrayView payload);
+};
+
+/**
+ * @brief Payload sent to one node: request, response, text message or path
+ */
+struct AddressedPayload
+{
+    bool valid = false;
+    quint8 destHash = 0;
+    quint8 srcHash = 0;
+    QByteArrayView encrypted;   // MAC and ciphertext
+
+    static AddressedPayload decode(QByteArrayView payload);
+};
+
+/**
+ * @brief Anonymous request, sent with an ephemeral key instead of a source hash
+ */
+struct AnonRequestPayload
+{
+    bool valid = false;
+    quint8 destHash = 0;
+    QByteArrayView senderPublicKey;   // 32 bytes
+    QByteArrayView encrypted;
+
+    static AnonRequestPayload decode(QByteArrayView payload);
+};
+
+/**
+ * @brief Group text or data payload, addressed by channel hash
+ */
+struct GroupPayload
+{
+    bool valid = false;
+    quint8 channelHash = 0;
+    QByteArrayView encrypted;
+
+    static GroupPayload decode(QByteArrayView payload);
+};
+
+/**
+ * @brief Acknowledgement of a message, identified by its checksum
+ */
+struct AckPayload
+{
+    bool valid = false;
+    quint32 checksum = 0;
+
+    static AckPayload decode(QByteArrayView payload);
+};
+
+/**
+ * @brief Trace payload; the SNR of each hop is collected in the packet path
+ */
+struct TracePayload
+{
+    bool valid = false;
+    quint32 tag = 0;
+    quint32 authCode = 0;
+    quint8 flags = 0;
+    QByteArrayView pathHashes;   // Nodes the trace is routed through
+
+    static TracePayload decode(QByteArrayView payload);
+};
+
+/**
+ * @brief Non-owning decoder of an on-air MeshCore packet
+ *
+ * Packet layout:
+ *   header (u8)            route type (bits 0-1), payload type (bits 2-5),
+ *                          payload version (bits 6-7)
+ *   transport codes        2 x u16, only for the transport route types
+ *   path length (u8), path
+ *   payload                the rest of the packet
+ *
+ * The view only records offsets into the buffer it was given, so that
+ * buffer must outlive it; decoding a packet allocates nothing. The typed
+ * payload accessors decode on each call and return an invalid payload when
+ * the payload type does not match or the payload is truncated.
+ *
+ * This is the single decoder of the packet format: Packet, Advert and
+ * RxLogEntry are built on it.
+ */
+class PacketView
+{
+public:
+    PacketView() = default;
+    explicit PacketView(QByteArrayView data);
+
+    // Whether header, transport codes and path were all present
+    [[nodiscard]] bool isValid() const { return m_valid; }
+    // The header alone is available as long as the packet is not empty
+    [[nodiscard]] bool hasHeader() const { return !m_data.isEmpty(); }
+    [[nodiscard]] QByteArrayView data() const { return m_data; }
+
+    [[nodiscard]] quint8 header() const { return m_header; }
+    [[nodiscard]] RouteType routeType() const;
+    [[nodiscard]] PayloadType payloadType() const;
+    [[nodiscard]] quint8 payloadVersion() const;
+
+    [[nodiscard]] bool hasTransportCodes() const;
+    [[nodiscard]] std::array<quint16, 2> transportCodes() const { return m_transportCodes; }
+    [[nodiscard]] QByteArrayView path() const { return m_path; }
+    [[nodiscard]] QByteArrayView payload() const { return m_payload; }
+
+    // Identifies a packet across the paths it arrives by: covers the payload
+    // type and payload, but not the route bits or the path; 0 if invalid
+    [[nodiscard]] quint64 payloadHash() const;
+
+    // Typed payloads
+    [[nodiscard]] AdvertPayload advert() const;
+    [[nodiscard]] AddressedPayload addressed() const;   // Req, Response, TxtMsg and Path
+    [[nodiscard]] AnonRequestPayload anonRequest() const;
+    [[nodiscard]] GroupPayload group() const;           // GrpTxt and GrpData
+    [[nodiscard]] AckPayload ack() const;
+    [[nodiscard]] TracePayload trace() const;
+
+private:
+    QByteArrayView m_data;
+    quint8 m_header = 0;
+    std::array<quint16, 2> m_transportCodes{};
+    QByteArrayView m_path;
+    QByteArrayView m_payload;
+    bool m_valid = false;
+};
+
+} // namespace MeshCore
+
+#endif // PACKETVIEW_H